@@ -0,0 +1,64 @@
+// compares the flat and cache-blocked schedules of the multiply step, for a large number of input slices
+// usage: node schedule.js [num_inputs [slice_size [num_outputs [method]]]]
+//
+// alongside throughput, this reports the estimated number of bytes that need to be read from beyond L2 per recovery byte produced:
+// - flat: every (output, chunk) task streams all input chunks, which don't fit in L2 with this many inputs, so each output re-reads all inputs
+// - blocked: an input group is read once per output group, whilst the group's output chunks stay resident, so inputs are re-read once per output group
+// (this is a model of the schedule, not a measurement; use hardware counters, e.g. `perf stat -e LLC-load-misses`, to verify)
+
+var gf = require('../build/Release/parpar_gf.node');
+
+var numInputs = +process.argv[2] || 1000;
+var sliceSize = +process.argv[3] || 256*1024;
+var numOutputs = +process.argv[4] || 64;
+var method = +process.argv[5] || 0;
+var rounds = 2;
+
+var SCHEDULE_FLAT = 1, SCHEDULE_BLOCKED = 2;
+
+var info = gf.set_method(method, sliceSize, numOutputs);
+var len = Math.ceil(sliceSize / info.stride) * info.stride;
+var alignedBuffer = function(size) {
+	var buf = Buffer.alloc ? Buffer.alloc(size + info.alignment) : new Buffer(size + info.alignment);
+	var offs = gf.alignment_offset(buf);
+	if(offs) offs = info.alignment - offs;
+	return buf.slice(offs, offs + size);
+};
+
+var inputs = [], iNums = [], outputs = [], oNums = [];
+var seed = 1;
+for(var i = 0; i < numInputs; i++) {
+	var buf = alignedBuffer(len);
+	for(var j = 0; j < len; j += 4) {
+		seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+		buf.writeUInt32LE(seed, j);
+	}
+	inputs.push(buf);
+	iNums.push(i);
+}
+for(var i = 0; i < numOutputs; i++) {
+	outputs.push(alignedBuffer(len));
+	oNums.push(i);
+}
+
+console.log('Method: ' + info.method_desc + ', threads: ' + gf.get_num_threads());
+console.log(numInputs + ' inputs x ' + numOutputs + ' outputs, ' + len + ' byte slices');
+
+[['Flat', SCHEDULE_FLAT], ['Blocked', SCHEDULE_BLOCKED]].forEach(function(sched) {
+	gf.set_schedule(sched[1]);
+	var plan = gf.get_schedule(numInputs, len, numOutputs);
+	var outputGroups = Math.ceil(numOutputs / plan.output_group);
+	var readsPerByte = numInputs * outputGroups / numOutputs;
+
+	gf.generate(inputs, iNums, outputs, oNums, false); // warm up
+	var start = process.hrtime();
+	for(var r = 0; r < rounds; r++)
+		gf.generate(inputs, iNums, outputs, oNums, false);
+	var time = process.hrtime(start);
+	time = time[0] + time[1] / 1e9;
+
+	console.log(sched[0] + ': chunk ' + plan.chunk_size + ', ' + plan.input_group + ' inputs x ' + plan.output_group + ' outputs per tile; '
+		+ readsPerByte.toFixed(1) + ' bytes read per recovery byte; '
+		+ (len * numInputs * numOutputs * rounds / time / 1048576).toFixed(0) + ' MB/s');
+});
+gf.set_schedule(0);
@@ -0,0 +1,69 @@
+// compares the cost of the full recovery pipeline (copy inputs in, multiply, finish outputs) across methods
+// usage: node transform.js [num_inputs [slice_size [num_outputs [method,method,...]]]]
+//
+// most Shuffle/Affine methods rearrange input data whilst copying it in (prepare), and have to undo this on each recovery slice (finish), whilst non-transforming methods (e.g. Affine2x-NT) copy inputs as-is and skip the finish pass, at the expense of a slightly slower multiply
+// since prepare is done once per input, whilst multiply is done once per input per output, the former is most significant when there are few recovery slices
+
+var gf = require('../build/Release/parpar_gf.node');
+
+var numInputs = +process.argv[2] || 200;
+var sliceSize = +process.argv[3] || 256*1024;
+var numOutputs = +process.argv[4] || 4;
+// methods are numeric IDs, in the order of GF_METHODS in lib/par2.js; default compares Affine2x (AVX2/AVX512) against their non-transforming counterparts
+var methods = (process.argv[5] || '21,22,19,23').split(',').map(Number);
+var rounds = 3;
+
+var src = [], iNums = [], oNums = [];
+var seed = 1;
+for(var i = 0; i < numInputs; i++) {
+	var buf = Buffer.alloc ? Buffer.alloc(sliceSize) : new Buffer(sliceSize);
+	for(var j = 0; j < sliceSize; j += 4) {
+		seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+		buf.writeUInt32LE(seed, j);
+	}
+	src.push(buf);
+	iNums.push(i);
+}
+for(var i = 0; i < numOutputs; i++)
+	oNums.push(i);
+
+var now = function() {
+	var t = process.hrtime();
+	return t[0] + t[1] / 1e9;
+};
+
+console.log(numInputs + ' inputs x ' + numOutputs + ' outputs, ' + sliceSize + ' byte slices, threads: ' + gf.get_num_threads());
+methods.forEach(function(method) {
+	var info = gf.set_method(method, sliceSize, numOutputs);
+	if(info.method != method) return;
+	var len = Math.ceil(sliceSize / info.stride) * info.stride;
+	var alignedBuffer = function(size) {
+		var buf = Buffer.alloc ? Buffer.alloc(size + info.alignment) : new Buffer(size + info.alignment);
+		var offs = gf.alignment_offset(buf);
+		if(offs) offs = info.alignment - offs;
+		return buf.slice(offs, offs + size);
+	};
+	var inputs = src.map(function() { return alignedBuffer(len); });
+	var outputs = oNums.map(function() { return alignedBuffer(len); });
+
+	var tCopy = 0, tMul = 0, tFinish = 0;
+	for(var r = -1; r < rounds; r++) { // first round is a warm up
+		var t0 = now();
+		for(var i = 0; i < numInputs; i++)
+			gf.copy(src[i], inputs[i]);
+		var t1 = now();
+		gf.generate(inputs, iNums, outputs, oNums, false);
+		var t2 = now();
+		gf.finish(outputs, sliceSize);
+		var t3 = now();
+		if(r < 0) continue;
+		tCopy += t1 - t0;
+		tMul += t2 - t1;
+		tFinish += t3 - t2;
+	}
+	var total = tCopy + tMul + tFinish;
+	var ms = function(t) { return (t * 1000 / rounds).toFixed(1) + 'ms'; };
+	console.log(info.method_desc + ': copy ' + ms(tCopy) + ', multiply ' + ms(tMul) + ', finish ' + ms(tFinish)
+		+ '; ' + (sliceSize * numInputs * numOutputs * rounds / total / 1048576).toFixed(0) + ' MB/s overall');
+});
+gf.set_method(0);
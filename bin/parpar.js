@@ -155,6 +155,9 @@ var opts = {
 		type: 'string',
 		default: ''
 	},
+	'autotune-cache': {
+		type: 'string'
+	},
 	'recurse': {
 		alias: 'R',
 		type: 'bool',
@@ -391,11 +394,8 @@ var inputFiles = argv._;
 	var startTime = Date.now();
 	var decimalPoint = (1.1).toLocaleString().substr(1, 1);
 
-	if(argv.threads) {
-		if(!ParPar.setMaxThreads)
-			error('This build of ParPar has not been compiled with OpenMP support, which is required for multi-threading support');
+	if(argv.threads)
 		ParPar.setMaxThreads(argv.threads);
-	}
 	//if(argv.method == 'auto') argv.method = '';
 
 	if(argv['ascii-charset']) {
@@ -410,18 +410,23 @@ var inputFiles = argv._;
 			process.exit(1);
 		}
 		
-		ParPar.setMethod(argv.method || '', inputSliceDef.unit == 'count' ? 0 : inputSliceDef.value); // TODO: allow size hint to work if slice-count is specified + consider min/max limits
 		var g;
 		try {
 			g = new ParPar.PAR2Gen(info, inputSliceCount, ppo);
 		} catch(x) {
 			error(x.message);
 		}
+		var autotuneCache = argv['autotune-cache'];
+		if(autotuneCache === undefined) {
+			var os = require('os');
+			autotuneCache = require('path').join(os.homedir ? os.homedir() : os.tmpdir(), '.parpar_autotune');
+		}
+		g.setMethod(argv.method || '', autotuneCache);
 		
 		var currentSlice = 0;
 		var progressInterval;
 		if(!argv.quiet) {
-			var method_used = ParPar.getMethod();
+			var method_used = g.getMethod();
 			var num_threads = ParPar.getNumThreads();
 			var thread_str = num_threads + ' thread' + (num_threads==1 ? '':'s');
 			process.stderr.write('Multiply method used: ' + method_used.description + ', ' + thread_str + '\n');
@@ -34,46 +34,84 @@
   "targets": [
     {
       "target_name": "parpar_gf",
-      "dependencies": ["gf16", "gf16_sse2", "gf16_ssse3", "gf16_avx", "gf16_avx2", "gf16_avx512", "gf16_vbmi", "gf16_gfni", "gf16_gfni_avx512", "gf16_neon", "multi_md5"],
-      "sources": ["src/gf.cc", "gf16/module.cc", "src/gyp_warnings.cc"],
-      "include_dirs": ["gf16"],
+      "dependencies": ["gf16", "gf16_sse2", "gf16_ssse3", "gf16_avx", "gf16_avx2", "gf16_avx512", "gf16_vbmi", "gf16_gfni", "gf16_gfni_avx2", "gf16_gfni_avx512", "gf16_clmul", "gf16_clmul_avx512", "gf16_neon", "multi_md5", "multi_md5_avx2", "multi_md5_avx512", "crc32", "crc32_clmul"],
+      "sources": ["src/gf.cc", "gf16/module.cc", "src/thread_pool.cc", "src/gyp_warnings.cc"],
+      "include_dirs": ["gf16"]
+    },
+    {
+      "target_name": "multi_md5",
+      "type": "static_library",
+      "sources": ["md5/md5.c", "md5/md5-simd.c"],
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "xcode_settings": {
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+        "OTHER_CXXFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}}
+    },
+    {
+      "target_name": "multi_md5_avx2",
+      "type": "static_library",
+      "sources": ["md5/md5-avx2.c"],
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "xcode_settings": {
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+        "OTHER_CXXFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
       "conditions": [
-        ['OS=="win"', {
-          "msvs_settings": {"VCCLCompilerTool": {"OpenMP": "true"}}
-        }, {
-          "variables": {
-            "supports_omp%": "<!(<!(echo ${CXX_target:-${CXX:-c++}}) -MM -E src/gyp_warnings.cc -fopenmp 2>/dev/null || true)",
-            "supports_omp_clang%": "<!(<!(echo ${CXX_target:-${CXX:-c++}}) -MM -E src/gyp_warnings.cc -fopenmp=libomp 2>/dev/null || true)"
-          },
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_avx2%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E md5/md5-avx2.c -mavx2 2>/dev/null || true)"},
           "conditions": [
-            ['supports_omp!="" and supports_omp_clang==""', {
-              "cflags": ["-fopenmp"],
-              "cxxflags": ["-fopenmp"],
-              "ldflags": ["-fopenmp"],
+            ['supports_avx2!=""', {
+              "cflags": ["-mavx2"],
               "xcode_settings": {
-                "OTHER_CFLAGS": ["-fopenmp"],
-                "OTHER_CXXFLAGS": ["-fopenmp"],
-                "OTHER_LDFLAGS": ["-fopenmp"]
+                "OTHER_CFLAGS": ["-mavx2"]
               }
-            }],
-            ['supports_omp_clang!=""', {
-              "cflags": ["-fopenmp=libomp"],
-              "cxxflags": ["-fopenmp=libomp"],
-              "ldflags": ["-fopenmp=libomp"],
+            }]
+          ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {"VCCLCompilerTool": {"EnableEnhancedInstructionSet": "3"}}
+        }]
+      ]
+    },
+    {
+      "target_name": "multi_md5_avx512",
+      "type": "static_library",
+      "sources": ["md5/md5-avx512.c"],
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "xcode_settings": {
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+        "OTHER_CXXFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_avx512%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E md5/md5-avx512.c -mavx512f 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_avx512!=""', {
+              "cflags": ["-mavx512f"],
               "xcode_settings": {
-                "OTHER_CFLAGS": ["-fopenmp=libomp"],
-                "OTHER_CXXFLAGS": ["-fopenmp=libomp"],
-                "OTHER_LDFLAGS": ["-fopenmp=libomp"]
+                "OTHER_CFLAGS": ["-mavx512f"]
               }
             }]
           ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {
+            "VCCLCompilerTool": {"AdditionalOptions": ["/arch:AVX512"], "EnableEnhancedInstructionSet": "0"}
+          }
         }]
       ]
     },
     {
-      "target_name": "multi_md5",
+      "target_name": "crc32",
       "type": "static_library",
-      "sources": ["md5/md5.c", "md5/md5-simd.c"],
+      "sources": ["crc/crc32.c"],
       "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
       "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
       "xcode_settings": {
@@ -82,6 +120,31 @@
       },
       "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}}
     },
+    {
+      "target_name": "crc32_clmul",
+      "type": "static_library",
+      "sources": ["crc/crc32-clmul.c"],
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "cxxflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "xcode_settings": {
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+        "OTHER_CXXFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_clmul%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E crc/crc32-clmul.c -mpclmul -msse2 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_clmul!=""', {
+              "cflags": ["-mpclmul", "-msse2"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mpclmul", "-msse2"]
+              }
+            }]
+          ]
+        }]
+      ]
+    },
     {
       "target_name": "gf16",
       "type": "static_library",
@@ -107,7 +170,8 @@
       "defines": ["NDEBUG"],
       "sources": [
         "gf16/gf16_xor_sse2.c",
-        "gf16/gf16_lookup_sse2.c"
+        "gf16/gf16_lookup_sse2.c",
+        "gf16/gf16_add_sse2.c"
       ],
       "cflags": ["-Wno-unused-function"],
       "xcode_settings": {
@@ -187,7 +251,9 @@
       "defines": ["NDEBUG"],
       "sources": [
         "gf16/gf16_xor_avx2.c",
-        "gf16/gf16_shuffle_avx2.c"
+        "gf16/gf16_shuffle_avx2.c",
+        "gf16/gf16_add_avx2.c",
+        "gf16/gf16_lookup_avx2.c"
       ],
       "cflags": ["-Wno-unused-function"],
       "xcode_settings": {
@@ -224,7 +290,9 @@
       "defines": ["NDEBUG"],
       "sources": [
         "gf16/gf16_xor_avx512.c",
-        "gf16/gf16_shuffle_avx512.c"
+        "gf16/gf16_shuffle_avx512.c",
+        "gf16/gf16_add_avx512.c",
+        "gf16/gf16_lookup_avx512.c"
       ],
       "cflags": ["-Wno-unused-function"],
       "xcode_settings": {
@@ -322,6 +390,39 @@
         }]
       ]
     },
+    {
+      "target_name": "gf16_gfni_avx2",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_affine_avx2.c"
+      ],
+      "cflags": ["-Wno-unused-function"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_gfni_avx2%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_affine_avx2.c -mgfni -mavx2 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_gfni_avx2!=""', {
+              "cflags": ["-mgfni", "-mavx2"],
+              "cxxflags": ["-mgfni", "-mavx2"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mgfni", "-mavx2"],
+                "OTHER_CXXFLAGS": ["-mgfni", "-mavx2"],
+              }
+            }]
+          ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {"VCCLCompilerTool": {"EnableEnhancedInstructionSet": "3"}}
+        }]
+      ]
+    },
     {
       "target_name": "gf16_gfni_avx512",
       "type": "static_library",
@@ -357,6 +458,71 @@
         }]
       ]
     },
+    {
+      "target_name": "gf16_clmul",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_clmul_sse.c"
+      ],
+      "cflags": ["-Wno-unused-function"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_clmul%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_clmul_sse.c -mpclmul -msse2 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_clmul!=""', {
+              "cflags": ["-mpclmul", "-msse2"],
+              "cxxflags": ["-mpclmul", "-msse2"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mpclmul", "-msse2"],
+                "OTHER_CXXFLAGS": ["-mpclmul", "-msse2"],
+              }
+            }]
+          ]
+        }]
+      ]
+    },
+    {
+      "target_name": "gf16_clmul_avx512",
+      "type": "static_library",
+      "defines": ["NDEBUG"],
+      "sources": [
+        "gf16/gf16_clmul_avx512.c"
+      ],
+      "cflags": ["-Wno-unused-function"],
+      "xcode_settings": {
+        "OTHER_CFLAGS": ["-Wno-unused-function"],
+        "OTHER_CFLAGS!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"]
+      },
+      "cflags!": ["-fno-omit-frame-pointer", "-fno-tree-vrp", "-fno-strict-aliasing"],
+      "msvs_settings": {"VCCLCompilerTool": {"BufferSecurityCheck": "false"}},
+      "conditions": [
+        ['target_arch in "ia32 x64" and OS!="win"', {
+          "variables": {"supports_clmul_avx512%": "<!(<!(echo ${CC_target:-${CC:-cc}}) -MM -E gf16/gf16_clmul_avx512.c -mvpclmulqdq -mavx512vl -mavx512bw 2>/dev/null || true)"},
+          "conditions": [
+            ['supports_clmul_avx512!=""', {
+              "cflags": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              "cxxflags": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              "xcode_settings": {
+                "OTHER_CFLAGS": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+                "OTHER_CXXFLAGS": ["-mvpclmulqdq", "-mavx512vl", "-mavx512bw"],
+              }
+            }]
+          ]
+        }],
+        ['target_arch in "ia32 x64" and OS=="win"', {
+          "msvs_settings": {
+            "VCCLCompilerTool": {"AdditionalOptions": ["/arch:AVX512"], "EnableEnhancedInstructionSet": "0"}
+          }
+        }]
+      ]
+    },
     {
       "target_name": "gf16_neon",
       "type": "static_library",
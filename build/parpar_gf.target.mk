@@ -0,0 +1,167 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := parpar_gf
+DEFS_Debug := \
+	'-DNODE_GYP_MODULE_NAME=parpar_gf' \
+	'-DUSING_UV_SHARED=1' \
+	'-DUSING_V8_SHARED=1' \
+	'-DV8_DEPRECATION_WARNINGS=1' \
+	'-D_GLIBCXX_USE_CXX11_ABI=1' \
+	'-D_FILE_OFFSET_BITS=64' \
+	'-D_LARGEFILE_SOURCE' \
+	'-D__STDC_FORMAT_MACROS' \
+	'-DOPENSSL_NO_PINSHARED' \
+	'-DOPENSSL_THREADS' \
+	'-DBUILDING_NODE_EXTENSION' \
+	'-DDEBUG' \
+	'-D_DEBUG'
+
+# Flags passed to all source files.
+CFLAGS_Debug := \
+	-std=gnu99 \
+	-march=native \
+	-fPIC \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-g \
+	-O0
+
+# Flags passed to only C files.
+CFLAGS_C_Debug :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Debug := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++17
+
+INCS_Debug := \
+	-I/usr/include/node \
+	-I/usr/src \
+	-I/usr/deps/openssl/config \
+	-I/usr/deps/openssl/openssl/include \
+	-I/usr/deps/uv/include \
+	-I/usr/deps/zlib \
+	-I/usr/deps/v8/include \
+	-I$(srcdir)/gf16
+
+DEFS_Release := \
+	'-DNODE_GYP_MODULE_NAME=parpar_gf' \
+	'-DUSING_UV_SHARED=1' \
+	'-DUSING_V8_SHARED=1' \
+	'-DV8_DEPRECATION_WARNINGS=1' \
+	'-D_GLIBCXX_USE_CXX11_ABI=1' \
+	'-D_FILE_OFFSET_BITS=64' \
+	'-D_LARGEFILE_SOURCE' \
+	'-D__STDC_FORMAT_MACROS' \
+	'-DOPENSSL_NO_PINSHARED' \
+	'-DOPENSSL_THREADS' \
+	'-DBUILDING_NODE_EXTENSION'
+
+# Flags passed to all source files.
+CFLAGS_Release := \
+	-std=gnu99 \
+	-march=native \
+	-fPIC \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-fomit-frame-pointer \
+	-O3 \
+	-fno-omit-frame-pointer
+
+# Flags passed to only C files.
+CFLAGS_C_Release :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Release := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++17
+
+INCS_Release := \
+	-I/usr/include/node \
+	-I/usr/src \
+	-I/usr/deps/openssl/config \
+	-I/usr/deps/openssl/openssl/include \
+	-I/usr/deps/uv/include \
+	-I/usr/deps/zlib \
+	-I/usr/deps/v8/include \
+	-I$(srcdir)/gf16
+
+OBJS := \
+	$(obj).target/$(TARGET)/src/gf.o \
+	$(obj).target/$(TARGET)/gf16/module.o \
+	$(obj).target/$(TARGET)/src/thread_pool.o \
+	$(obj).target/$(TARGET)/src/gyp_warnings.o
+
+# Add to the list of files we specially track dependencies for.
+all_deps += $(OBJS)
+
+# Make sure our dependencies are built before any of us.
+$(OBJS): | $(builddir)/gf16.a $(builddir)/gf16_sse2.a $(builddir)/gf16_ssse3.a $(builddir)/gf16_avx.a $(builddir)/gf16_avx2.a $(builddir)/gf16_avx512.a $(builddir)/gf16_vbmi.a $(builddir)/gf16_gfni.a $(builddir)/gf16_gfni_avx2.a $(builddir)/gf16_gfni_avx512.a $(builddir)/gf16_clmul.a $(builddir)/gf16_clmul_avx512.a $(builddir)/gf16_neon.a $(builddir)/multi_md5.a $(builddir)/multi_md5_avx2.a $(builddir)/multi_md5_avx512.a $(builddir)/crc32.a $(builddir)/crc32_clmul.a $(obj).target/gf16.a $(obj).target/gf16_sse2.a $(obj).target/gf16_ssse3.a $(obj).target/gf16_avx.a $(obj).target/gf16_avx2.a $(obj).target/gf16_avx512.a $(obj).target/gf16_vbmi.a $(obj).target/gf16_gfni.a $(obj).target/gf16_gfni_avx2.a $(obj).target/gf16_gfni_avx512.a $(obj).target/gf16_clmul.a $(obj).target/gf16_clmul_avx512.a $(obj).target/gf16_neon.a $(obj).target/multi_md5.a $(obj).target/multi_md5_avx2.a $(obj).target/multi_md5_avx512.a $(obj).target/crc32.a $(obj).target/crc32_clmul.a
+
+# CFLAGS et al overrides must be target-local.
+# See "Target-specific Variable Values" in the GNU Make manual.
+$(OBJS): TOOLSET := $(TOOLSET)
+$(OBJS): GYP_CFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_C_$(BUILDTYPE))
+$(OBJS): GYP_CXXFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_CC_$(BUILDTYPE))
+
+# Suffix rules, putting all outputs into $(obj).
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(srcdir)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# Try building from generated source, too.
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj).$(TOOLSET)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# End of this set of suffix rules
+### Rules for final target.
+LDFLAGS_Debug := \
+	-pthread \
+	-rdynamic \
+	-m64
+
+LDFLAGS_Release := \
+	-pthread \
+	-rdynamic \
+	-m64
+
+LIBS :=
+
+$(obj).target/parpar_gf.node: GYP_LDFLAGS := $(LDFLAGS_$(BUILDTYPE))
+$(obj).target/parpar_gf.node: LIBS := $(LIBS)
+$(obj).target/parpar_gf.node: TOOLSET := $(TOOLSET)
+$(obj).target/parpar_gf.node: $(OBJS) $(obj).target/gf16.a $(obj).target/gf16_sse2.a $(obj).target/gf16_ssse3.a $(obj).target/gf16_avx.a $(obj).target/gf16_avx2.a $(obj).target/gf16_avx512.a $(obj).target/gf16_vbmi.a $(obj).target/gf16_gfni.a $(obj).target/gf16_gfni_avx2.a $(obj).target/gf16_gfni_avx512.a $(obj).target/gf16_clmul.a $(obj).target/gf16_clmul_avx512.a $(obj).target/gf16_neon.a $(obj).target/multi_md5.a $(obj).target/multi_md5_avx2.a $(obj).target/multi_md5_avx512.a $(obj).target/crc32.a $(obj).target/crc32_clmul.a FORCE_DO_CMD
+	$(call do_cmd,solink_module)
+
+all_deps += $(obj).target/parpar_gf.node
+# Add target alias
+.PHONY: parpar_gf
+parpar_gf: $(builddir)/parpar_gf.node
+
+# Copy this to the executable output path.
+$(builddir)/parpar_gf.node: TOOLSET := $(TOOLSET)
+$(builddir)/parpar_gf.node: $(obj).target/parpar_gf.node FORCE_DO_CMD
+	$(call do_cmd,copy)
+
+all_deps += $(builddir)/parpar_gf.node
+# Short alias for building this executable.
+.PHONY: parpar_gf.node
+parpar_gf.node: $(obj).target/parpar_gf.node $(builddir)/parpar_gf.node
+
+# Add executable to "all" target.
+.PHONY: all
+all: $(builddir)/parpar_gf.node
+
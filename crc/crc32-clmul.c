@@ -0,0 +1,67 @@
+#include "crc32.h"
+#include "../gf16/platform.h"
+
+#if defined(__PCLMUL__) && defined(__SSE2__)
+#include <wmmintrin.h>
+int crc32_available_clmul = 1;
+
+/*
+ * Folds 4 vectors at a time with carry-less multiplies, then reduces with Barrett reduction
+ * Constants are for the bit-reflected polynomial 0xedb88320; see Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ"
+ */
+uint32_t crc32_clmul(const void *data, size_t len, uint32_t crc) {
+	const __m128i* _data = (const __m128i*)data;
+	if(len < 64)
+		return crc32_generic(data, len, crc);
+	
+	const __m128i k1k2 = _mm_set_epi32(0x00000001, 0xc6e41596, 0x00000001, 0x54442bd4);
+	const __m128i k3k4 = _mm_set_epi32(0x00000000, 0xccaa009e, 0x00000001, 0x751997d0);
+	const __m128i k5 = _mm_set_epi32(0, 0, 0x00000001, 0x63cd6124);
+	const __m128i poly = _mm_set_epi32(0x00000001, 0xf7011641, 0x00000001, 0xdb710641); /* mu, P' */
+	const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+	
+	__m128i x0 = _mm_xor_si128(_mm_loadu_si128(_data), _mm_cvtsi32_si128(crc));
+	__m128i x1 = _mm_loadu_si128(_data+1);
+	__m128i x2 = _mm_loadu_si128(_data+2);
+	__m128i x3 = _mm_loadu_si128(_data+3);
+	_data += 4;
+	len -= 64;
+	
+	#define FOLD(x, k, next) _mm_xor_si128( \
+		_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), \
+		next \
+	)
+	for(; len >= 64; len -= 64) {
+		x0 = FOLD(x0, k1k2, _mm_loadu_si128(_data));
+		x1 = FOLD(x1, k1k2, _mm_loadu_si128(_data+1));
+		x2 = FOLD(x2, k1k2, _mm_loadu_si128(_data+2));
+		x3 = FOLD(x3, k1k2, _mm_loadu_si128(_data+3));
+		_data += 4;
+	}
+	
+	// fold down to one vector, then any remaining whole vectors
+	x0 = FOLD(x0, k3k4, x1);
+	x0 = FOLD(x0, k3k4, x2);
+	x0 = FOLD(x0, k3k4, x3);
+	for(; len >= 16; len -= 16)
+		x0 = FOLD(x0, k3k4, _mm_loadu_si128(_data++));
+	#undef FOLD
+	
+	// 128 -> 64 bits
+	x0 = _mm_xor_si128(_mm_clmulepi64_si128(x0, k3k4, 0x10), _mm_srli_si128(x0, 8));
+	// 64 -> 32 bits
+	x0 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x0, mask32), k5, 0x00), _mm_srli_si128(x0, 4));
+	// Barrett reduction
+	__m128i t = _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), poly, 0x10);
+	t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+	crc = _mm_cvtsi128_si32(_mm_srli_si128(_mm_xor_si128(t, x0), 4));
+	
+	return crc32_generic(_data, len, crc);
+}
+
+#else
+int crc32_available_clmul = 0;
+uint32_t crc32_clmul(const void *data, size_t len, uint32_t crc) {
+	return crc32_generic(data, len, crc);
+}
+#endif
@@ -0,0 +1,93 @@
+#include "crc32.h"
+#include "../gf16/platform.h"
+
+#define CRC32_POLY 0xedb88320
+
+/* slice-by-4 tables, for the generic kernel and unaligned ends */
+static uint32_t crc32_table[4][256];
+/* x^(2^k) mod P, for crc32_zeroes */
+static uint32_t crc32_x2n_table[32];
+
+static crc32_func crc32_kernel = &crc32_generic;
+
+/* multiply a and b modulo P (bit-reflected) */
+static uint32_t crc32_multmodp(uint32_t a, uint32_t b) {
+	uint32_t m = (uint32_t)1 << 31, p = 0;
+	for(;;) {
+		if(a & m) {
+			p ^= b;
+			if((a & (m - 1)) == 0) break;
+		}
+		m >>= 1;
+		b = b & 1 ? (b >> 1) ^ CRC32_POLY : b >> 1;
+	}
+	return p;
+}
+
+uint32_t crc32_generic(const void *data, size_t len, uint32_t crc) {
+	const uint8_t* _data = (const uint8_t*)data;
+	for(; len && ((uintptr_t)_data & 3); len--)
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *_data++) & 0xff];
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+	for(; len >= 4; len -= 4) {
+		crc ^= *(const uint32_t*)_data;
+		crc = crc32_table[3][crc & 0xff] ^ crc32_table[2][(crc >> 8) & 0xff] ^ crc32_table[1][(crc >> 16) & 0xff] ^ crc32_table[0][crc >> 24];
+		_data += 4;
+	}
+#endif
+	for(; len; len--)
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *_data++) & 0xff];
+	return crc;
+}
+
+/* CPU detection; see gf16mul.cpp */
+#ifdef PLATFORM_X86
+# ifdef _MSC_VER
+	#include <intrin.h>
+	#define _cpuid __cpuid
+# else
+	#include <cpuid.h>
+	#define _cpuid(ar, eax) __cpuid(eax, ar[0], ar[1], ar[2], ar[3])
+# endif
+#endif
+
+void crc32_init(void) {
+	int i, j;
+	for(i = 0; i < 256; i++) {
+		uint32_t crc = i;
+		for(j = 0; j < 8; j++)
+			crc = crc & 1 ? (crc >> 1) ^ CRC32_POLY : crc >> 1;
+		crc32_table[0][i] = crc;
+	}
+	for(i = 0; i < 256; i++)
+		for(j = 1; j < 4; j++)
+			crc32_table[j][i] = (crc32_table[j-1][i] >> 8) ^ crc32_table[0][crc32_table[j-1][i] & 0xff];
+	
+	crc32_x2n_table[0] = (uint32_t)1 << 30; /* x^1 */
+	for(i = 1; i < 32; i++)
+		crc32_x2n_table[i] = crc32_multmodp(crc32_x2n_table[i-1], crc32_x2n_table[i-1]);
+	
+	crc32_func kernel = &crc32_generic;
+#ifdef PLATFORM_X86
+	int cpuInfo[4];
+	_cpuid(cpuInfo, 1);
+	if(crc32_available_clmul && (cpuInfo[2] & 0x2) && (cpuInfo[3] & 0x4000000)) // PCLMUL + SSE2
+		kernel = &crc32_clmul;
+#endif
+	crc32_kernel = kernel;
+}
+
+uint32_t crc32_calc(const void *data, size_t len, uint32_t crc) {
+	return ~crc32_kernel(data, len, ~crc);
+}
+
+uint32_t crc32_zeroes(uint32_t crc, size_t len) {
+	/* appending zeroes multiplies the raw state by x^(8*len) */
+	uint32_t p = (uint32_t)1 << 31; /* x^0 */
+	unsigned k = 3;
+	for(; len; len >>= 1, k++) {
+		if(len & 1)
+			p = crc32_multmodp(crc32_x2n_table[k & 31], p);
+	}
+	return ~crc32_multmodp(p, ~crc);
+}
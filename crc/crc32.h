@@ -0,0 +1,14 @@
+#include "../src/stdint.h"
+#include <stdlib.h>
+
+/* CRC32 (as used by PAR2/zlib); crc32_init must be called once before use, which picks the fastest kernel for the CPU */
+void crc32_init(void);
+uint32_t crc32_calc(const void *data, size_t len, uint32_t crc);
+/* CRC of the data extended by len zero bytes */
+uint32_t crc32_zeroes(uint32_t crc, size_t len);
+
+/* kernels, which operate on the raw (non-inverted) CRC state */
+typedef uint32_t(*crc32_func)(const void *data, size_t len, uint32_t crc);
+uint32_t crc32_generic(const void *data, size_t len, uint32_t crc);
+uint32_t crc32_clmul(const void *data, size_t len, uint32_t crc);
+extern int crc32_available_clmul;
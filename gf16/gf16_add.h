@@ -0,0 +1,14 @@
+#include "../src/hedley.h"
+
+// XOR (add) of whole regions, used for multiplies by 1
+#define FUNCS(v) \
+	void gf16_add_##v(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len); \
+	unsigned gf16_add_multi_##v(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len); \
+	unsigned gf16_sum_multi_##v(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len); \
+	extern int gf16_add_available_##v
+
+FUNCS(sse2);
+FUNCS(avx2);
+FUNCS(avx512);
+
+#undef FUNCS
@@ -0,0 +1,20 @@
+
+#include "platform.h"
+
+#define MWORD_SIZE 64
+#define _mword __m512i
+#define _MMI(f) _mm512_ ## f ## _si512
+#define _FN(f) f ## _avx512
+#define _MM_END _mm256_zeroupper();
+
+#if defined(__AVX512F__)
+# define _AVAILABLE
+#endif
+#include "gf16_add_x86.h"
+#undef _AVAILABLE
+
+#undef MWORD_SIZE
+#undef _mword
+#undef _MMI
+#undef _FN
+#undef _MM_END
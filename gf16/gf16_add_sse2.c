@@ -0,0 +1,20 @@
+
+#include "platform.h"
+
+#define MWORD_SIZE 16
+#define _mword __m128i
+#define _MMI(f) _mm_ ## f ## _si128
+#define _FN(f) f ## _sse2
+#define _MM_END
+
+#if defined(__SSE2__)
+# define _AVAILABLE
+#endif
+#include "gf16_add_x86.h"
+#undef _AVAILABLE
+
+#undef MWORD_SIZE
+#undef _mword
+#undef _MMI
+#undef _FN
+#undef _MM_END
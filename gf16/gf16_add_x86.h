@@ -0,0 +1,114 @@
+
+#include "gf16_global.h"
+
+#ifdef _AVAILABLE
+int _FN(gf16_add_available) = 1;
+#else
+int _FN(gf16_add_available) = 0;
+#endif
+
+// number of sources XORed per pass over the destination
+#define GF16_ADD_FANIN 8
+
+/*
+ * XOR kernels, for multiplies by 1 (e.g. the first recovery block, whose coefficients are all 1)
+ * Since XOR works bytewise, these work on any data layout, so are shared by all methods; loads are unaligned as not all methods align to a full vector
+ */
+#ifdef _AVAILABLE
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_add_x)(
+	uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src, size_t len, const int doAdd
+) {
+	size_t vecLen = len & ~(sizeof(_mword)-1);
+	int i;
+	for(size_t ptr = 0; ptr < vecLen; ptr += sizeof(_mword)) {
+		_mword result = _MMI(loadu)((_mword*)(_src[0] + ptr));
+		i = 1;
+#if MWORD_SIZE == 64
+		// VPTERNLOG merges two sources per instruction
+		for(; i+1 < srcCount; i += 2)
+			result = _mm512_ternarylogic_epi32(result, _MMI(loadu)((_mword*)(_src[i] + ptr)), _MMI(loadu)((_mword*)(_src[i+1] + ptr)), 0x96);
+#endif
+		for(; i < srcCount; i++)
+			result = _MMI(xor)(result, _MMI(loadu)((_mword*)(_src[i] + ptr)));
+		if(doAdd)
+			result = _MMI(xor)(result, _MMI(loadu)((_mword*)(_dst + ptr)));
+		_MMI(storeu)((_mword*)(_dst + ptr), result);
+	}
+	
+	// remaining bytes, if len isn't a multiple of the vector size
+	for(size_t ptr = vecLen; ptr < len; ptr++) {
+		uint8_t result = _src[0][ptr];
+		for(i = 1; i < srcCount; i++)
+			result ^= _src[i][ptr];
+		if(doAdd)
+			result ^= _dst[ptr];
+		_dst[ptr] = result;
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE unsigned _FN(gf16_add_multi_x)(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const int doAdd) {
+	uint8_t* _dst = (uint8_t*)dst + offset;
+	const uint8_t* _src[GF16_ADD_FANIN];
+	
+	unsigned region = 0;
+	while(region < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_ADD_FANIN) count = GF16_ADD_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset;
+	
+		#define _CASE(n) case n: _FN(gf16_add_x)(_dst, n, _src, len, doAdd); break
+		switch(count) {
+			_CASE(8);
+			_CASE(7);
+			_CASE(6);
+			_CASE(5);
+			_CASE(4);
+			_CASE(3);
+			_CASE(2);
+			_CASE(1);
+			default: break;
+		}
+		#undef _CASE
+		region += count;
+	}
+	return region;
+}
+#endif /*defined(_AVAILABLE)*/
+
+
+void _FN(gf16_add)(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len) {
+#ifdef _AVAILABLE
+	const uint8_t* _src = (const uint8_t*)src;
+	_FN(gf16_add_x)((uint8_t*)dst, 1, &_src, len, 1);
+	_MM_END
+#else
+	UNUSED(dst); UNUSED(src); UNUSED(len);
+#endif
+}
+
+unsigned _FN(gf16_add_multi)(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len) {
+#ifdef _AVAILABLE
+	unsigned region = _FN(gf16_add_multi_x)(regions, offset, dst, src, len, 1);
+	_MM_END
+	return region;
+#else
+	UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len);
+	return 0;
+#endif
+}
+
+// as above, but the first group of sources overwrites the destination instead of adding to it
+unsigned _FN(gf16_sum_multi)(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len) {
+#ifdef _AVAILABLE
+	unsigned region = _FN(gf16_add_multi_x)((regions > GF16_ADD_FANIN ? GF16_ADD_FANIN : regions), offset, dst, src, len, 0);
+	region += _FN(gf16_add_multi_x)(regions-region, offset, dst, src+region, len, 1);
+	_MM_END
+	return region;
+#else
+	UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len);
+	return 0;
+#endif
+}
+
+#undef GF16_ADD_FANIN
@@ -0,0 +1,474 @@
+#include "gf16_global.h"
+#include "platform.h"
+#include <string.h>
+
+#if defined(__GFNI__) && defined(__AVX2__)
+int gf16_affine_available_avx2 = 1;
+#else
+int gf16_affine_available_avx2 = 0;
+#endif
+
+// number of sources processed per pass over the destination, by the multi-region kernels
+// with only 16 registers, Affine's 4 matrices per source limit it to 3 before matrices have to be read from memory
+#define GF16_AFFINE_FANIN 3
+#define GF16_AFFINE2X_FANIN 6
+// number of regions overwritten by the first pass of the mul_multi kernels; without the additional registers of x86-64, regions are only processed in pairs
+#ifdef PLATFORM_AMD64
+# define GF16_AFFINE2X_FIRST_GROUP(regions) ((regions) > GF16_AFFINE2X_FANIN ? GF16_AFFINE2X_FANIN : (regions))
+#else
+# define GF16_AFFINE2X_FIRST_GROUP(regions) 2
+#endif
+
+
+#if defined(__GFNI__) && defined(__AVX2__)
+static HEDLEY_ALWAYS_INLINE __m256i gf16_affine_load_matrix(const void *HEDLEY_RESTRICT scratch, uint16_t coefficient) {
+	__m256i depmask = _mm256_xor_si256(
+		_mm256_load_si256((__m256i*)scratch + (coefficient & 0xf)*4),
+		_mm256_load_si256((__m256i*)((char*)scratch + ((coefficient << 3) & 0x780)) + 1)
+	);
+	depmask = _mm256_xor_si256(depmask, _mm256_load_si256((__m256i*)((char*)scratch + ((coefficient >> 1) & 0x780)) + 2));
+	depmask = _mm256_xor_si256(depmask, _mm256_load_si256((__m256i*)((char*)scratch + ((coefficient >> 5) & 0x780)) + 3));
+	return depmask;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine_expand_matrix(__m256i depmask, __m256i* mat_ll, __m256i* mat_hl, __m256i* mat_lh, __m256i* mat_hh) {
+	*mat_ll = _mm256_broadcastq_epi64(_mm256_castsi256_si128(depmask));
+	*mat_hh = _mm256_permute4x64_epi64(depmask, _MM_SHUFFLE(1,1,1,1));
+	*mat_hl = _mm256_permute4x64_epi64(depmask, _MM_SHUFFLE(2,2,2,2));
+	*mat_lh = _mm256_permute4x64_epi64(depmask, _MM_SHUFFLE(3,3,3,3));
+}
+#endif
+
+void gf16_affine_mul_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i mat_ll, mat_hl, mat_lh, mat_hh;
+	gf16_affine_expand_matrix(gf16_affine_load_matrix(scratch, coefficient), &mat_ll, &mat_hl, &mat_lh, &mat_hh);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)*2) {
+		__m256i ta = _mm256_load_si256((__m256i*)(_src + ptr));
+		__m256i tb = _mm256_load_si256((__m256i*)(_src + ptr) + 1);
+
+		__m256i tpl = _mm256_xor_si256(
+			_mm256_gf2p8affine_epi64_epi8(ta, mat_lh, 0),
+			_mm256_gf2p8affine_epi64_epi8(tb, mat_ll, 0)
+		);
+		__m256i tph = _mm256_xor_si256(
+			_mm256_gf2p8affine_epi64_epi8(ta, mat_hh, 0),
+			_mm256_gf2p8affine_epi64_epi8(tb, mat_hl, 0)
+		);
+
+		_mm256_store_si256 ((__m256i*)(_dst + ptr), tph);
+		_mm256_store_si256 ((__m256i*)(_dst + ptr) + 1, tpl);
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX2__)
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_round(const __m256i* src, __m256i* tpl, __m256i* tph, __m256i mat_ll, __m256i mat_hl, __m256i mat_lh, __m256i mat_hh) {
+	__m256i ta = _mm256_load_si256(src);
+	__m256i tb = _mm256_load_si256(src + 1);
+	*tpl = _mm256_xor_si256(*tpl, _mm256_gf2p8affine_epi64_epi8(ta, mat_lh, 0));
+	*tpl = _mm256_xor_si256(*tpl, _mm256_gf2p8affine_epi64_epi8(tb, mat_ll, 0));
+	*tph = _mm256_xor_si256(*tph, _mm256_gf2p8affine_epi64_epi8(ta, mat_hh, 0));
+	*tph = _mm256_xor_si256(*tph, _mm256_gf2p8affine_epi64_epi8(tb, mat_hl, 0));
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x_avx2(
+	const void *HEDLEY_RESTRICT scratch,
+	uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
+) {
+	__m256i mat_ll[GF16_AFFINE_FANIN], mat_hl[GF16_AFFINE_FANIN], mat_lh[GF16_AFFINE_FANIN], mat_hh[GF16_AFFINE_FANIN];
+	int i;
+	for(i=0; i<srcCount; i++)
+		gf16_affine_expand_matrix(gf16_affine_load_matrix(scratch, coefficients[i]), mat_ll+i, mat_hl+i, mat_lh+i, mat_hh+i);
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)*2) {
+		__m256i tph, tpl;
+		if(doAdd) {
+			tph = _mm256_load_si256((__m256i*)(_dst + ptr));
+			tpl = _mm256_load_si256((__m256i*)(_dst + ptr) + 1);
+		} else {
+			tph = _mm256_setzero_si256();
+			tpl = _mm256_setzero_si256();
+		}
+		for(i=0; i<srcCount; i++)
+			gf16_affine_muladd_round((__m256i*)(_src[i] + ptr), &tpl, &tph, mat_ll[i], mat_hl[i], mat_lh[i], mat_hh[i]);
+		_mm256_store_si256((__m256i*)(_dst + ptr), tph);
+		_mm256_store_si256((__m256i*)(_dst + ptr)+1, tpl);
+	}
+}
+#endif /*defined(__GFNI__) && defined(__AVX2__)*/
+
+void gf16_affine_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i mat_ll, mat_hl, mat_lh, mat_hh;
+	gf16_affine_expand_matrix(gf16_affine_load_matrix(scratch, coefficient), &mat_ll, &mat_hl, &mat_lh, &mat_hh);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)*2) {
+		__m256i tph = _mm256_load_si256((__m256i*)(_dst + ptr));
+		__m256i tpl = _mm256_load_si256((__m256i*)(_dst + ptr) + 1);
+		gf16_affine_muladd_round((__m256i*)(_src + ptr), &tpl, &tph, mat_ll, mat_hl, mat_lh, mat_hh);
+		_mm256_store_si256 ((__m256i*)(_dst + ptr), tph);
+		_mm256_store_si256 ((__m256i*)(_dst + ptr)+1, tpl);
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+void gf16_affine_powadd_avx2(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i mat_ll, mat_hl, mat_lh, mat_hh;
+	gf16_affine_expand_matrix(gf16_affine_load_matrix(scratch, coefficient), &mat_ll, &mat_hl, &mat_lh, &mat_hh);
+	
+	uint8_t* _src = (uint8_t*)src + offset + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)*2) {
+		__m256i ta = _mm256_load_si256((__m256i*)(_src + ptr));
+		__m256i tb = _mm256_load_si256((__m256i*)(_src + ptr) + 1);
+		// each output's product is the source for the next
+		for(unsigned output = 0; output < outputs; output++) {
+			__m256i tpl = _mm256_xor_si256(
+				_mm256_gf2p8affine_epi64_epi8(ta, mat_lh, 0),
+				_mm256_gf2p8affine_epi64_epi8(tb, mat_ll, 0)
+			);
+			__m256i tph = _mm256_xor_si256(
+				_mm256_gf2p8affine_epi64_epi8(ta, mat_hh, 0),
+				_mm256_gf2p8affine_epi64_epi8(tb, mat_hl, 0)
+			);
+			
+			__m256i* _dst = (__m256i*)((uint8_t*)dst[output] + offset + len + ptr);
+			_mm256_store_si256(_dst, _mm256_xor_si256(tph, _mm256_load_si256(_dst)));
+			_mm256_store_si256(_dst + 1, _mm256_xor_si256(tpl, _mm256_load_si256(_dst + 1)));
+			ta = tph;
+			tb = tpl;
+		}
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX2__) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine_muladd_multi_x_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
+	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	const uint8_t* _src[GF16_AFFINE_FANIN];
+	
+	unsigned region = 0;
+	while(region+1 < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_AFFINE_FANIN) count = GF16_AFFINE_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset + len;
+
+		if(count == 3)
+			gf16_affine_muladd_x_avx2(scratch, _dst, 3, _src, len, coefficients + region, doAdd);
+		else
+			gf16_affine_muladd_x_avx2(scratch, _dst, 2, _src, len, coefficients + region, doAdd);
+		region += count;
+	}
+	return region;
+}
+#endif
+
+unsigned gf16_affine_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_affine_muladd_multi_x_avx2(scratch, regions, offset, dst, src, len, coefficients, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine_mul_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX2__) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine_muladd_multi_x_avx2(scratch, (regions > GF16_AFFINE_FANIN ? GF16_AFFINE_FANIN : regions), offset, dst, src, len, coefficients, 0);
+	region += gf16_affine_muladd_multi_x_avx2(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX2__)
+# include "gf16_bitdep_init_avx2.h"
+#endif
+void* gf16_affine_init_avx2(int polynomial) {
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m128i* ret;
+	ALIGN_ALLOC(ret, sizeof(__m256i)*16*4, 32);
+	gf16_bitdep_init256(ret, polynomial, 1);
+	return ret;
+#else
+	UNUSED(polynomial);
+	return NULL;
+#endif
+}
+
+
+
+void gf16_affine2x_prepare_avx2(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen) {
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i shuf = _mm256_set_epi32(
+		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200,
+		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200
+	);
+	
+	size_t len = srcLen & ~(sizeof(__m256i) -1);
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)) {
+		__m256i data = _mm256_loadu_si256((__m256i*)(_src+ptr));
+		data = _mm256_shuffle_epi8(data, shuf);
+		_mm256_store_si256((__m256i*)(_dst+ptr), data);
+	}
+	
+	size_t remaining = srcLen & (sizeof(__m256i) - 1);
+	if(remaining) {
+		// handle misaligned part
+		__m256i data = _mm256_setzero_si256();
+		memcpy(&data, _src, remaining);
+		data = _mm256_shuffle_epi8(data, shuf);
+		_mm256_store_si256((__m256i*)_dst, data);
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(dst); UNUSED(src); UNUSED(srcLen);
+#endif
+}
+
+void gf16_affine2x_finish_avx2(void *HEDLEY_RESTRICT dst, size_t len) {
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i shuf = _mm256_set_epi32(
+		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
+		0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
+	);
+	uint8_t* _dst = (uint8_t*)dst + len;
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)) {
+		__m256i data = _mm256_load_si256((__m256i*)(_dst+ptr));
+		data = _mm256_shuffle_epi8(data, shuf);
+		_mm256_store_si256((__m256i*)(_dst+ptr), data);
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(dst); UNUSED(len);
+#endif
+}
+
+void gf16_affine2x_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	__m256i depmask = gf16_affine_load_matrix(scratch, coefficient);
+	__m256i depmask1 = _mm256_permute2x128_si256(depmask, depmask, 0x00);
+	__m256i depmask2 = _mm256_permute2x128_si256(depmask, depmask, 0x11);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)) {
+		__m256i data = _mm256_load_si256((__m256i*)(_src + ptr));
+		__m256i result1 = _mm256_gf2p8affine_epi64_epi8(data, depmask1, 0);
+		__m256i result2 = _mm256_gf2p8affine_epi64_epi8(data, depmask2, 0);
+		result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)(_dst + ptr)));
+		result1 = _mm256_xor_si256(result1, _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
+		_mm256_store_si256((__m256i*)(_dst + ptr), result1);
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(__GFNI__) && defined(__AVX2__)
+// if `nt` is set, data is in natural word order (see gf16_affine2x_nt_muladd_avx2), and gets rearranged on the fly
+static HEDLEY_ALWAYS_INLINE __m256i gf16_affine2x_load(const void* src, const int nt) {
+	__m256i data = _mm256_load_si256((__m256i*)src);
+	if(nt) data = _mm256_shuffle_epi8(data, _mm256_set_epi32(
+		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200,
+		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200
+	));
+	return data;
+}
+static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx2(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int nt, const int doAdd
+) {
+	__m256i matNorm[GF16_AFFINE2X_FANIN], matSwap[GF16_AFFINE2X_FANIN];
+	int i;
+	for(i=0; i<srcCount; i++) {
+		__m256i depmask = gf16_affine_load_matrix(scratch, coefficients[i]);
+		matNorm[i] = _mm256_permute2x128_si256(depmask, depmask, 0x00);
+		matSwap[i] = _mm256_permute2x128_si256(depmask, depmask, 0x11);
+	}
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m256i)) {
+		__m256i data = gf16_affine2x_load(_src[0] + ptr, nt);
+		__m256i result1 = _mm256_gf2p8affine_epi64_epi8(data, matNorm[0], 0);
+		__m256i result2 = _mm256_gf2p8affine_epi64_epi8(data, matSwap[0], 0);
+
+		for(i=1; i<srcCount; i++) {
+			data = gf16_affine2x_load(_src[i] + ptr, nt);
+			result1 = _mm256_xor_si256(result1, _mm256_gf2p8affine_epi64_epi8(data, matNorm[i], 0));
+			result2 = _mm256_xor_si256(result2, _mm256_gf2p8affine_epi64_epi8(data, matSwap[i], 0));
+		}
+
+		if(nt) {
+			result1 = _mm256_xor_si256(result1, _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
+			result1 = _mm256_shuffle_epi8(result1, _mm256_set_epi32(
+				0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800,
+				0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800
+			));
+			if(doAdd)
+				result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)(_dst + ptr)));
+		} else {
+			if(doAdd)
+				result1 = _mm256_xor_si256(result1, _mm256_load_si256((__m256i*)(_dst + ptr)));
+			result1 = _mm256_xor_si256(result1, _mm256_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
+		}
+		_mm256_store_si256((__m256i*)(_dst + ptr), result1);
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine2x_muladd_multi_x_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int nt, const int doAdd) {
+	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	const uint8_t* _src[GF16_AFFINE2X_FANIN];
+	
+	unsigned region = 0;
+#ifdef PLATFORM_AMD64
+	while(region+1 < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_AFFINE2X_FANIN) count = GF16_AFFINE2X_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset + len;
+
+		#define _CASE(n) case n: gf16_affine2x_muladd_x_avx2(scratch, _dst, n, _src, len, coefficients + region, nt, doAdd); break
+		switch(count) {
+			_CASE(6);
+			_CASE(5);
+			_CASE(4);
+			_CASE(3);
+			_CASE(2);
+			default: break;
+		}
+		#undef _CASE
+		region += count;
+	}
+#else
+	// if only 8 registers available, only allow 2 parallel regions
+	for(; region < (regions & ~1); region+=2) {
+		_src[0] = (const uint8_t*)src[region] + offset + len;
+		_src[1] = (const uint8_t*)src[region+1] + offset + len;
+		gf16_affine2x_muladd_x_avx2(scratch, _dst, 2, _src, len, coefficients + region, nt, doAdd);
+	}
+#endif
+	return region;
+}
+#endif /*defined(__GFNI__) && defined(__AVX2__)*/
+
+void gf16_affine2x_mul_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx2(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 0, 0);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+unsigned gf16_affine2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	unsigned region = gf16_affine2x_muladd_multi_x_avx2(scratch, regions, offset, dst, src, len, coefficients, 0, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine2x_mul_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX2__)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine2x_muladd_multi_x_avx2(scratch, GF16_AFFINE2X_FIRST_GROUP(regions), offset, dst, src, len, coefficients, 0, 0);
+	region += gf16_affine2x_muladd_multi_x_avx2(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 0, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
+
+// non-transforming variant of Affine2x: works on words in their natural layout, rearranging bytes in registers rather than needing prepare/finish passes
+void gf16_affine2x_nt_mul_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx2(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 1, 0);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+void gf16_affine2x_nt_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx2(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 1, 1);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+unsigned gf16_affine2x_nt_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX2__)
+	unsigned region = gf16_affine2x_muladd_multi_x_avx2(scratch, regions, offset, dst, src, len, coefficients, 1, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine2x_nt_mul_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX2__)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine2x_muladd_multi_x_avx2(scratch, GF16_AFFINE2X_FIRST_GROUP(regions), offset, dst, src, len, coefficients, 1, 0);
+	region += gf16_affine2x_muladd_multi_x_avx2(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
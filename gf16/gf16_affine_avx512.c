@@ -8,6 +8,29 @@ int gf16_affine_available_avx512 = 1;
 int gf16_affine_available_avx512 = 0;
 #endif
 
+// number of sources processed per pass over the destination, by the multi-region kernels; can be overridden at compile time
+// Affine supports 4, 6 or 8 (beyond 6, matrices no longer fit in registers, so are read from memory); Affine2x supports 4, 6, 8, 9 or 12
+#define GF16_AFFINE_MAX_FANIN 8
+#define GF16_AFFINE2X_MAX_FANIN 12
+#ifndef GF16_AFFINE_FANIN
+# define GF16_AFFINE_FANIN 6
+#endif
+#ifndef GF16_AFFINE2X_FANIN
+# define GF16_AFFINE2X_FANIN 9
+#endif
+#if GF16_AFFINE_FANIN != 4 && GF16_AFFINE_FANIN != 6 && GF16_AFFINE_FANIN != 8
+# error GF16_AFFINE_FANIN must be 4, 6 or 8
+#endif
+#if GF16_AFFINE2X_FANIN != 4 && GF16_AFFINE2X_FANIN != 6 && GF16_AFFINE2X_FANIN != 8 && GF16_AFFINE2X_FANIN != 9 && GF16_AFFINE2X_FANIN != 12
+# error GF16_AFFINE2X_FANIN must be 4, 6, 8, 9 or 12
+#endif
+// number of regions overwritten by the first pass of the mul_multi kernels; without the additional registers of x86-64, regions are only processed in pairs
+#ifdef PLATFORM_AMD64
+# define GF16_AFFINE2X_FIRST_GROUP(regions) ((regions) > GF16_AFFINE2X_FANIN ? GF16_AFFINE2X_FANIN : (regions))
+#else
+# define GF16_AFFINE2X_FIRST_GROUP(regions) 2
+#endif
+
 
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
 static HEDLEY_ALWAYS_INLINE __m256i gf16_affine_load_matrix(const void *HEDLEY_RESTRICT scratch, uint16_t coefficient) {
@@ -112,74 +135,51 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_round(const __m512i* src, __
 }
 static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x_avx512(
 	const void *HEDLEY_RESTRICT scratch,
-	uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
-	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4, const uint8_t *HEDLEY_RESTRICT _src5, const uint8_t *HEDLEY_RESTRICT _src6,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients
+	uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
-	__m512i mat_All, mat_Alh, mat_Ahl, mat_Ahh;
-	__m512i mat_Bll, mat_Blh, mat_Bhl, mat_Bhh;
-	__m512i mat_Cll, mat_Clh, mat_Chl, mat_Chh;
-	__m512i mat_Dll, mat_Dlh, mat_Dhl, mat_Dhh;
-	__m512i mat_Ell, mat_Elh, mat_Ehl, mat_Ehh;
-	__m512i mat_Fll, mat_Flh, mat_Fhl, mat_Fhh;
+	// matrices beyond what fits in registers get spilled, and are then used as memory operands
+	__m512i mat_ll[GF16_AFFINE_MAX_FANIN], mat_lh[GF16_AFFINE_MAX_FANIN], mat_hl[GF16_AFFINE_MAX_FANIN], mat_hh[GF16_AFFINE_MAX_FANIN];
 	
-	#define PERM1(dstVec, srcLL) \
-		dstVec##hh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(3,3,3,3)); \
-		dstVec##lh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(1,1,1,1)); \
-		dstVec##ll = _mm512_broadcastq_epi64(srcLL); \
-		dstVec##hl = _mm512_broadcastq_epi64(_mm512_castsi512_si128(depmask2))
-	#define PERM2(dstVec) \
+	#define PERM1(i, srcLL) \
+		mat_hh[i] = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(3,3,3,3)); \
+		mat_lh[i] = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(1,1,1,1)); \
+		mat_ll[i] = _mm512_broadcastq_epi64(srcLL); \
+		mat_hl[i] = _mm512_broadcastq_epi64(_mm512_castsi512_si128(depmask2))
+	#define PERM2(i) \
 		depmask2 = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,3,2,3)); \
-		dstVec##hh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(3,3,3,3)); \
-		dstVec##lh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(1,1,1,1)); \
-		dstVec##ll = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(2,2,2,2)); \
-		dstVec##hl = _mm512_broadcastq_epi64(_mm512_castsi512_si128(depmask2))
-	
-	__m512i depmask = gf16_affine_load2_matrix(scratch, coefficients[0], coefficients[1]);
-	__m512i depmask2 = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,1,0,1));
-	PERM1(mat_A, _mm512_castsi512_si128(depmask));
-	PERM2(mat_B);
+		mat_hh[i] = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(3,3,3,3)); \
+		mat_lh[i] = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(1,1,1,1)); \
+		mat_ll[i] = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(2,2,2,2)); \
+		mat_hl[i] = _mm512_broadcastq_epi64(_mm512_castsi512_si128(depmask2))
 	
-	__m256i depmask3;
-	if(srcCount == 3) {
-		depmask3 = gf16_affine_load_matrix(scratch, coefficients[2]);
-		depmask2 = _mm512_castsi256_si512(depmask3);
+	int i;
+	for(i=0; i+1 < srcCount; i+=2) {
+		__m512i depmask = gf16_affine_load2_matrix(scratch, coefficients[i], coefficients[i+1]);
+		__m512i depmask2 = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,1,0,1));
+		PERM1(i, _mm512_castsi512_si128(depmask));
+		PERM2(i+1);
+	}
+	if(i < srcCount) {
+		__m256i depmask3 = gf16_affine_load_matrix(scratch, coefficients[i]);
+		__m512i depmask2 = _mm512_castsi256_si512(depmask3);
 		depmask2 = _mm512_shuffle_i64x2(depmask2, depmask2, _MM_SHUFFLE(0,1,0,1));
-		PERM1(mat_C, _mm256_castsi256_si128(depmask3));
-	} else if(srcCount > 3) {
-		depmask = gf16_affine_load2_matrix(scratch, coefficients[2], coefficients[3]);
-		depmask2 = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,1,0,1));
-		PERM1(mat_C, _mm512_castsi512_si128(depmask));
-		PERM2(mat_D);
-		
-		if(srcCount == 5) {
-			depmask3 = gf16_affine_load_matrix(scratch, coefficients[4]);
-			depmask2 = _mm512_castsi256_si512(depmask3);
-			depmask2 = _mm512_shuffle_i64x2(depmask2, depmask2, _MM_SHUFFLE(0,1,0,1));
-			PERM1(mat_E, _mm256_castsi256_si128(depmask3));
-		} else if(srcCount > 5) {
-			depmask = gf16_affine_load2_matrix(scratch, coefficients[4], coefficients[5]);
-			depmask2 = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,1,0,1));
-			PERM1(mat_E, _mm512_castsi512_si128(depmask));
-			PERM2(mat_F);
-		}
+		PERM1(i, _mm256_castsi256_si128(depmask3));
 	}
 	#undef PERM1
 	#undef PERM2
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m512i)*2) {
-		__m512i tph = _mm512_load_si512((__m512i*)(_dst + ptr));
-		__m512i tpl = _mm512_load_si512((__m512i*)(_dst + ptr) + 1);
-		gf16_affine_muladd_round((__m512i*)(_src1 + ptr), &tpl, &tph, mat_All, mat_Ahl, mat_Alh, mat_Ahh);
-		gf16_affine_muladd_round((__m512i*)(_src2 + ptr), &tpl, &tph, mat_Bll, mat_Bhl, mat_Blh, mat_Bhh);
-		if(srcCount >= 3)
-			gf16_affine_muladd_round((__m512i*)(_src3 + ptr), &tpl, &tph, mat_Cll, mat_Chl, mat_Clh, mat_Chh);
-		if(srcCount >= 4)
-			gf16_affine_muladd_round((__m512i*)(_src4 + ptr), &tpl, &tph, mat_Dll, mat_Dhl, mat_Dlh, mat_Dhh);
-		if(srcCount >= 5)
-			gf16_affine_muladd_round((__m512i*)(_src5 + ptr), &tpl, &tph, mat_Ell, mat_Ehl, mat_Elh, mat_Ehh);
-		if(srcCount >= 6)
-			gf16_affine_muladd_round((__m512i*)(_src6 + ptr), &tpl, &tph, mat_Fll, mat_Fhl, mat_Flh, mat_Fhh);
+		__m512i tph, tpl;
+		if(doAdd) {
+			tph = _mm512_load_si512((__m512i*)(_dst + ptr));
+			tpl = _mm512_load_si512((__m512i*)(_dst + ptr) + 1);
+		} else {
+			tph = _mm512_setzero_si512();
+			tpl = _mm512_setzero_si512();
+		}
+		for(i=0; i<srcCount; i++)
+			gf16_affine_muladd_round((__m512i*)(_src[i] + ptr), &tpl, &tph, mat_ll[i], mat_hl[i], mat_lh[i], mat_hh[i]);
 		_mm512_store_si512((__m512i*)(_dst + ptr), tph);
 		_mm512_store_si512((__m512i*)(_dst + ptr)+1, tpl);
 	}
@@ -216,67 +216,104 @@ void gf16_affine_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY
 #endif
 }
 
-unsigned gf16_affine_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+void gf16_affine_powadd_avx512(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	__m256i depmask = gf16_affine_load_matrix(scratch, coefficient);
+	
+	__m512i mat_ll, mat_lh, mat_hl, mat_hh;
+	__m512i depmask2 = _mm512_castsi256_si512(depmask);
+	depmask2 = _mm512_shuffle_i64x2(depmask2, depmask2, _MM_SHUFFLE(0,1,0,1));
+	mat_hh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(3,3,3,3));
+	mat_lh = _mm512_permutex_epi64(depmask2, _MM_SHUFFLE(1,1,1,1));
+	mat_ll = _mm512_broadcastq_epi64(_mm256_castsi256_si128(depmask));
+	mat_hl = _mm512_broadcastq_epi64(_mm512_castsi512_si128(depmask2));
+	
+	uint8_t* _src = (uint8_t*)src + offset + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m512i)*2) {
+		__m512i ta = _mm512_load_si512((__m512i*)(_src + ptr));
+		__m512i tb = _mm512_load_si512((__m512i*)(_src + ptr) + 1);
+		// each output's product is the source for the next
+		for(unsigned output = 0; output < outputs; output++) {
+			__m512i tpl = _mm512_xor_si512(
+				_mm512_gf2p8affine_epi64_epi8(ta, mat_lh, 0),
+				_mm512_gf2p8affine_epi64_epi8(tb, mat_ll, 0)
+			);
+			__m512i tph = _mm512_xor_si512(
+				_mm512_gf2p8affine_epi64_epi8(ta, mat_hh, 0),
+				_mm512_gf2p8affine_epi64_epi8(tb, mat_hl, 0)
+			);
+			
+			__m512i* _dst = (__m512i*)((uint8_t*)dst[output] + offset + len + ptr);
+			_mm512_store_si512(_dst, _mm512_xor_si512(tph, _mm512_load_si512(_dst)));
+			_mm512_store_si512(_dst + 1, _mm512_xor_si512(tpl, _mm512_load_si512(_dst + 1)));
+			ta = tph;
+			tb = tpl;
+		}
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine_muladd_multi_x_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	const uint8_t* _src[GF16_AFFINE_FANIN];
 	
 	unsigned region = 0;
-	if(regions > 5) do {
-		gf16_affine_muladd_x_avx512(
-			scratch, _dst, 6,
-			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-			(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-			len, coefficients + region
-		);
-		region += 6;
-	} while(region+5 < regions);
-	switch(regions - region) {
-		case 5:
-			gf16_affine_muladd_x_avx512(
-				scratch, _dst, 5,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, NULL,
-				len, coefficients + region
-			);
-			region += 5;
-		break;
-		case 4:
-			gf16_affine_muladd_x_avx512(
-				scratch, _dst, 4,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 4;
-		break;
-		case 3:
-			gf16_affine_muladd_x_avx512(
-				scratch, _dst, 3,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 3;
-		break;
-		case 2:
-			gf16_affine_muladd_x_avx512(
-				scratch, _dst, 2,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
-				NULL, NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 2;
-		break;
-		default: break;
+	while(region+1 < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_AFFINE_FANIN) count = GF16_AFFINE_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset + len;
+		
+		#define _CASE(n) case n: gf16_affine_muladd_x_avx512(scratch, _dst, n, _src, len, coefficients + region, doAdd); break
+		switch(count) {
+#if GF16_AFFINE_FANIN >= 8
+			_CASE(8);
+			_CASE(7);
+#endif
+#if GF16_AFFINE_FANIN >= 6
+			_CASE(6);
+			_CASE(5);
+#endif
+			_CASE(4);
+			_CASE(3);
+			_CASE(2);
+			default: break;
+		}
+		#undef _CASE
+		region += count;
 	}
 	return region;
+}
+#endif
+
+unsigned gf16_affine_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	return gf16_affine_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, 1);
 #else
 	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
 	return 0;
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine_muladd_multi_x_avx512(scratch, (regions > GF16_AFFINE_FANIN ? GF16_AFFINE_FANIN : regions), offset, dst, src, len, coefficients, 0);
+	return region + gf16_affine_muladd_multi_x_avx512(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
 # include "gf16_bitdep_init_avx2.h"
 #endif
@@ -367,292 +404,211 @@ void gf16_affine2x_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDL
 
 
 #if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+// if `nt` is set, data is in natural word order (see gf16_affine2x_nt_muladd_avx512), and gets rearranged on the fly
+static HEDLEY_ALWAYS_INLINE __m512i gf16_affine2x_load(const void* src, const int nt) {
+	__m512i data = _mm512_load_si512(src);
+	if(nt) data = _mm512_shuffle_epi8(data, _mm512_set4_epi32(0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200));
+	return data;
+}
 static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_avx512(
-	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
-	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4, const uint8_t *HEDLEY_RESTRICT _src5, const uint8_t *HEDLEY_RESTRICT _src6, const uint8_t *HEDLEY_RESTRICT _src7, const uint8_t *HEDLEY_RESTRICT _src8, const uint8_t *HEDLEY_RESTRICT _src9,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int nt, const int doAdd
 ) {
-	__m512i depmask = gf16_affine_load2_matrix(scratch, coefficients[0], coefficients[1]);
-	__m512i matNormA = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-	__m512i matSwapA = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-	__m512i matNormB = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,2,2,2));
-	__m512i matSwapB = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(3,3,3,3));
-	
-	__m512i matNormC, matSwapC;
-	__m512i matNormD, matSwapD;
-	__m512i matNormE, matSwapE;
-	__m512i matNormF, matSwapF;
-	__m512i matNormG, matSwapG;
-	__m512i matNormH, matSwapH;
-	__m512i matNormI, matSwapI;
-	if(srcCount == 3) {
-		depmask = _mm512_castsi256_si512(gf16_affine_load_matrix(scratch, coefficients[2]));
-		matNormC = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapC = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-	}
-	if(srcCount > 3) {
-		depmask = gf16_affine_load2_matrix(scratch, coefficients[2], coefficients[3]);
-		matNormC = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapC = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-		matNormD = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,2,2,2));
-		matSwapD = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(3,3,3,3));
+	__m512i matNorm[GF16_AFFINE2X_MAX_FANIN], matSwap[GF16_AFFINE2X_MAX_FANIN];
+	int i;
+	for(i=0; i+1 < srcCount; i+=2) {
+		__m512i depmask = gf16_affine_load2_matrix(scratch, coefficients[i], coefficients[i+1]);
+		matNorm[i] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
+		matSwap[i] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
+		matNorm[i+1] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,2,2,2));
+		matSwap[i+1] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(3,3,3,3));
 	}
-	if(srcCount == 5) {
-		depmask = _mm512_castsi256_si512(gf16_affine_load_matrix(scratch, coefficients[4]));
-		matNormE = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapE = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-	}
-	if(srcCount > 5) {
-		depmask = gf16_affine_load2_matrix(scratch, coefficients[4], coefficients[5]);
-		matNormE = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapE = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-		matNormF = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,2,2,2));
-		matSwapF = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(3,3,3,3));
-	}
-	if(srcCount == 7) {
-		depmask = _mm512_castsi256_si512(gf16_affine_load_matrix(scratch, coefficients[6]));
-		matNormG = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapG = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-	}
-	if(srcCount > 7) {
-		depmask = gf16_affine_load2_matrix(scratch, coefficients[6], coefficients[7]);
-		matNormG = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapG = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
-		matNormH = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(2,2,2,2));
-		matSwapH = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(3,3,3,3));
-	}
-	if(srcCount == 9) {
-		depmask = _mm512_castsi256_si512(gf16_affine_load_matrix(scratch, coefficients[8]));
-		matNormI = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
-		matSwapI = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
+	if(i < srcCount) {
+		__m512i depmask = _mm512_castsi256_si512(gf16_affine_load_matrix(scratch, coefficients[i]));
+		matNorm[i] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(0,0,0,0));
+		matSwap[i] = _mm512_shuffle_i64x2(depmask, depmask, _MM_SHUFFLE(1,1,1,1));
 	}
 	
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m512i)) {
-		__m512i data1 = _mm512_load_si512((__m512i*)(_src1 + ptr));
-		__m512i data2 = _mm512_load_si512((__m512i*)(_src2 + ptr));
-		__m512i result, swapped;
-		if(srcCount >= 3) {
-			__m512i data3 = _mm512_load_si512((__m512i*)(_src3 + ptr));
-			result = _mm512_ternarylogic_epi32(
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormA, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matNormB, 0),
-				_mm512_gf2p8affine_epi64_epi8(data3, matNormC, 0),
-				0x96
-			);
-			swapped = _mm512_ternarylogic_epi32(
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapA, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matSwapB, 0),
-				_mm512_gf2p8affine_epi64_epi8(data3, matSwapC, 0),
-				0x96
-			);
-		} else {
-			result = _mm512_xor_si512(
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormA, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matNormB, 0)
-			);
-			swapped = _mm512_xor_si512(
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapA, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matSwapB, 0)
-			);
-		}
+		__m512i data1 = gf16_affine2x_load(_src[0] + ptr, nt);
+		__m512i result = _mm512_gf2p8affine_epi64_epi8(data1, matNorm[0], 0);
+		__m512i swapped = _mm512_gf2p8affine_epi64_epi8(data1, matSwap[0], 0);
 		
-		if(srcCount >= 4)
-			data1 = _mm512_load_si512((__m512i*)(_src4 + ptr));
-		if(srcCount == 4) {
-			result = _mm512_xor_si512(
-				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormD, 0)
-			);
-			swapped = _mm512_xor_si512(
-				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapD, 0)
-			);
-		}
-		if(srcCount > 4) {
-			data2 = _mm512_load_si512((__m512i*)(_src5 + ptr));
+		// combine sources in pairs with ternary-logic
+		for(i=1; i+1 < srcCount; i+=2) {
+			data1 = gf16_affine2x_load(_src[i] + ptr, nt);
+			__m512i data2 = gf16_affine2x_load(_src[i+1] + ptr, nt);
 			result = _mm512_ternarylogic_epi32(
 				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormD, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matNormE, 0),
+				_mm512_gf2p8affine_epi64_epi8(data1, matNorm[i], 0),
+				_mm512_gf2p8affine_epi64_epi8(data2, matNorm[i+1], 0),
 				0x96
 			);
 			swapped = _mm512_ternarylogic_epi32(
 				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapD, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matSwapE, 0),
+				_mm512_gf2p8affine_epi64_epi8(data1, matSwap[i], 0),
+				_mm512_gf2p8affine_epi64_epi8(data2, matSwap[i+1], 0),
 				0x96
 			);
 		}
-		if(srcCount >= 6)
-			data1 = _mm512_load_si512((__m512i*)(_src6 + ptr));
-		if(srcCount == 6) {
+		if(i < srcCount) {
+			data1 = gf16_affine2x_load(_src[i] + ptr, nt);
 			result = _mm512_xor_si512(
 				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormF, 0)
+				_mm512_gf2p8affine_epi64_epi8(data1, matNorm[i], 0)
 			);
 			swapped = _mm512_xor_si512(
 				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapF, 0)
+				_mm512_gf2p8affine_epi64_epi8(data1, matSwap[i], 0)
 			);
 		}
-		if(srcCount > 6) {
-			data2 = _mm512_load_si512((__m512i*)(_src7 + ptr));
-			result = _mm512_ternarylogic_epi32(
-				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormF, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matNormG, 0),
-				0x96
-			);
-			swapped = _mm512_ternarylogic_epi32(
-				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapF, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matSwapG, 0),
-				0x96
-			);
-		}
-		if(srcCount >= 8)
-			data1 = _mm512_load_si512((__m512i*)(_src8 + ptr));
-		if(srcCount == 8) {
-			result = _mm512_xor_si512(
-				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormH, 0)
-			);
-			swapped = _mm512_xor_si512(
-				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapH, 0)
-			);
-		}
-		if(srcCount > 8) {
-			data2 = _mm512_load_si512((__m512i*)(_src9 + ptr));
+		
+		if(nt) {
+			result = _mm512_xor_si512(result, _mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)));
+			result = _mm512_shuffle_epi8(result, _mm512_set4_epi32(0x0f070e06, 0x0d050c04, 0x0b030a02, 0x09010800));
+			if(doAdd)
+				result = _mm512_xor_si512(result, _mm512_load_si512((__m512i*)(_dst + ptr)));
+		} else if(doAdd) {
 			result = _mm512_ternarylogic_epi32(
 				result,
-				_mm512_gf2p8affine_epi64_epi8(data1, matNormH, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matNormI, 0),
-				0x96
-			);
-			swapped = _mm512_ternarylogic_epi32(
-				swapped,
-				_mm512_gf2p8affine_epi64_epi8(data1, matSwapH, 0),
-				_mm512_gf2p8affine_epi64_epi8(data2, matSwapI, 0),
+				_mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)),
+				_mm512_load_si512((__m512i*)(_dst + ptr)),
 				0x96
 			);
+		} else {
+			result = _mm512_xor_si512(result, _mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)));
 		}
-		
-		result = _mm512_ternarylogic_epi32(
-			result,
-			_mm512_shuffle_epi32(swapped, _MM_SHUFFLE(1,0,3,2)),
-			_mm512_load_si512((__m512i*)(_dst + ptr)),
-			0x96
-		);
 		_mm512_store_si512 ((__m512i*)(_dst + ptr), result);
 	}
 }
-#endif /*defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)*/
 
-unsigned gf16_affine2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
-#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine2x_muladd_multi_x_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int nt, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	const uint8_t* _src[GF16_AFFINE2X_FANIN];
 	
 	unsigned region = 0;
 #ifdef PLATFORM_AMD64
-	// TODO: support more regions?
-	if(regions > 8) do {
-		gf16_affine2x_muladd_x_avx512(
-			scratch, _dst, 9,
-			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-			(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-			(const uint8_t* HEDLEY_RESTRICT)src[region+6] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+7] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+8] + offset + len,
-			len, coefficients + region
-		);
-		region += 9;
-	} while(region+8 < regions);
-	switch(regions - region) {
-		case 8:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 8,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+6] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+7] + offset + len, NULL,
-				len, coefficients + region
-			);
-			region += 8;
-		break;
-		case 7:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 7,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+6] + offset + len, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 7;
-		break;
-		case 6:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 6,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-				NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 6;
-		break;
-		case 5:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 5,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len,
-				NULL, NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 5;
-		break;
-		case 4:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 4,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len,
-				NULL, NULL, NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 4;
-		break;
-		case 3:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 3,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-				NULL, NULL, NULL, NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 3;
-		break;
-		case 2:
-			gf16_affine2x_muladd_x_avx512(
-				scratch, _dst, 2,
-				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
-				NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-				len, coefficients + region
-			);
-			region += 2;
-		break;
-		default: break;
+	while(region+1 < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_AFFINE2X_FANIN) count = GF16_AFFINE2X_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset + len;
+		
+		#define _CASE(n) case n: gf16_affine2x_muladd_x_avx512(scratch, _dst, n, _src, len, coefficients + region, nt, doAdd); break
+		switch(count) {
+#if GF16_AFFINE2X_FANIN >= 12
+			_CASE(12);
+			_CASE(11);
+			_CASE(10);
+#endif
+#if GF16_AFFINE2X_FANIN >= 9
+			_CASE(9);
+#endif
+#if GF16_AFFINE2X_FANIN >= 8
+			_CASE(8);
+			_CASE(7);
+#endif
+#if GF16_AFFINE2X_FANIN >= 6
+			_CASE(6);
+			_CASE(5);
+#endif
+			_CASE(4);
+			_CASE(3);
+			_CASE(2);
+			default: break;
+		}
+		#undef _CASE
+		region += count;
 	}
 #else
 	// if only 8 registers available, only allow 2 parallel regions
 	for(; region < (regions & ~1); region+=2) {
-		gf16_affine2x_muladd_x_avx512(
-			scratch, _dst, 2,
-			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
-			NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-			len, coefficients + region
-		);
+		_src[0] = (const uint8_t*)src[region] + offset + len;
+		_src[1] = (const uint8_t*)src[region+1] + offset + len;
+		gf16_affine2x_muladd_x_avx512(scratch, _dst, 2, _src, len, coefficients + region, nt, doAdd);
 	}
 #endif
 	return region;
+}
+#endif /*defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)*/
+
+void gf16_affine2x_mul_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx512(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 0, 0);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+unsigned gf16_affine2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	return gf16_affine2x_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, 0, 1);
 #else
 	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
 	return 0;
 #endif
 }
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine2x_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine2x_muladd_multi_x_avx512(scratch, GF16_AFFINE2X_FIRST_GROUP(regions), offset, dst, src, len, coefficients, 0, 0);
+	return region + gf16_affine2x_muladd_multi_x_avx512(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 0, 1);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
+
+// non-transforming variant of Affine2x: operates on words in their natural (little endian) layout, so needs no prepare/finish passes
+// instead, the byte rearrangement done by prepare/finish is performed in registers, once for each source read and destination written
+void gf16_affine2x_nt_mul_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx512(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 1, 0);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+void gf16_affine2x_nt_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	const uint8_t* _src = (const uint8_t*)src + len;
+	gf16_affine2x_muladd_x_avx512(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 1, 1);
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+unsigned gf16_affine2x_nt_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	return gf16_affine2x_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, 1, 1);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine2x_nt_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine2x_muladd_multi_x_avx512(scratch, GF16_AFFINE2X_FIRST_GROUP(regions), offset, dst, src, len, coefficients, 1, 0);
+	return region + gf16_affine2x_muladd_multi_x_avx512(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1, 1);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
@@ -9,6 +9,13 @@ int gf16_affine_available_gfni = 1;
 int gf16_affine_available_gfni = 0;
 #endif
 
+// number of regions overwritten by the first pass of the Affine2x mul_multi kernel; without the additional registers of x86-64, regions are only processed in pairs
+#ifdef PLATFORM_AMD64
+# define GF16_AFFINE2X_FIRST_GROUP(regions) ((regions) > 6 ? 6 : (regions))
+#else
+# define GF16_AFFINE2X_FIRST_GROUP(regions) 2
+#endif
+
 #if defined(__GFNI__) && defined(__SSSE3__)
 static HEDLEY_ALWAYS_INLINE void gf16_affine_load_matrix(const void *HEDLEY_RESTRICT scratch, uint16_t coefficient, __m128i* depmask1, __m128i* depmask2) {
 	*depmask1 = _mm_load_si128((__m128i*)((char*)scratch + ((coefficient & 0xf) << 7)));
@@ -70,7 +77,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_round(const __m128i* src, __
 static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x2_gfni(
 	const void *HEDLEY_RESTRICT scratch,
 	uint8_t *HEDLEY_RESTRICT _dst, const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, size_t len,
-	const uint16_t *HEDLEY_RESTRICT coefficients
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m128i depmask1, depmask2;
 	
@@ -87,8 +94,14 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x2_gfni(
 	__m128i mat_Blh = _mm_unpackhi_epi64(depmask2, depmask2);
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m128i)*2) {
-		__m128i tph = _mm_load_si128((__m128i*)(_dst + ptr));
-		__m128i tpl = _mm_load_si128((__m128i*)(_dst + ptr) + 1);
+		__m128i tph, tpl;
+		if(doAdd) {
+			tph = _mm_load_si128((__m128i*)(_dst + ptr));
+			tpl = _mm_load_si128((__m128i*)(_dst + ptr) + 1);
+		} else {
+			tph = _mm_setzero_si128();
+			tpl = _mm_setzero_si128();
+		}
 		gf16_affine_muladd_round((__m128i*)(_src1 + ptr), &tpl, &tph, mat_All, mat_Ahl, mat_Alh, mat_Ahh);
 		gf16_affine_muladd_round((__m128i*)(_src2 + ptr), &tpl, &tph, mat_Bll, mat_Bhl, mat_Blh, mat_Bhh);
 		_mm_store_si128 ((__m128i*)(_dst + ptr), tph);
@@ -98,7 +111,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x2_gfni(
 static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x3_gfni(
 	const void *HEDLEY_RESTRICT scratch,
 	uint8_t *HEDLEY_RESTRICT _dst, const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, size_t len,
-	const uint16_t *HEDLEY_RESTRICT coefficients
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m128i depmask1, depmask2;
 	
@@ -121,8 +134,14 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine_muladd_x3_gfni(
 	__m128i mat_Clh = _mm_unpackhi_epi64(depmask2, depmask2);
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m128i)*2) {
-		__m128i tph = _mm_load_si128((__m128i*)(_dst + ptr));
-		__m128i tpl = _mm_load_si128((__m128i*)(_dst + ptr) + 1);
+		__m128i tph, tpl;
+		if(doAdd) {
+			tph = _mm_load_si128((__m128i*)(_dst + ptr));
+			tpl = _mm_load_si128((__m128i*)(_dst + ptr) + 1);
+		} else {
+			tph = _mm_setzero_si128();
+			tpl = _mm_setzero_si128();
+		}
 		gf16_affine_muladd_round((__m128i*)(_src1 + ptr), &tpl, &tph, mat_All, mat_Ahl, mat_Alh, mat_Ahh);
 		gf16_affine_muladd_round((__m128i*)(_src2 + ptr), &tpl, &tph, mat_Bll, mat_Bhl, mat_Blh, mat_Bhh);
 		gf16_affine_muladd_round((__m128i*)(_src3 + ptr), &tpl, &tph, mat_Cll, mat_Chl, mat_Clh, mat_Chh);
@@ -160,9 +179,47 @@ void gf16_affine_muladd_gfni(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_R
 #endif
 }
 
-unsigned gf16_affine_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+void gf16_affine_powadd_gfni(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__SSSE3__)
+	__m128i depmask1, depmask2;
+	gf16_affine_load_matrix(scratch, coefficient, &depmask1, &depmask2);
+	
+	__m128i mat_ll = _mm_shuffle_epi32(depmask1, _MM_SHUFFLE(1,0,1,0));
+	__m128i mat_hh = _mm_unpackhi_epi64(depmask1, depmask1);
+	__m128i mat_hl = _mm_shuffle_epi32(depmask2, _MM_SHUFFLE(1,0,1,0));
+	__m128i mat_lh = _mm_unpackhi_epi64(depmask2, depmask2);
+	
+	uint8_t* _src = (uint8_t*)src + offset + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m128i)*2) {
+		__m128i ta = _mm_load_si128((__m128i*)(_src + ptr));
+		__m128i tb = _mm_load_si128((__m128i*)(_src + ptr) + 1);
+		// each output's product is the source for the next
+		for(unsigned output = 0; output < outputs; output++) {
+			__m128i tpl = _mm_xor_si128(
+				_mm_gf2p8affine_epi64_epi8(ta, mat_lh, 0),
+				_mm_gf2p8affine_epi64_epi8(tb, mat_ll, 0)
+			);
+			__m128i tph = _mm_xor_si128(
+				_mm_gf2p8affine_epi64_epi8(ta, mat_hh, 0),
+				_mm_gf2p8affine_epi64_epi8(tb, mat_hl, 0)
+			);
+			
+			__m128i* _dst = (__m128i*)((uint8_t*)dst[output] + offset + len + ptr);
+			_mm_store_si128(_dst, _mm_xor_si128(tph, _mm_load_si128(_dst)));
+			_mm_store_si128(_dst + 1, _mm_xor_si128(tpl, _mm_load_si128(_dst + 1)));
+			ta = tph;
+			tb = tpl;
+		}
+	}
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
 #if defined(__GFNI__) && defined(__SSSE3__) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine_muladd_multi_x_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	
 	unsigned region = 0;
@@ -170,7 +227,7 @@ unsigned gf16_affine_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsi
 		gf16_affine_muladd_x3_gfni(
 			scratch, _dst,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 3;
 	} while(region+2 < regions);
@@ -178,17 +235,38 @@ unsigned gf16_affine_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsi
 		gf16_affine_muladd_x2_gfni(
 			scratch, _dst,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 2;
 	}
 	return region;
+}
+#endif
+
+unsigned gf16_affine_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__SSSE3__) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_affine_muladd_multi_x_gfni(scratch, regions, offset, dst, src, len, coefficients, 1);
+	return region;
 #else
 	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
 	return 0;
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine_mul_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__SSSE3__) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine_muladd_multi_x_gfni(scratch, (regions > 2 ? 3 : 2), offset, dst, src, len, coefficients, 0);
+	region += gf16_affine_muladd_multi_x_gfni(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 #include "gf16_bitdep_init_sse2.h"
 void* gf16_affine_init_gfni(int polynomial) {
 #if defined(__SSSE3__)
@@ -248,6 +326,27 @@ void gf16_affine2x_finish_gfni(void *HEDLEY_RESTRICT dst, size_t len) {
 #endif
 }
 
+void gf16_affine2x_mul_gfni(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__SSSE3__)
+	__m128i depmask1, depmask2;
+	gf16_affine_load_matrix(scratch, coefficient, &depmask1, &depmask2);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(__m128i)) {
+		__m128i data = _mm_load_si128((__m128i*)(_src + ptr));
+		__m128i result1 = _mm_gf2p8affine_epi64_epi8(data, depmask1, 0);
+		__m128i result2 = _mm_gf2p8affine_epi64_epi8(data, depmask2, 0);
+		result1 = _mm_xor_si128(result1, _mm_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
+		_mm_store_si128((__m128i*)(_dst + ptr), result1);
+	}
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
 void gf16_affine2x_muladd_gfni(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 	UNUSED(mutScratch);
 #if defined(__GFNI__) && defined(__SSSE3__)
@@ -275,7 +374,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_gfni(
 	const void *HEDLEY_RESTRICT scratch,
 	uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
 	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4, const uint8_t *HEDLEY_RESTRICT _src5, const uint8_t *HEDLEY_RESTRICT _src6,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m128i matNormA, matSwapA;
 	__m128i matNormB, matSwapB;
@@ -324,16 +423,14 @@ static HEDLEY_ALWAYS_INLINE void gf16_affine2x_muladd_x_gfni(
 			result2 = _mm_xor_si128(result2, _mm_gf2p8affine_epi64_epi8(data, matSwapF, 0));
 		}
 		
-		result1 = _mm_xor_si128(result1, _mm_load_si128((__m128i*)(_dst + ptr)));
+		if(doAdd)
+			result1 = _mm_xor_si128(result1, _mm_load_si128((__m128i*)(_dst + ptr)));
 		result1 = _mm_xor_si128(result1, _mm_shuffle_epi32(result2, _MM_SHUFFLE(1,0,3,2)));
 		_mm_store_si128((__m128i*)(_dst + ptr), result1);
 	}
 }
-#endif /*defined(__GFNI__) && defined(__SSSE3__)*/
 
-unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
-#if defined(__GFNI__) && defined(__SSSE3__)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_affine2x_muladd_multi_x_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	
 	unsigned region = 0;
@@ -343,7 +440,7 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 			scratch, _dst, 6,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 			(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 6;
 	} while(region+5 < regions);
@@ -353,7 +450,7 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 				scratch, _dst, 5,
 				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 5;
 		break;
@@ -362,7 +459,7 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 				scratch, _dst, 4,
 				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len, NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 4;
 		break;
@@ -371,7 +468,7 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 				scratch, _dst, 3,
 				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 				NULL, NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 3;
 		break;
@@ -380,7 +477,7 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 				scratch, _dst, 2,
 				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
 				NULL, NULL, NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 2;
 		break;
@@ -393,14 +490,35 @@ unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, un
 			scratch, _dst, 2,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
 			NULL, NULL, NULL, NULL,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 	}
 #endif
 	return region;
+}
+#endif /*defined(__GFNI__) && defined(__SSSE3__)*/
+
+unsigned gf16_affine2x_muladd_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__GFNI__) && defined(__SSSE3__)
+	unsigned region = gf16_affine2x_muladd_multi_x_gfni(scratch, regions, offset, dst, src, len, coefficients, 1);
+	return region;
 #else
 	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
 	return 0;
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_affine2x_mul_multi_gfni(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__GFNI__) && defined(__SSSE3__)
+	if(regions < 2) return 0;
+	unsigned region = gf16_affine2x_muladd_multi_x_gfni(scratch, GF16_AFFINE2X_FIRST_GROUP(regions), offset, dst, src, len, coefficients, 0);
+	region += gf16_affine2x_muladd_multi_x_gfni(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
@@ -0,0 +1,28 @@
+
+#include "platform.h"
+
+#define MWORD_SIZE 64
+#define _mword __m512i
+#define _MM(f) _mm512_ ## f
+#define _MMI(f) _mm512_ ## f ## _si512
+#define _FN(f) f ## _avx512
+#define _MM_END _mm256_zeroupper();
+#define _CLMUL(a, b, i) _mm512_clmulepi64_epi128(a, b, i)
+#define _SET1_EPI64(c) _mm512_set1_epi64(c)
+#define _LOAD_CONSTS(s) _mm512_broadcast_i32x4(_mm_load_si128((__m128i*)(s)))
+
+#if defined(__VPCLMULQDQ__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+# define _AVAILABLE
+#endif
+#include "gf16_clmul_x86.h"
+#undef _AVAILABLE
+
+#undef MWORD_SIZE
+#undef _mword
+#undef _MM
+#undef _MMI
+#undef _FN
+#undef _MM_END
+#undef _CLMUL
+#undef _SET1_EPI64
+#undef _LOAD_CONSTS
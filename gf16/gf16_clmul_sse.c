@@ -0,0 +1,48 @@
+
+#include "platform.h"
+
+#define MWORD_SIZE 16
+#define _mword __m128i
+#define _MM(f) _mm_ ## f
+#define _MMI(f) _mm_ ## f ## _si128
+#define _FN(f) f ## _sse
+#define _MM_END
+#define _CLMUL(a, b, i) _mm_clmulepi64_si128(a, b, i)
+#define _SET1_EPI64(c) _mm_cvtsi32_si128(c)
+#define _LOAD_CONSTS(s) _mm_load_si128((__m128i*)(s))
+
+#if defined(__PCLMUL__) && defined(__SSE2__)
+# define _AVAILABLE
+#endif
+#include "gf16_clmul_x86.h"
+#undef _AVAILABLE
+
+#undef MWORD_SIZE
+#undef _mword
+#undef _MM
+#undef _MMI
+#undef _FN
+#undef _MM_END
+#undef _CLMUL
+#undef _SET1_EPI64
+#undef _LOAD_CONSTS
+
+
+
+void* gf16_clmul_init(int polynomial) {
+	/* compute mu = floor(x^32 / polynomial) for Barrett reduction */
+	uint32_t mu = 0;
+	uint64_t rem = (uint64_t)1 << 32;
+	for(int i=16; i>=0; i--) {
+		if(rem & ((uint64_t)1 << (i+16))) {
+			mu |= 1 << i;
+			rem ^= (uint64_t)polynomial << i;
+		}
+	}
+	
+	uint64_t* ret;
+	ALIGN_ALLOC(ret, sizeof(uint64_t)*2, 16);
+	ret[0] = mu;
+	ret[1] = polynomial;
+	return ret;
+}
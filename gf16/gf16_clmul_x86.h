@@ -0,0 +1,168 @@
+
+#include "gf16_global.h"
+
+#ifdef _AVAILABLE
+int _FN(gf16_clmul_available) = 1;
+#else
+int _FN(gf16_clmul_available) = 0;
+#endif
+
+// number of sources accumulated before each reduction, by the multi-region kernel
+#define GF16_CLMUL_FANIN (MWORD_SIZE >= 64 ? 8 : 6)
+
+/*
+ * Data is kept in its natural layout; each 32-bit lane holds two words, which are split into even (low) and odd (high) words.
+ * Carry-less multiplying a 64-bit half of a vector by the coefficient gives two 31-bit products in 32-bit lanes, which never overlap, so these products can be XOR accumulated across sources, leaving a single reduction at the end.
+ * Reduction is Barrett style: for product p, q = ((p >> 16) * mu) >> 16, then p ^ q*poly is the remainder, where mu = x^32 / poly
+ * Only the low 64-bit half of each 128-bit lane of the accumulators/products is used.
+ */
+#ifdef _AVAILABLE
+typedef struct {
+	_mword lo0, lo1, hi0, hi1;
+} _FN(gf16_clmul_accum);
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_prod)(_mword data, _mword coeff, _FN(gf16_clmul_accum)* acc, int first) {
+	_mword even = _MMI(and)(data, _MM(set1_epi32)(0xffff));
+	_mword odd = _MM(srli_epi32)(data, 16);
+	_mword lo0 = _CLMUL(even, coeff, 0x00);
+	_mword lo1 = _CLMUL(even, coeff, 0x01);
+	_mword hi0 = _CLMUL(odd, coeff, 0x00);
+	_mword hi1 = _CLMUL(odd, coeff, 0x01);
+	if(first) {
+		acc->lo0 = lo0;
+		acc->lo1 = lo1;
+		acc->hi0 = hi0;
+		acc->hi1 = hi1;
+	} else {
+		acc->lo0 = _MMI(xor)(acc->lo0, lo0);
+		acc->lo1 = _MMI(xor)(acc->lo1, lo1);
+		acc->hi0 = _MMI(xor)(acc->hi0, hi0);
+		acc->hi1 = _MMI(xor)(acc->hi1, hi1);
+	}
+}
+
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_clmul_reduce1)(_mword prod, _mword consts) {
+	// consts holds mu in the low 64 bits, and the polynomial in the high 64 bits
+	_mword q = _CLMUL(_MM(srli_epi32)(prod, 16), consts, 0x00);
+	q = _CLMUL(_MM(srli_epi32)(q, 16), consts, 0x10);
+	return _MMI(xor)(prod, q);
+}
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_clmul_reduce)(_FN(gf16_clmul_accum)* acc, _mword consts) {
+	_mword lo = _MM(unpacklo_epi64)(
+		_FN(gf16_clmul_reduce1)(acc->lo0, consts),
+		_FN(gf16_clmul_reduce1)(acc->lo1, consts)
+	);
+	_mword hi = _MM(unpacklo_epi64)(
+		_FN(gf16_clmul_reduce1)(acc->hi0, consts),
+		_FN(gf16_clmul_reduce1)(acc->hi1, consts)
+	);
+	return _MMI(or)(lo, _MM(slli_epi32)(hi, 16));
+}
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_clmul_muladd_x)(
+	const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount, const uint8_t *HEDLEY_RESTRICT const* _src,
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
+) {
+	_mword consts = _LOAD_CONSTS(scratch);
+	_mword coeff[GF16_CLMUL_FANIN];
+	int i;
+	for(i=0; i<srcCount; i++)
+		coeff[i] = _SET1_EPI64(coefficients[i]);
+
+	for(long ptr = -(long)len; ptr; ptr += sizeof(_mword)) {
+		_FN(gf16_clmul_accum) acc;
+		_FN(gf16_clmul_prod)(_MMI(load)((_mword*)(_src[0] + ptr)), coeff[0], &acc, 1);
+		for(i=1; i<srcCount; i++)
+			_FN(gf16_clmul_prod)(_MMI(load)((_mword*)(_src[i] + ptr)), coeff[i], &acc, 0);
+
+		_mword result = _FN(gf16_clmul_reduce)(&acc, consts);
+		if(doAdd)
+			result = _MMI(xor)(result, _MMI(load)((_mword*)(_dst + ptr)));
+		_MMI(store)((_mword*)(_dst + ptr), result);
+	}
+}
+#endif /*defined(_AVAILABLE)*/
+
+
+void _FN(gf16_clmul_mul)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	const uint8_t* _src = (const uint8_t*)src + len;
+	_FN(gf16_clmul_muladd_x)(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 0);
+	_MM_END
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+void _FN(gf16_clmul_muladd)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	const uint8_t* _src = (const uint8_t*)src + len;
+	_FN(gf16_clmul_muladd_x)(scratch, (uint8_t*)dst + len, 1, &_src, len, &coefficient, 1);
+	_MM_END
+#else
+	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned _FN(gf16_clmul_muladd_multi_x)(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
+	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	const uint8_t* _src[GF16_CLMUL_FANIN];
+	
+	unsigned region = 0;
+	while(region+1 < regions) {
+		unsigned count = regions - region;
+		if(count > GF16_CLMUL_FANIN) count = GF16_CLMUL_FANIN;
+		for(unsigned i=0; i<count; i++)
+			_src[i] = (const uint8_t*)src[region+i] + offset + len;
+
+		#define _CASE(n) case n: _FN(gf16_clmul_muladd_x)(scratch, _dst, n, _src, len, coefficients + region, doAdd); break
+		switch(count) {
+#if GF16_CLMUL_FANIN >= 8
+			_CASE(8);
+			_CASE(7);
+#endif
+			_CASE(6);
+			_CASE(5);
+			_CASE(4);
+			_CASE(3);
+			_CASE(2);
+			default: break;
+		}
+		#undef _CASE
+		region += count;
+	}
+	return region;
+}
+#endif
+
+unsigned _FN(gf16_clmul_muladd_multi)(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	unsigned region = _FN(gf16_clmul_muladd_multi_x)(scratch, regions, offset, dst, src, len, coefficients, 1);
+	_MM_END
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned _FN(gf16_clmul_mul_multi)(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = _FN(gf16_clmul_muladd_multi_x)(scratch, (regions > GF16_CLMUL_FANIN ? GF16_CLMUL_FANIN : regions), offset, dst, src, len, coefficients, 0);
+	region += _FN(gf16_clmul_muladd_multi_x)(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_MM_END
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+#undef GF16_CLMUL_FANIN
@@ -0,0 +1,22 @@
+
+#include "platform.h"
+
+#define MWORD_SIZE 64
+#define _mword __m512i
+#define _MM(f) _mm512_ ## f
+#define _MMI(f) _mm512_ ## f ## _si512
+#define _FN(f) f ## _avx512
+#define _MM_END
+
+#if defined(__AVX512F__)
+# define _AVAILABLE
+#endif
+#include "gf16_lookup_gather_x86.h"
+#undef _AVAILABLE
+
+#undef MWORD_SIZE
+#undef _mword
+#undef _MM
+#undef _MMI
+#undef _FN
+#undef _MM_END
@@ -0,0 +1,78 @@
+
+#include "gf16_global.h"
+
+#ifdef _AVAILABLE
+int _FN(gf16_lookup_available) = 1;
+#else
+int _FN(gf16_lookup_available) = 0;
+#endif
+
+#ifdef _AVAILABLE
+# include "gf16_lookup_table_sse2.h"
+
+#if MWORD_SIZE == 64
+# define _GATHER(idx) _mm512_i32gather_epi32(idx, (const int*)lhtable, 2)
+#else
+# define _GATHER(idx) _mm256_i32gather_epi32((const int*)lhtable, idx, 2)
+#endif
+
+/*
+ * Same split 2x 8-bit table as the scalar/SSE2 lookup, but entries are fetched with gathers instead of inserts
+ * Each 32-bit lane holds two words; one gather per byte position fetches the table entry (plus the next, which is discarded) for every lane at once
+ */
+static HEDLEY_ALWAYS_INLINE _mword _FN(gf16_lookup_gather)(const uint16_t* lhtable, _mword data) {
+	_mword mask = _MM(set1_epi32)(0xff);
+	_mword hiOffset = _MM(set1_epi32)(256);
+	
+	_mword lo1 = _GATHER(_MMI(and)(data, mask));
+	_mword hi1 = _GATHER(_MM(add_epi32)(_MMI(and)(_MM(srli_epi32)(data, 8), mask), hiOffset));
+	_mword lo2 = _GATHER(_MMI(and)(_MM(srli_epi32)(data, 16), mask));
+	_mword hi2 = _GATHER(_MM(add_epi32)(_MM(srli_epi32)(data, 24), hiOffset));
+	
+	// low word of each lane comes from the first pair, the high word from the second
+	_mword res1 = _MMI(and)(_MMI(xor)(lo1, hi1), _MM(set1_epi32)(0xffff));
+	_mword res2 = _MM(slli_epi32)(_MMI(xor)(lo2, hi2), 16);
+	return _MMI(or)(res1, res2);
+}
+#undef _GATHER
+#endif /*defined(_AVAILABLE)*/
+
+
+void _FN(gf16_lookup_mul)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(scratch); UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	ALIGN_TO(16, uint16_t lhtable[513]); // +1 as gathers read 32 bits
+	calc_table(coefficient, lhtable);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr+=sizeof(_mword)) {
+		_mword res = _FN(gf16_lookup_gather)(lhtable, _MMI(load)((_mword*)(_src+ptr)));
+		_MMI(store)((_mword*)(_dst+ptr), res);
+	}
+	_MM_END
+#else
+	UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
+
+void _FN(gf16_lookup_muladd)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(scratch); UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	ALIGN_TO(16, uint16_t lhtable[513]);
+	calc_table(coefficient, lhtable);
+	
+	uint8_t* _src = (uint8_t*)src + len;
+	uint8_t* _dst = (uint8_t*)dst + len;
+	
+	for(long ptr = -(long)len; ptr; ptr+=sizeof(_mword)) {
+		_mword res = _FN(gf16_lookup_gather)(lhtable, _MMI(load)((_mword*)(_src+ptr)));
+		res = _MMI(xor)(res, _MMI(load)((_mword*)(_dst+ptr)));
+		_MMI(store)((_mword*)(_dst+ptr), res);
+	}
+	_MM_END
+#else
+	UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient);
+#endif
+}
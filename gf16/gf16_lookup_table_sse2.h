@@ -0,0 +1,66 @@
+#include "gf16_global.h"
+#include "platform.h"
+
+// builds the split 2x 8-bit lookup table (512 entries) for a coefficient; shared by the SSE2 and gather lookup methods
+#ifdef __SSE2__
+static HEDLEY_ALWAYS_INLINE void calc_table(uint16_t val, uint16_t* lhtable) {
+	int j, k;
+	__m128i* _lhtable = (__m128i*)lhtable;
+	
+	int val2 = GF16_MULTBY_TWO(val);
+	int val4 = GF16_MULTBY_TWO(val2);
+	__m128i tmp0 = _mm_cvtsi32_si128(val << 16);
+	tmp0 = _mm_insert_epi16(tmp0, val2, 2);
+	tmp0 = _mm_insert_epi16(tmp0, val2 ^ val, 3);
+	
+	__m128i vval4 = _mm_set1_epi16(val4);
+	tmp0 = _mm_unpacklo_epi64(tmp0, _mm_xor_si128(tmp0, vval4));
+	
+	_mm_store_si128(_lhtable, tmp0);
+	
+	__m128i poly = _mm_set1_epi16(GF16_POLYNOMIAL & 0xffff);
+	#define MUL2(x) _mm_xor_si128( \
+		_mm_add_epi16(x, x), \
+		_mm_and_si128(poly, _mm_cmpgt_epi16( \
+			_mm_setzero_si128(), x \
+		)) \
+	)
+	__m128i mul = MUL2(vval4); // *8
+	
+	__m128i tmp8 = _mm_xor_si128(tmp0, mul);
+	_mm_store_si128(_lhtable+1, tmp8);
+	
+	mul = MUL2(mul); // *16
+	for(j = 2; j < 32; j <<= 1) {
+		// save a few reads by having the first 2 values cached in registers
+		_mm_store_si128(_lhtable + j, _mm_xor_si128(mul, tmp0));
+		_mm_store_si128(_lhtable + j + 1, _mm_xor_si128(mul, tmp8));
+		// loop over rest
+		for(k = 2; k < j; k++)
+			_mm_store_si128(_lhtable + j + k, _mm_xor_si128(mul, _mm_load_si128(_lhtable + k)));
+		mul = MUL2(mul);
+	}
+	
+	__m128i tmp256 = _mm_slli_epi32(mul, 16); // [*0, *256, *0, *256 ...]
+	mul = MUL2(mul); // *512
+	tmp256 = _mm_xor_si128(tmp256, _mm_slli_epi64(mul, 32)); // [*0, *256, *512, *768, *0, *256, *512, *768]
+	mul = MUL2(mul); // *1024
+	tmp256 = _mm_xor_si128(tmp256, _mm_slli_si128(mul, 8)); // [*0, *256, *512 ...]
+	_mm_store_si128(_lhtable + 32, tmp256);
+	
+	mul = MUL2(mul); // *2048
+	__m128i tmp2048 = _mm_xor_si128(tmp256, mul);
+	_mm_store_si128(_lhtable + 32+1, tmp2048);
+	
+	mul = MUL2(mul); // *4096
+	for(j = 2; j < 32; j <<= 1) {
+		_mm_store_si128(_lhtable + 32 + j, _mm_xor_si128(mul, tmp256));
+		_mm_store_si128(_lhtable + 32 + j + 1, _mm_xor_si128(mul, tmp2048));
+		for(k = 2; k < j; k++)
+			_mm_store_si128(_lhtable + 32 + j + k, _mm_xor_si128(mul, _mm_load_si128(_lhtable + 32 + k)));
+		mul = MUL2(mul);
+	}
+	
+	#undef MUL2
+}
+#endif
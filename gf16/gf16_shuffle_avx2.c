@@ -18,9 +18,8 @@
 
 
 
-unsigned gf16_shuffle2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
 #if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_shuffle2x_muladd_multi_x_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	__m256i mask = _mm256_set1_epi8(0x0f);
 	__m256i polyl = _mm256_broadcastsi128_si256(_mm_load_si128((__m128i*)scratch + 1));
@@ -88,7 +87,8 @@ unsigned gf16_shuffle2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, u
 			swapped = _mm256_xor_si256(_mm256_shuffle_epi8(shufSwapHiA, ti), swapped);
 			result = _mm256_xor_si256(_mm256_shuffle_epi8(shufNormHiA, ti), result);
 			
-			result = _mm256_xor_si256(result, _mm256_load_si256((__m256i*)(_dst+ptr)));
+			if(doAdd)
+				result = _mm256_xor_si256(result, _mm256_load_si256((__m256i*)(_dst+ptr)));
 			data = _mm256_load_si256((__m256i*)(_src2+ptr));
 			
 			ti = _mm256_and_si256(mask, data);
@@ -105,6 +105,14 @@ unsigned gf16_shuffle2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, u
 			_mm256_store_si256((__m256i*)(_dst+ptr), result);
 		}
 	}
+	return region;
+}
+#endif
+
+unsigned gf16_shuffle2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_shuffle2x_muladd_multi_x_avx2(scratch, regions, offset, dst, src, len, coefficients, 1);
 	_mm256_zeroupper();
 	return region;
 #else
@@ -113,6 +121,20 @@ unsigned gf16_shuffle2x_muladd_multi_avx2(const void *HEDLEY_RESTRICT scratch, u
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_shuffle2x_mul_multi_avx2(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_shuffle2x_muladd_multi_x_avx2(scratch, 2, offset, dst, src, len, coefficients, 0);
+	region += gf16_shuffle2x_muladd_multi_x_avx2(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 
 
 
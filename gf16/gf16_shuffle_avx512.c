@@ -114,7 +114,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_avx512_round(
 static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_avx512(
 	__m512i polyl, __m512i polyh, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
 	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4, size_t len,
-	const uint16_t *HEDLEY_RESTRICT coefficients
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m512i lowA0, lowA1, lowA2, lowA3, highA0, highA1, highA2, highA3;
 	__m512i lowB0, lowB1, lowB2, lowB3, highB0, highB1, highB2, highB3;
@@ -168,8 +168,14 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_avx512(
 	
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m512i)*2) {
-		__m512i tph = _mm512_load_si512((__m512i*)(_dst+ptr));
-		__m512i tpl = _mm512_load_si512((__m512i*)(_dst+ptr) + 1);
+		__m512i tph, tpl;
+		if(doAdd) {
+			tph = _mm512_load_si512((__m512i*)(_dst+ptr));
+			tpl = _mm512_load_si512((__m512i*)(_dst+ptr) + 1);
+		} else {
+			tph = _mm512_setzero_si512();
+			tpl = _mm512_setzero_si512();
+		}
 		gf16_shuffle_avx512_round((__m512i*)(_src1+ptr), &tpl, &tph, lowA0, highA0, lowA1, highA1, lowA2, highA2, lowA3, highA3);
 		gf16_shuffle_avx512_round((__m512i*)(_src2+ptr), &tpl, &tph, lowB0, highB0, lowB1, highB1, lowB2, highB2, lowB3, highB3);
 		if(srcCount >= 3)
@@ -182,9 +188,8 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_avx512(
 }
 #endif // defined(_AVAILABLE)
 
-unsigned gf16_shuffle_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
 #if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_shuffle_muladd_multi_x_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	__m512i polyl = _mm512_broadcast_i32x4(_mm_load_si128((__m128i*)scratch + 1));
 	__m512i polyh = _mm512_broadcast_i32x4(_mm_load_si128((__m128i*)scratch));
@@ -195,7 +200,7 @@ unsigned gf16_shuffle_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, u
 			polyl, polyh, _dst, 3,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 			NULL,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 3;
 	} while(region+2 < regions);
@@ -204,11 +209,19 @@ unsigned gf16_shuffle_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, u
 			polyl, polyh, _dst, 2,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
 			NULL, NULL,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 2;
 	}
 	
+	return region;
+}
+#endif
+
+unsigned gf16_shuffle_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_shuffle_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, 1);
 	_mm256_zeroupper();
 	return region;
 #else
@@ -217,6 +230,20 @@ unsigned gf16_shuffle_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, u
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_shuffle_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_shuffle_muladd_multi_x_avx512(scratch, (regions > 2 ? 3 : 2), offset, dst, src, len, coefficients, 0);
+	region += gf16_shuffle_muladd_multi_x_avx512(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 
 #if defined(_AVAILABLE)
 static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_avx512_round1(
@@ -263,7 +290,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_avx512_round(
 static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx512(
 	__m512i polyl, __m512i polyh, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
 	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4, const uint8_t *HEDLEY_RESTRICT _src5, const uint8_t *HEDLEY_RESTRICT _src6, size_t len,
-	const uint16_t *HEDLEY_RESTRICT coefficients
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m512i shufNormLoA, shufNormHiA, shufSwapLoA, shufSwapHiA;
 	__m512i shufNormLoB, shufNormHiB, shufSwapLoB, shufSwapHiB;
@@ -337,7 +364,7 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx512(
 	#undef JOIN_VEC
 	
 	for(long ptr = -(long)len; ptr; ptr += sizeof(__m512i)) {
-		__m512i swapped, result = _mm512_load_si512((__m512i*)(_dst+ptr));
+		__m512i swapped, result = doAdd ? _mm512_load_si512((__m512i*)(_dst+ptr)) : _mm512_setzero_si512();
 		gf16_shuffle2x_avx512_round1((__m512i*)(_src1+ptr), &result, &swapped, shufNormLoA, shufNormHiA, shufSwapLoA, shufSwapHiA);
 		gf16_shuffle2x_avx512_round((__m512i*)(_src2+ptr), &result, &swapped, shufNormLoB, shufNormHiB, shufSwapLoB, shufSwapHiB);
 		if(srcCount >= 3)
@@ -358,9 +385,8 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle2x_muladd_x_avx512(
 #endif // defined(_AVAILABLE)
 
 
-unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
 #if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_shuffle2x_muladd_multi_x_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	__m512i polyl = _mm512_broadcast_i32x4(_mm_load_si128((__m128i*)scratch + 1));
 	__m512i polyh = _mm512_broadcast_i32x4(_mm_load_si128((__m128i*)scratch));
@@ -375,7 +401,7 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 			(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len,
 			(const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len,
 			(const uint8_t* HEDLEY_RESTRICT)src[region+5] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 6;
 	} while(region+5 < regions);
@@ -389,7 +415,7 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+4] + offset + len,
 				NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 5;
 		break;
@@ -401,7 +427,7 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len,
 				NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 4;
 		break;
@@ -412,7 +438,7 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len,
 				NULL, NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 3;
 		break;
@@ -422,12 +448,20 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 				(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len,
 				(const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
 				NULL, NULL, NULL, NULL,
-				len, coefficients + region
+				len, coefficients + region, doAdd
 			);
 			region += 2;
 		break;
 		default: break;
 	}
+	return region;
+}
+#endif
+
+unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_shuffle2x_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, 1);
 	_mm256_zeroupper();
 	return region;
 #else
@@ -436,6 +470,20 @@ unsigned gf16_shuffle2x_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch,
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_shuffle2x_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_shuffle2x_muladd_multi_x_avx512(scratch, (regions > 6 ? 6 : regions), offset, dst, src, len, coefficients, 0);
+	region += gf16_shuffle2x_muladd_multi_x_avx512(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 
 #undef _AVAILABLE
 
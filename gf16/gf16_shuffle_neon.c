@@ -208,7 +208,7 @@ void gf16_shuffle_muladd_neon(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_
 static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x2_neon(
 	uint8x16x2_t poly,
 	uint8_t *HEDLEY_RESTRICT _dst, const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, size_t len,
-	const uint16_t *HEDLEY_RESTRICT coefficients
+	const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	qtbl_t tbl_Ah[4], tbl_Al[4];
 	qtbl_t tbl_Bh[4], tbl_Bl[4];
@@ -219,9 +219,15 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x2_neon(
 		uint8x16_t rl, rh;
 		gf16_shuffle_neon_round1(_src1+ptr, &rl, &rh, tbl_Al, tbl_Ah);
 		gf16_shuffle_neon_round(_src2+ptr, &rl, &rh, tbl_Bl, tbl_Bh);
-		uint8x16x2_t vb = vld2q_u8(_dst+ptr);
-		vb.val[0] = veorq_u8(rl, vb.val[0]);
-		vb.val[1] = veorq_u8(rh, vb.val[1]);
+		uint8x16x2_t vb;
+		if(doAdd) {
+			vb = vld2q_u8(_dst+ptr);
+			vb.val[0] = veorq_u8(rl, vb.val[0]);
+			vb.val[1] = veorq_u8(rh, vb.val[1]);
+		} else {
+			vb.val[0] = rl;
+			vb.val[1] = rh;
+		}
 		vst2q_u8(_dst+ptr, vb);
 	}
 }
@@ -282,7 +288,7 @@ unsigned gf16_shuffle_muladd_multi_neon(const void *HEDLEY_RESTRICT scratch, uns
 		gf16_shuffle_muladd_x2_neon(
 			poly, _dst,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, 1
 		);
 	}
 	
@@ -293,6 +299,22 @@ unsigned gf16_shuffle_muladd_multi_neon(const void *HEDLEY_RESTRICT scratch, uns
 #endif
 }
 
+// as above, but the first pair overwrites the destination instead of adding to it
+unsigned gf16_shuffle_mul_multi_neon(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__ARM_NEON) && defined(__aarch64__)
+	if(regions < 2) return 0;
+	gf16_shuffle_muladd_x2_neon(
+		vld1q_u8_x2_align(scratch), (uint8_t*)dst + offset + len,
+		(const uint8_t* HEDLEY_RESTRICT)src[0] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[1] + offset + len,
+		len, coefficients, 0
+	);
+	return 2 + gf16_shuffle_muladd_multi_neon(scratch, regions-2, offset, dst, src+2, len, coefficients+2, mutScratch);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 
 
 void* gf16_shuffle_init_arm(int polynomial) {
@@ -374,7 +374,7 @@ void gf16_shuffle_muladd_vbmi(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_
 static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_vbmi(
 	__m512i mulLo, __m512i mulHi, uint8_t *HEDLEY_RESTRICT _dst, const int srcCount,
 	const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, const uint8_t *HEDLEY_RESTRICT _src3, const uint8_t *HEDLEY_RESTRICT _src4,
-	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients
+	size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd
 ) {
 	__m512i loA0, loA1, loA2, hiA0, hiA1, hiA2;
 	__m512i loB0, loB1, loB2, hiB0, hiB1, hiB2;
@@ -412,8 +412,13 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_vbmi(
 			&tpl, &tph, &tl, &th
 		);
 		
-		tph = _mm512_ternarylogic_epi32(tph, th, _mm512_load_si512((__m512i*)(_dst+ptr)), 0x96);
-		tpl = _mm512_ternarylogic_epi32(tpl, tl, _mm512_load_si512((__m512i*)(_dst+ptr) + 1), 0x96);
+		if(doAdd) {
+			tph = _mm512_ternarylogic_epi32(tph, th, _mm512_load_si512((__m512i*)(_dst+ptr)), 0x96);
+			tpl = _mm512_ternarylogic_epi32(tpl, tl, _mm512_load_si512((__m512i*)(_dst+ptr) + 1), 0x96);
+		} else {
+			tph = _mm512_xor_si512(tph, th);
+			tpl = _mm512_xor_si512(tpl, tl);
+		}
 		
 		if(srcCount > 2) {
 			gf16_shuffle_mul_vbmi_round_merge(
@@ -469,9 +474,8 @@ static HEDLEY_ALWAYS_INLINE void gf16_shuffle_muladd_x_vbmi(
 }
 #endif
 
-unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
 #if defined(__AVX512VBMI__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE unsigned gf16_shuffle_muladd_multi_x_vbmi(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
 	uint8_t* _dst = (uint8_t*)dst + offset + len;
 	__m512i mulLo = _mm512_load_si512((__m512i*)scratch + 1);
 	__m512i mulHi = _mm512_load_si512((__m512i*)scratch);
@@ -481,7 +485,7 @@ unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, uns
 		gf16_shuffle_muladd_x_vbmi(
 			mulLo, mulHi, _dst, 4,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+3] + offset + len,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 4;
 	} while(region+3 < regions);
@@ -489,7 +493,7 @@ unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, uns
 		gf16_shuffle_muladd_x_vbmi(
 			mulLo, mulHi, _dst, 3,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+2] + offset + len, NULL,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 3;
 	}
@@ -497,11 +501,19 @@ unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, uns
 		gf16_shuffle_muladd_x_vbmi(
 			mulLo, mulHi, _dst, 2,
 			(const uint8_t* HEDLEY_RESTRICT)src[region] + offset + len, (const uint8_t* HEDLEY_RESTRICT)src[region+1] + offset + len, NULL, NULL,
-			len, coefficients + region
+			len, coefficients + region, doAdd
 		);
 		region += 2;
 	}
 	
+	return region;
+}
+#endif
+
+unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(__AVX512VBMI__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	unsigned region = gf16_shuffle_muladd_multi_x_vbmi(scratch, regions, offset, dst, src, len, coefficients, 1);
 	_mm256_zeroupper();
 	return region;
 #else
@@ -510,6 +522,20 @@ unsigned gf16_shuffle_muladd_multi_vbmi(const void *HEDLEY_RESTRICT scratch, uns
 #endif
 }
 
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_shuffle_mul_multi_vbmi(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX512VBMI__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	unsigned region = gf16_shuffle_muladd_multi_x_vbmi(scratch, (regions > 4 ? 4 : regions), offset, dst, src, len, coefficients, 0);
+	region += gf16_shuffle_muladd_multi_x_vbmi(scratch, regions-region, offset, dst, src+region, len, coefficients+region, 1);
+	_mm256_zeroupper();
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
 
 void* gf16_shuffle_init_vbmi(int polynomial) {
 #if defined(__AVX512VBMI__) && defined(__AVX512VL__)
@@ -104,12 +104,9 @@ static HEDLEY_ALWAYS_INLINE __m256i mul16_vec256(__m256i poly, __m256i src) {
 #endif
 
 
-void _FN(gf16_shuffle_mul)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
-	UNUSED(mutScratch);
 #ifdef _AVAILABLE
-	_mword low0, low1, low2, low3, high0, high1, high2, high3;
-	_mword ta, tb, ti, tpl, tph;
-	
+// computes the lookup tables for multiplying by a coefficient
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_calc_table(const void *HEDLEY_RESTRICT scratch, uint16_t val, _mword* low0, _mword* high0, _mword* low1, _mword* high1, _mword* low2, _mword* high2, _mword* low3, _mword* high3) {
 	__m128i pd0, pd1;
 	shuf0_vector(val, &pd0, &pd1);
 	
@@ -121,32 +118,42 @@ void _FN(gf16_shuffle_mul)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RES
 		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200
 	));
 	prod = _mm256_permute4x64_epi64(prod, _MM_SHUFFLE(2,0,3,1));
-	low0  = BCAST_HI(prod);
-	high0 = BCAST_LO(prod);
-
+	*low0  = BCAST_HI(prod);
+	*high0 = BCAST_LO(prod);
+	
 	prod = mul16_vec256(poly, prod);
-	low1  = BCAST_HI(prod);
-	high1 = BCAST_LO(prod);
+	*low1  = BCAST_HI(prod);
+	*high1 = BCAST_LO(prod);
 	
 	prod = mul16_vec256(poly, prod);
-	low2  = BCAST_HI(prod);
-	high2 = BCAST_LO(prod);
+	*low2  = BCAST_HI(prod);
+	*high2 = BCAST_LO(prod);
 	
 	prod = mul16_vec256(poly, prod);
-	low3  = BCAST_HI(prod);
-	high3 = BCAST_LO(prod);
+	*low3  = BCAST_HI(prod);
+	*high3 = BCAST_LO(prod);
 #else
 	pd0 = _mm_shuffle_epi8(pd0, _mm_set_epi32(0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200));
 	pd1 = _mm_shuffle_epi8(pd1, _mm_set_epi32(0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200));
-	low0  = _mm_unpacklo_epi64(pd0, pd1);
-	high0 = _mm_unpackhi_epi64(pd0, pd1);
+	*low0  = _mm_unpacklo_epi64(pd0, pd1);
+	*high0 = _mm_unpackhi_epi64(pd0, pd1);
 	
 	__m128i polyl = _mm_load_si128((__m128i*)scratch + 1);
 	__m128i polyh = _mm_load_si128((__m128i*)scratch);
-	mul16_vec128(polyl, polyh, low0, high0, &low1, &high1);
-	mul16_vec128(polyl, polyh, low1, high1, &low2, &high2);
-	mul16_vec128(polyl, polyh, low2, high2, &low3, &high3);
+	mul16_vec128(polyl, polyh, *low0, *high0, low1, high1);
+	mul16_vec128(polyl, polyh, *low1, *high1, low2, high2);
+	mul16_vec128(polyl, polyh, *low2, *high2, low3, high3);
 #endif
+}
+#endif
+
+void _FN(gf16_shuffle_mul)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	_mword low0, low1, low2, low3, high0, high1, high2, high3;
+	_mword ta, tb, ti, tpl, tph;
+	
+	gf16_shuffle_calc_table(scratch, val, &low0, &high0, &low1, &high1, &low2, &high2, &low3, &high3);
 	
 	_mword mask = _MM(set1_epi8) (0x0f);
 	uint8_t* _src = (uint8_t*)src + len;
@@ -193,43 +200,7 @@ void _FN(gf16_shuffle_muladd)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_
 	_mword low0, low1, low2, low3, high0, high1, high2, high3;
 	_mword ta, tb, ti, tpl, tph;
 	
-	__m128i pd0, pd1;
-	shuf0_vector(val, &pd0, &pd1);
-	
-#if MWORD_SIZE >= 32
-	__m256i poly = _mm256_load_si256((__m256i*)scratch);
-	__m256i prod = _mm256_inserti128_si256(_mm256_castsi128_si256(pd0), pd1, 1);
-	prod = _mm256_shuffle_epi8(prod, _mm256_set_epi32(
-		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200,
-		0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200
-	));
-	prod = _mm256_permute4x64_epi64(prod, _MM_SHUFFLE(2,0,3,1));
-	low0  = BCAST_HI(prod);
-	high0 = BCAST_LO(prod);
-	
-	prod = mul16_vec256(poly, prod);
-	low1  = BCAST_HI(prod);
-	high1 = BCAST_LO(prod);
-	
-	prod = mul16_vec256(poly, prod);
-	low2  = BCAST_HI(prod);
-	high2 = BCAST_LO(prod);
-	
-	prod = mul16_vec256(poly, prod);
-	low3  = BCAST_HI(prod);
-	high3 = BCAST_LO(prod);
-#else
-	pd0 = _mm_shuffle_epi8(pd0, _mm_set_epi32(0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200));
-	pd1 = _mm_shuffle_epi8(pd1, _mm_set_epi32(0x0f0d0b09, 0x07050301, 0x0e0c0a08, 0x06040200));
-	low0  = _mm_unpacklo_epi64(pd0, pd1);
-	high0 = _mm_unpackhi_epi64(pd0, pd1);
-	
-	__m128i polyl = _mm_load_si128((__m128i*)scratch + 1);
-	__m128i polyh = _mm_load_si128((__m128i*)scratch);
-	mul16_vec128(polyl, polyh, low0, high0, &low1, &high1);
-	mul16_vec128(polyl, polyh, low1, high1, &low2, &high2);
-	mul16_vec128(polyl, polyh, low2, high2, &low3, &high3);
-#endif
+	gf16_shuffle_calc_table(scratch, val, &low0, &high0, &low1, &high1, &low2, &high2, &low3, &high3);
 	
 	_mword mask = _MM(set1_epi8) (0x0f);
 	uint8_t* _src = (uint8_t*)src + len;
@@ -278,3 +249,143 @@ void _FN(gf16_shuffle_muladd)(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_
 #endif
 }
 
+void _FN(gf16_shuffle_powadd)(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t val, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#ifdef _AVAILABLE
+	_mword low0, low1, low2, low3, high0, high1, high2, high3;
+	_mword ta, tb, ti, tpl, tph;
+	
+	gf16_shuffle_calc_table(scratch, val, &low0, &high0, &low1, &high1, &low2, &high2, &low3, &high3);
+	
+	_mword mask = _MM(set1_epi8) (0x0f);
+	uint8_t* _src = (uint8_t*)src + offset + len;
+
+	for(long ptr = -(long)len; ptr; ptr += sizeof(_mword)*2) {
+		ta = _MMI(load)((_mword*)(_src+ptr));
+		tb = _MMI(load)((_mword*)(_src+ptr) + 1);
+		
+		// each output's product is the source for the next
+		for(unsigned output = 0; output < outputs; output++) {
+			ti = _MMI(and) (mask, tb);
+			tph = _MM(shuffle_epi8) (high0, ti);
+			tpl = _MM(shuffle_epi8) (low0, ti);
+
+			ti = _MM_SRLI4_EPI8(tb);
+#if MWORD_SIZE == 64
+			_mword ti2 = _MMI(and) (mask, ta);
+			tpl = _mm512_ternarylogic_epi32(tpl, _MM(shuffle_epi8) (low1, ti), _MM(shuffle_epi8) (low2, ti2), 0x96);
+			tph = _mm512_ternarylogic_epi32(tph, _MM(shuffle_epi8) (high1, ti), _MM(shuffle_epi8) (high2, ti2), 0x96);
+#else
+			tpl = _MMI(xor)(_MM(shuffle_epi8) (low1, ti), tpl);
+			tph = _MMI(xor)(_MM(shuffle_epi8) (high1, ti), tph);
+
+			ti = _MMI(and) (mask, ta);
+			tpl = _MMI(xor)(_MM(shuffle_epi8) (low2, ti), tpl);
+			tph = _MMI(xor)(_MM(shuffle_epi8) (high2, ti), tph);
+#endif
+			ti = _MM_SRLI4_EPI8(ta);
+			tpl = _MMI(xor)(_MM(shuffle_epi8) (low3, ti), tpl);
+			tph = _MMI(xor)(_MM(shuffle_epi8) (high3, ti), tph);
+			
+			_mword* _dst = (_mword*)((uint8_t*)dst[output] + offset + len + ptr);
+			_MMI(store) (_dst, _MMI(xor)(tph, _MMI(load)(_dst)));
+			_MMI(store) (_dst + 1, _MMI(xor)(tpl, _MMI(load)(_dst + 1)));
+			ta = tph;
+			tb = tpl;
+		}
+	}
+	_MM_END
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(val);
+#endif
+}
+
+
+
+#if MWORD_SIZE != 64
+// AVX512 has its own version, which makes use of the additional registers
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE void gf16_shuffle_round(const _mword* src, _mword* tpl, _mword* tph, const _mword* table) {
+	_mword mask = _MM(set1_epi8) (0x0f);
+	_mword ta = _MMI(load)(src);
+	_mword tb = _MMI(load)(src + 1);
+	
+	_mword ti = _MMI(and) (mask, tb);
+	*tph = _MMI(xor)(_MM(shuffle_epi8) (table[1], ti), *tph);
+	*tpl = _MMI(xor)(_MM(shuffle_epi8) (table[0], ti), *tpl);
+	
+	ti = _MM_SRLI4_EPI8(tb);
+	*tpl = _MMI(xor)(_MM(shuffle_epi8) (table[2], ti), *tpl);
+	*tph = _MMI(xor)(_MM(shuffle_epi8) (table[3], ti), *tph);
+	
+	ti = _MMI(and) (mask, ta);
+	*tpl = _MMI(xor)(_MM(shuffle_epi8) (table[4], ti), *tpl);
+	*tph = _MMI(xor)(_MM(shuffle_epi8) (table[5], ti), *tph);
+	
+	ti = _MM_SRLI4_EPI8(ta);
+	*tpl = _MMI(xor)(_MM(shuffle_epi8) (table[6], ti), *tpl);
+	*tph = _MMI(xor)(_MM(shuffle_epi8) (table[7], ti), *tph);
+}
+
+static HEDLEY_ALWAYS_INLINE void _FN(gf16_shuffle_muladd2_x)(const void *HEDLEY_RESTRICT scratch, uint8_t *HEDLEY_RESTRICT _dst, const uint8_t *HEDLEY_RESTRICT _src1, const uint8_t *HEDLEY_RESTRICT _src2, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, const int doAdd) {
+	_mword table1[8], table2[8];
+	gf16_shuffle_calc_table(scratch, coefficients[0], table1, table1+1, table1+2, table1+3, table1+4, table1+5, table1+6, table1+7);
+	gf16_shuffle_calc_table(scratch, coefficients[1], table2, table2+1, table2+2, table2+3, table2+4, table2+5, table2+6, table2+7);
+	
+	for(long ptr = -(long)len; ptr; ptr += sizeof(_mword)*2) {
+		_mword tph, tpl;
+		if(doAdd) {
+			tph = _MMI(load)((_mword*)(_dst+ptr));
+			tpl = _MMI(load)((_mword*)(_dst+ptr) + 1);
+		} else {
+			tph = _MMI(setzero)();
+			tpl = _MMI(setzero)();
+		}
+		gf16_shuffle_round((_mword*)(_src1+ptr), &tpl, &tph, table1);
+		gf16_shuffle_round((_mword*)(_src2+ptr), &tpl, &tph, table2);
+		_MMI(store) ((_mword*)(_dst+ptr), tph);
+		_MMI(store) ((_mword*)(_dst+ptr) + 1, tpl);
+	}
+}
+#endif
+
+// processes two sources per pass over the destination, halving loads/stores to it
+// with 16 registers, the 16 lookup tables don't all fit alongside the working set, so some get reloaded from the stack; adding a third source makes this spilling outweigh the saving
+unsigned _FN(gf16_shuffle_muladd_multi)(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+	UNUSED(mutScratch);
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	uint8_t* _dst = (uint8_t*)dst + offset + len;
+	
+	unsigned region = 0;
+	for(; region < (regions & ~1); region += 2) {
+		_FN(gf16_shuffle_muladd2_x)(
+			scratch, _dst,
+			(const uint8_t*)src[region] + offset + len, (const uint8_t*)src[region+1] + offset + len,
+			len, coefficients + region, 1
+		);
+	}
+	
+	_MM_END
+	return region;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	return 0;
+#endif
+}
+
+// as above, but the first pair overwrites the destination instead of adding to it
+unsigned _FN(gf16_shuffle_mul_multi)(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(_AVAILABLE) && defined(PLATFORM_AMD64)
+	if(regions < 2) return 0;
+	_FN(gf16_shuffle_muladd2_x)(
+		scratch, (uint8_t*)dst + offset + len,
+		(const uint8_t*)src[0] + offset + len, (const uint8_t*)src[1] + offset + len,
+		len, coefficients, 0
+	);
+	return 2 + _FN(gf16_shuffle_muladd_multi)(scratch, regions-2, offset, dst, src+2, len, coefficients+2, mutScratch);
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+#endif
@@ -1,6 +1,8 @@
 
 #include "../src/hedley.h"
 
+#define GF16_XOR_JIT_CACHE_SLOTS 256 // generated routines cached per thread
+
 #define FUNCS(v) \
 	void* gf16_xor_jit_init_##v(int polynomial); \
 	void* gf16_xor_jit_init_mut_##v(); \
@@ -8,6 +10,7 @@
 	void gf16_xor_finish_##v(void *HEDLEY_RESTRICT dst, size_t len); \
 	void gf16_xor_jit_mul_##v(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch); \
 	void gf16_xor_jit_muladd_##v(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch); \
+	void gf16_xor_jit_powadd_##v(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch); \
 	extern int gf16_xor_available_##v
 
 FUNCS(sse2);
@@ -17,6 +20,7 @@ FUNCS(avx512);
 #undef FUNCS
 
 unsigned gf16_xor_jit_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
+unsigned gf16_xor_jit_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 
 void gf16_xor_jit_uninit(void* scratch);
 void gf16_xor_jit_uninit_avx512(void* scratch);
@@ -416,16 +416,19 @@ static inline void xor_write_jit_avx(const struct gf16_xor_scratch *HEDLEY_RESTR
 void gf16_xor_jit_mul_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #if defined(__AVX2__) && defined(PLATFORM_AMD64)
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
-	
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MUL, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-	xor_write_jit_avx(info, mutScratch, coefficient, 0);
+		xor_write_jit_avx(info, jitWrite, coefficient, 0);
+	}
 	gf16_xor256_jit_stub(
 		(intptr_t)src - 384,
 		(intptr_t)dst + len - 384,
 		(intptr_t)dst - 384,
-		mutScratch
+		jitCode
 	);
 	
 	_mm256_zeroupper();
@@ -437,16 +440,19 @@ void gf16_xor_jit_mul_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RES
 void gf16_xor_jit_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #if defined(__AVX2__) && defined(PLATFORM_AMD64)
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
-	
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MULADD, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-	xor_write_jit_avx(info, mutScratch, coefficient, 1);
+		xor_write_jit_avx(info, jitWrite, coefficient, 1);
+	}
 	gf16_xor256_jit_stub(
 		(intptr_t)src - 384,
 		(intptr_t)dst + len - 384,
 		(intptr_t)dst - 384,
-		mutScratch
+		jitCode
 	);
 	
 	_mm256_zeroupper();
@@ -455,6 +461,28 @@ void gf16_xor_jit_muladd_avx2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_
 #endif
 }
 
+void gf16_xor_jit_powadd_avx2(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX2__) && defined(PLATFORM_AMD64)
+	// the routine for the coefficient only needs to be generated once; products are chained through a pair of buffers which stay in L1, each being added to its destination as it's generated
+	ALIGN_TO(32, uint8_t chain[2][XORDEP_JIT_POW_BLOCK]);
+	for(size_t pos = 0; pos < len; pos += XORDEP_JIT_POW_BLOCK) {
+		size_t blockLen = len - pos < XORDEP_JIT_POW_BLOCK ? len - pos : XORDEP_JIT_POW_BLOCK;
+		const uint8_t* prev = (const uint8_t*)src + offset + pos;
+		for(unsigned output = 0; output < outputs; output++) {
+			uint8_t* cur = chain[output & 1];
+			gf16_xor_jit_mul_avx2(scratch, cur, prev, blockLen, coefficient, mutScratch);
+			__m256i* _dst = (__m256i*)((uint8_t*)dst[output] + offset + pos);
+			for(size_t i = 0; i < blockLen / sizeof(__m256i); i++)
+				_mm256_store_si256(_dst + i, _mm256_xor_si256(_mm256_load_si256(_dst + i), _mm256_load_si256((__m256i*)cur + i)));
+			prev = cur;
+		}
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
+#endif
+}
+
 
 #if defined(__AVX2__) && defined(PLATFORM_AMD64)
 // extract top bits; interleaving of 16-bit words needed due to byte arrangement for pmovmskb
@@ -675,10 +703,7 @@ void* gf16_xor_jit_init_avx2(int polynomial) {
 
 void* gf16_xor_jit_init_mut_avx2() {
 #if defined(__AVX2__) && defined(PLATFORM_AMD64)
-	uint8_t *jitCode = jit_alloc(XORDEP_JIT_SIZE);
-	if(!jitCode) return NULL;
-	xor_write_init_jit(jitCode);
-	return jitCode;
+	return gf16_xor_jit_cache_create(XORDEP_JIT_SLOT_SIZE, XORDEP_JIT_CACHE_SLOTS, &xor_write_init_jit);
 #else
 	return NULL;
 #endif
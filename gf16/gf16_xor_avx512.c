@@ -778,17 +778,19 @@ static void* xor_write_jit_avx512_multi(const struct gf16_xor_scratch *HEDLEY_RE
 void gf16_xor_jit_mul_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
-	
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MUL, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-	
-	xor_write_jit_avx512(info, mutScratch, coefficient, 0);
+		xor_write_jit_avx512(info, jitWrite, coefficient, 0);
+	}
 	gf16_xor512_jit_stub(
 		(intptr_t)dst - 1024,
 		(intptr_t)dst + len - 1024,
 		(intptr_t)src - 1024,
-		mutScratch
+		jitCode
 	);
 	
 	_mm256_zeroupper();
@@ -800,17 +802,19 @@ void gf16_xor_jit_mul_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_R
 void gf16_xor_jit_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
-	
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MULADD, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-	
-	xor_write_jit_avx512(info, mutScratch, coefficient, 1);
+		xor_write_jit_avx512(info, jitWrite, coefficient, 1);
+	}
 	gf16_xor512_jit_stub(
 		(intptr_t)dst - 1024,
 		(intptr_t)dst + len - 1024,
 		(intptr_t)src - 1024,
-		mutScratch
+		jitCode
 	);
 	
 	_mm256_zeroupper();
@@ -819,102 +823,149 @@ void gf16_xor_jit_muladd_avx512(const void *HEDLEY_RESTRICT scratch, void *HEDLE
 #endif
 }
 
+void gf16_xor_jit_powadd_avx512(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	// the routine for the coefficient only needs to be generated once; products are chained through a pair of buffers which stay in L1, each being added to its destination as it's generated
+	ALIGN_TO(64, uint8_t chain[2][XORDEP_JIT_POW_BLOCK]);
+	for(size_t pos = 0; pos < len; pos += XORDEP_JIT_POW_BLOCK) {
+		size_t blockLen = len - pos < XORDEP_JIT_POW_BLOCK ? len - pos : XORDEP_JIT_POW_BLOCK;
+		const uint8_t* prev = (const uint8_t*)src + offset + pos;
+		for(unsigned output = 0; output < outputs; output++) {
+			uint8_t* cur = chain[output & 1];
+			gf16_xor_jit_mul_avx512(scratch, cur, prev, blockLen, coefficient, mutScratch);
+			__m512i* _dst = (__m512i*)((uint8_t*)dst[output] + offset + pos);
+			for(size_t i = 0; i < blockLen / sizeof(__m512i); i++)
+				_mm512_store_si512(_dst + i, _mm512_xor_si512(_mm512_load_si512(_dst + i), _mm512_load_si512((__m512i*)cur + i)));
+			prev = cur;
+		}
+	}
+	_mm256_zeroupper();
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
+#endif
+}
+
 
 
 #define XOR512_MULTI_REGIONS 6 // we support up to 10, but 6 seems more optimal (cache associativity reasons?)
+#define XORDEP_JIT_MULTI_SLOT_SIZE (XORDEP_JIT_SIZE*2) // multi-region routines are larger; single coefficient routines share the same cache
+#define XORDEP_JIT_MULTI_CACHE_SLOTS 128
 // other registers used (hence 10 supported): dest (0), end point (1), SP (4), one source (3), R12/R13 is avoided due to different encoding length; GCC doesn't like overriding BP (5) so skip that too
 
-unsigned gf16_xor_jit_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
 #if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+static HEDLEY_ALWAYS_INLINE void gf16_xor_jit_muladd_multi_x_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch, const int doAdd) {
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
-	uint8_t* jitCode = (uint8_t*)mutScratch + info->codeStart;
 	ALIGN_TO(32, const void* srcPtr[XOR512_MULTI_REGIONS]);
 	
 	for(unsigned region=0; region<regions; region += XOR512_MULTI_REGIONS) {
 		unsigned numRegions = regions - region;
 		if(numRegions > XOR512_MULTI_REGIONS) numRegions = XOR512_MULTI_REGIONS;
+		// if not adding, the first group of regions overwrites the destination, so doesn't load it
+		const int overwrite = !doAdd && region == 0;
 		
+		for(unsigned in = 0; in < numRegions; in++)
+			srcPtr[in] = (char*)src[region+in] + offset - 1024;
+		
+		uint8_t* jitWrite;
+		uint8_t* jitBase = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, overwrite ? XORDEP_JIT_MUL_MULTI : XORDEP_JIT_MULADD_MULTI, coefficients + region, numRegions, &jitWrite);
+		if(jitWrite) {
+			uint8_t* jitCode = jitWrite + info->codeStart;
 #ifdef CPU_SLOW_SMC_CLR
-		memset(jitCode + info->codeStart, 0, XORDEP_JIT_SIZE-256);
+			memset(jitCode, 0, XORDEP_JIT_MULTI_SLOT_SIZE - info->codeStart);
 #endif
-		
-		uint8_t* jitptr;
+			
+			uint8_t* jitptr;
 #ifdef CPU_SLOW_SMC
-		ALIGN_TO(64, uint8_t jitTemp[XORDEP_JIT_SIZE]);
-		uint8_t* jitdst;
+			ALIGN_TO(64, uint8_t jitTemp[XORDEP_JIT_MULTI_SLOT_SIZE]);
+			uint8_t* jitdst;
 #endif
-		
-		jitptr = jitCode;
+			
+			jitptr = jitCode;
 #ifdef CPU_SLOW_SMC
-		jitdst = jitptr;
-		if((uintptr_t)jitdst & 0x1F) {
-			/* copy unaligned part (might not be worth it for these CPUs, but meh) */
-			_mm_store_si128((__m128i*)jitTemp, _mm_load_si128((__m128i*)((uintptr_t)jitptr & ~0x1F)));
-			_mm_store_si128((__m128i*)(jitTemp+16), _mm_load_si128((__m128i*)((uintptr_t)jitptr & ~0x1F) +1));
-			jitptr = jitTemp + ((uintptr_t)jitdst & 0x1F);
-			jitdst -= (uintptr_t)jitdst & 0x1F;
-		}
-		else
-			jitptr = jitTemp;
+			jitdst = jitptr;
+			if((uintptr_t)jitdst & 0x1F) {
+				/* copy unaligned part (might not be worth it for these CPUs, but meh) */
+				_mm_store_si128((__m128i*)jitTemp, _mm_load_si128((__m128i*)((uintptr_t)jitptr & ~0x1F)));
+				_mm_store_si128((__m128i*)(jitTemp+16), _mm_load_si128((__m128i*)((uintptr_t)jitptr & ~0x1F) +1));
+				jitptr = jitTemp + ((uintptr_t)jitdst & 0x1F);
+				jitdst -= (uintptr_t)jitdst & 0x1F;
+			}
+			else
+				jitptr = jitTemp;
 #endif
-		
-		
-		jitptr = xor_write_jit_avx512_multi(info, jitptr, DX, coefficients[region], 2);
-		srcPtr[0] = (char*)src[region] + offset - 1024;
-		
-		for(unsigned in = 1; in < numRegions; in++) {
-			// load + run
-			int reg = in+5; // avoid overwriting SP (==4) and BP (==5)
-			if(reg == 12) reg = BX; // substitute problematic R12 with unused RBX
-			if(reg >= 13) reg++; // R13 has a required offset, which changes length, so skip it
-			jitptr += _jit_add_i(jitptr, reg, 1024);
-			for(int i=1; i<16; i++) {
-				jitptr += _jit_vmovdqa32_load(jitptr, 16+i, reg, i<<6);
+			
+			
+			jitptr = xor_write_jit_avx512_multi(info, jitptr, DX, coefficients[region], overwrite ? 0 : 2);
+			
+			for(unsigned in = 1; in < numRegions; in++) {
+				// load + run
+				int reg = in+5; // avoid overwriting SP (==4) and BP (==5)
+				if(reg == 12) reg = BX; // substitute problematic R12 with unused RBX
+				if(reg >= 13) reg++; // R13 has a required offset, which changes length, so skip it
+				jitptr += _jit_add_i(jitptr, reg, 1024);
+				for(int i=1; i<16; i++) {
+					jitptr += _jit_vmovdqa32_load(jitptr, 16+i, reg, i<<6);
+				}
+				jitptr = xor_write_jit_avx512_multi(info, jitptr, reg, coefficients[region+in], 1);
 			}
-			jitptr = xor_write_jit_avx512_multi(info, jitptr, reg, coefficients[region+in], 1);
-			srcPtr[in] = (char*)src[region+in] + offset - 1024;
-		}
-		
-		
-		// write out registers
-		for(int i=0; i<16; i+=2) {
-			jitptr += _jit_vmovdqa32_store(jitptr, AX, i<<6, i>>1);
-			jitptr += _jit_vmovdqa32_store(jitptr, AX, (i+1)<<6, (i>>1)+8);
-		}
-		
-		/* cmp/jcc */
-		*(uint64_t*)(jitptr) = 0x800FC03948 | (AX <<16) | (CX <<19) | ((uint64_t)JL <<32);
+			
+			
+			// write out registers
+			for(int i=0; i<16; i+=2) {
+				jitptr += _jit_vmovdqa32_store(jitptr, AX, i<<6, i>>1);
+				jitptr += _jit_vmovdqa32_store(jitptr, AX, (i+1)<<6, (i>>1)+8);
+			}
+			
+			/* cmp/jcc */
+			*(uint64_t*)(jitptr) = 0x800FC03948 | (AX <<16) | (CX <<19) | ((uint64_t)JL <<32);
 #ifdef CPU_SLOW_SMC
-		*(int32_t*)(jitptr +5) = (int32_t)((jitTemp - (jitdst - (uint8_t*)mutScratch)) - jitptr -9);
+			*(int32_t*)(jitptr +5) = (int32_t)((jitTemp - (jitdst - jitWrite)) - jitptr -9);
 #else
-		*(int32_t*)(jitptr +5) = (int32_t)((uint8_t*)mutScratch - jitptr -9);
+			*(int32_t*)(jitptr +5) = (int32_t)(jitWrite - jitptr -9);
 #endif
-		jitptr[9] = 0xC3; /* ret */
-		
+			jitptr[9] = 0xC3; /* ret */
+			
 #ifdef CPU_SLOW_SMC
-		/* memcpy to destination */
-		/* AVX does result in fewer writes, but testing on Haswell seems to indicate minimal benefit over SSE2 */
-		for(uint_fast32_t i=0; i<(uint_fast32_t)(jitptr+10-jitTemp); i+=64) {
-			__m256i ta = _mm256_load_si256((__m256i*)(jitTemp + i));
-			__m256i tb = _mm256_load_si256((__m256i*)(jitTemp + i + 32));
-			_mm256_store_si256((__m256i*)(jitdst + i), ta);
-			_mm256_store_si256((__m256i*)(jitdst + i + 32), tb);
-		}
+			/* memcpy to destination */
+			/* AVX does result in fewer writes, but testing on Haswell seems to indicate minimal benefit over SSE2 */
+			for(uint_fast32_t i=0; i<(uint_fast32_t)(jitptr+10-jitTemp); i+=64) {
+				__m256i ta = _mm256_load_si256((__m256i*)(jitTemp + i));
+				__m256i tb = _mm256_load_si256((__m256i*)(jitTemp + i + 32));
+				_mm256_store_si256((__m256i*)(jitdst + i), ta);
+				_mm256_store_si256((__m256i*)(jitdst + i + 32), tb);
+			}
 #endif
-		
+		}
 		
 		gf16_xor512_jit_multi_stub(
 			(intptr_t)dst + offset - 1024,
 			(intptr_t)dst + offset + len - 1024,
 			srcPtr,
-			mutScratch
+			jitBase
 		);
 	}
-	
+}
+#endif
+
+unsigned gf16_xor_jit_muladd_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	gf16_xor_jit_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, mutScratch, 1);
+	_mm256_zeroupper();
+	return regions;
+#else
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
+	return 0;
+#endif
+}
+
+// as above, but the first group of regions overwrites the destination instead of adding to it
+unsigned gf16_xor_jit_mul_multi_avx512(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
+	gf16_xor_jit_muladd_multi_x_avx512(scratch, regions, offset, dst, src, len, coefficients, mutScratch, 0);
 	_mm256_zeroupper();
 	return regions;
 #else
-	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients);
+	UNUSED(scratch); UNUSED(regions); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficients); UNUSED(mutScratch);
 	return 0;
 #endif
 }
@@ -1114,10 +1165,7 @@ void* gf16_xor_jit_init_avx512(int polynomial) {
 
 void* gf16_xor_jit_init_mut_avx512() {
 #if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(PLATFORM_AMD64)
-	uint8_t *jitCode = jit_alloc(XORDEP_JIT_SIZE*2);
-	if(!jitCode) return NULL;
-	xor_write_init_jit(jitCode);
-	return jitCode;
+	return gf16_xor_jit_cache_create(XORDEP_JIT_MULTI_SLOT_SIZE, XORDEP_JIT_MULTI_CACHE_SLOTS, &xor_write_init_jit);
 #else
 	return NULL;
 #endif
@@ -1125,7 +1173,7 @@ void* gf16_xor_jit_init_mut_avx512() {
 
 void gf16_xor_jit_uninit_avx512(void* scratch) {
 #ifdef PLATFORM_X86
-	jit_free(scratch, XORDEP_JIT_SIZE*2);
+	gf16_xor_jit_cache_free((struct gf16_xor_jit_cache*)scratch);
 #else
 	UNUSED(scratch);
 #endif
@@ -1,5 +1,6 @@
 #include "gf16_global.h"
 #include "platform.h"
+#include "gf16_xor.h"
 #ifdef PLATFORM_X86
 
 #include "x86_jit.h"
@@ -120,4 +121,96 @@ struct gf16_xor_scratch {
 	uint_fast8_t codeStart;
 };
 
+
+/* cache of generated routines, keyed by coefficient(s), so that coefficients which recur (e.g. for each chunk of a slice, or each pass) don't need to be JIT'd again
+ * each thread gets its own, passed to the JIT functions as mutScratch
+ * the executable arena is reserved up front and split into fixed size slots, each starting with the routine's prologue; slots are grouped into sets by key hash, with LRU replacement within each set */
+#define XORDEP_JIT_SLOT_SIZE 1536 /* fits prologue + XORDEP_JIT_CODE_SIZE */
+#define XORDEP_JIT_CACHE_SLOTS GF16_XOR_JIT_CACHE_SLOTS
+#define XORDEP_JIT_CACHE_WAYS 4
+#define XORDEP_JIT_CACHE_KEY 6 /* max coefficients identifying a routine (for multi-region routines) */
+
+/* block size that pow_add chains products through; a multiple of the largest stride */
+#define XORDEP_JIT_POW_BLOCK 4096
+
+/* kind of routine, which forms part of the key */
+#define XORDEP_JIT_MUL 0
+#define XORDEP_JIT_MULADD 1
+#define XORDEP_JIT_MULADD_MULTI 2
+#define XORDEP_JIT_MUL_MULTI 3
+
+#include <stdlib.h>
+#include <string.h>
+
+struct gf16_xor_jit_slot {
+	uint32_t lastUse; /* 0 if empty */
+	uint16_t type; /* kind + number of coefficients */
+	uint16_t coeff[XORDEP_JIT_CACHE_KEY];
+};
+struct gf16_xor_jit_cache {
+	jit_wx_pair code;
+	size_t slotSize;
+	unsigned numSets;
+	uint32_t clock;
+	struct gf16_xor_jit_slot* slots;
+};
+
+static inline void gf16_xor_jit_cache_free(struct gf16_xor_jit_cache* cache) {
+	if(cache->code.x) jit_free(&cache->code);
+	free(cache->slots);
+	free(cache);
+}
+static inline struct gf16_xor_jit_cache* gf16_xor_jit_cache_create(size_t slotSize, unsigned numSlots, size_t(*writePrologue)(uint8_t*)) {
+	struct gf16_xor_jit_cache* cache = (struct gf16_xor_jit_cache*)malloc(sizeof(struct gf16_xor_jit_cache));
+	if(!cache) return NULL;
+	cache->slotSize = slotSize;
+	cache->numSets = numSlots / XORDEP_JIT_CACHE_WAYS;
+	cache->clock = 0;
+	if(!jit_alloc(&cache->code, slotSize * numSlots))
+		cache->code.x = NULL;
+	cache->slots = (struct gf16_xor_jit_slot*)calloc(numSlots, sizeof(struct gf16_xor_jit_slot));
+	if(!cache->code.x || !cache->slots) {
+		gf16_xor_jit_cache_free(cache);
+		return NULL;
+	}
+	for(unsigned i=0; i<numSlots; i++)
+		writePrologue(cache->code.w + i*slotSize);
+	return cache;
+}
+
+/* finds the slot for a routine, returning where to execute it from; if it isn't cached, the least recently used slot in its set is given up, and *write is set to where the routine needs to be written (otherwise NULL) */
+static HEDLEY_ALWAYS_INLINE uint8_t* gf16_xor_jit_cache_get(struct gf16_xor_jit_cache* cache, int kind, const uint16_t* coeff, unsigned numCoeff, uint8_t** write) {
+	uint16_t type = (uint16_t)((kind << 8) | numCoeff);
+	uint32_t hash = type * 0x9E3779B1;
+	for(unsigned i=0; i<numCoeff; i++)
+		hash = (hash ^ coeff[i]) * 0x9E3779B1;
+	unsigned set = (hash >> 16) % cache->numSets;
+	struct gf16_xor_jit_slot* slots = cache->slots + set*XORDEP_JIT_CACHE_WAYS;
+	
+	if(HEDLEY_UNLIKELY(++cache->clock == 0)) {
+		/* clock wrapped around; simply invalidate everything */
+		memset(cache->slots, 0, cache->numSets * XORDEP_JIT_CACHE_WAYS * sizeof(struct gf16_xor_jit_slot));
+		cache->clock = 1;
+	}
+	
+	unsigned victim = 0;
+	for(unsigned way=0; way<XORDEP_JIT_CACHE_WAYS; way++) {
+		struct gf16_xor_jit_slot* slot = slots + way;
+		if(slot->lastUse && slot->type == type && !memcmp(slot->coeff, coeff, numCoeff*sizeof(uint16_t))) {
+			slot->lastUse = cache->clock;
+			*write = NULL;
+			return cache->code.x + (set*XORDEP_JIT_CACHE_WAYS + way) * cache->slotSize;
+		}
+		if(slot->lastUse < slots[victim].lastUse)
+			victim = way;
+	}
+	
+	slots[victim].lastUse = cache->clock;
+	slots[victim].type = type;
+	memcpy(slots[victim].coeff, coeff, numCoeff*sizeof(uint16_t));
+	size_t slotOffset = (set*XORDEP_JIT_CACHE_WAYS + victim) * cache->slotSize;
+	*write = cache->code.w + slotOffset;
+	return cache->code.x + slotOffset;
+}
+
 #endif /* PLATFORM_X86 */
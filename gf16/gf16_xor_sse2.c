@@ -722,11 +722,14 @@ static inline void xor_write_jit_sse(const struct gf16_xor_scratch *HEDLEY_RESTR
 void gf16_xor_jit_mul_sse2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #ifdef __SSE2__
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MUL, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-	
-	xor_write_jit_sse(info, mutScratch, coefficient, 0);
+		xor_write_jit_sse(info, jitWrite, coefficient, 0);
+	}
 	// exec
 	/* adding 128 to the destination pointer allows the register offset to be coded in 1 byte
 	 * eg: 'movdqa xmm0, [rdx+0x90]' is 8 bytes, whilst 'movdqa xmm0, [rdx-0x60]' is 5 bytes */
@@ -734,7 +737,7 @@ void gf16_xor_jit_mul_sse2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RES
 		(intptr_t)src - 128,
 		(intptr_t)dst + len - 128,
 		(intptr_t)dst - 128,
-		mutScratch
+		jitCode
 	);
 #else
 	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
@@ -744,22 +747,46 @@ void gf16_xor_jit_mul_sse2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RES
 void gf16_xor_jit_muladd_sse2(const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
 #ifdef __SSE2__
 	const struct gf16_xor_scratch *HEDLEY_RESTRICT info = (const struct gf16_xor_scratch *HEDLEY_RESTRICT)scratch;
+	uint8_t* jitWrite;
+	uint8_t* jitCode = gf16_xor_jit_cache_get((struct gf16_xor_jit_cache*)mutScratch, XORDEP_JIT_MULADD, &coefficient, 1, &jitWrite);
+	if(jitWrite) {
 #ifdef CPU_SLOW_SMC_CLR
-	memset((char*)mutScratch + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
+		memset(jitWrite + info->codeStart, 0, XORDEP_JIT_CODE_SIZE);
 #endif
-
-	xor_write_jit_sse(info, mutScratch, coefficient, 1);
+		xor_write_jit_sse(info, jitWrite, coefficient, 1);
+	}
 	gf16_xor_jit_stub(
 		(intptr_t)src - 128,
 		(intptr_t)dst + len - 128,
 		(intptr_t)dst - 128,
-		mutScratch
+		jitCode
 	);
 #else
 	UNUSED(scratch); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
 #endif
 }
 
+void gf16_xor_jit_powadd_sse2(const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch) {
+#if defined(__SSE2__)
+	// the routine for the coefficient only needs to be generated once; products are chained through a pair of buffers which stay in L1, each being added to its destination as it's generated
+	ALIGN_TO(16, uint8_t chain[2][XORDEP_JIT_POW_BLOCK]);
+	for(size_t pos = 0; pos < len; pos += XORDEP_JIT_POW_BLOCK) {
+		size_t blockLen = len - pos < XORDEP_JIT_POW_BLOCK ? len - pos : XORDEP_JIT_POW_BLOCK;
+		const uint8_t* prev = (const uint8_t*)src + offset + pos;
+		for(unsigned output = 0; output < outputs; output++) {
+			uint8_t* cur = chain[output & 1];
+			gf16_xor_jit_mul_sse2(scratch, cur, prev, blockLen, coefficient, mutScratch);
+			__m128i* _dst = (__m128i*)((uint8_t*)dst[output] + offset + pos);
+			for(size_t i = 0; i < blockLen / sizeof(__m128i); i++)
+				_mm_store_si128(_dst + i, _mm_xor_si128(_mm_load_si128(_dst + i), _mm_load_si128((__m128i*)cur + i)));
+			prev = cur;
+		}
+	}
+#else
+	UNUSED(scratch); UNUSED(outputs); UNUSED(offset); UNUSED(dst); UNUSED(src); UNUSED(len); UNUSED(coefficient); UNUSED(mutScratch);
+#endif
+}
+
 #ifdef __SSE2__
 static const unsigned char BitsSetTable256[256] = 
 {
@@ -1184,10 +1211,7 @@ void* gf16_xor_jit_init_sse2(int polynomial) {
 
 void* gf16_xor_jit_init_mut_sse2() {
 #ifdef PLATFORM_X86
-	uint8_t *jitCode = jit_alloc(XORDEP_JIT_SIZE);
-	if(!jitCode) return NULL;
-	xor_write_init_jit(jitCode);
-	return jitCode;
+	return gf16_xor_jit_cache_create(XORDEP_JIT_SLOT_SIZE, XORDEP_JIT_CACHE_SLOTS, &xor_write_init_jit);
 #else
 	return NULL;
 #endif
@@ -1195,7 +1219,7 @@ void* gf16_xor_jit_init_mut_sse2() {
 
 void gf16_xor_jit_uninit(void* scratch) {
 #ifdef PLATFORM_X86
-	jit_free(scratch, XORDEP_JIT_SIZE);
+	gf16_xor_jit_cache_free((struct gf16_xor_jit_cache*)scratch);
 #else
 	UNUSED(scratch);
 #endif
@@ -1,12 +1,15 @@
 #include "gf16mul.h"
 #include "gf16_global.h"
 #include <cstdlib>
+#include <cstdio>
 
 extern "C" {
 	#include "gf16_lookup.h"
 	#include "gf16_shuffle.h"
 	#include "gf16_affine.h"
+	#include "gf16_clmul.h"
 	#include "gf16_xor.h"
+	#include "gf16_add.h"
 }
 
 // CPUID stuff
@@ -34,10 +37,10 @@ extern "C" {
 # endif
 # include "x86_jit.h"
 struct CpuCap {
-	bool hasSSE2, hasSSSE3, hasAVX, hasAVX2, hasAVX512VLBW, hasAVX512VBMI, hasGFNI;
+	bool hasSSE2, hasSSSE3, hasAVX, hasAVX2, hasAVX512VLBW, hasAVX512VBMI, hasGFNI, hasPCLMUL, hasVPCLMUL;
 	size_t propPrefShuffleThresh;
-	bool propAVX128EU, propHT;
-	bool canMemWX;
+	bool propSlowShuffle, propAVX128EU, propHT;
+	bool canMemWX; // can allocate memory for JIT code (writable+executable, or dual mapped)
 	CpuCap(bool detect) :
 	  hasSSE2(true),
 	  hasSSSE3(true),
@@ -46,7 +49,10 @@ struct CpuCap {
 	  hasAVX512VLBW(true),
 	  hasAVX512VBMI(true),
 	  hasGFNI(true),
+	  hasPCLMUL(true),
+	  hasVPCLMUL(true),
 	  propPrefShuffleThresh(0),
+	  propSlowShuffle(false),
 	  propAVX128EU(false),
 	  propHT(false),
 	  canMemWX(true)
@@ -60,6 +66,7 @@ struct CpuCap {
 		hasMulticore = (cpuInfo[3] & (1<<28));
 		hasSSE2 = (cpuInfo[3] & 0x4000000);
 		hasSSSE3 = (cpuInfo[2] & 0x200);
+		hasPCLMUL = (cpuInfo[2] & 2);
 		
 		family = ((cpuInfo[0]>>8) & 0xf) + ((cpuInfo[0]>>16) & 0xff0);
 		model = ((cpuInfo[0]>>4) & 0xf) + ((cpuInfo[0]>>12) & 0xf0);
@@ -71,15 +78,18 @@ struct CpuCap {
 			if(model == 0x1C || model == 0x26 || model == 0x27 || model == 0x35 || model == 0x36 || model == 0x37 || model == 0x4A || model == 0x4C || model == 0x4D || model == 0x5A || model == 0x5D) {
 				/* we have a Bonnell/Silvermont CPU with a really slow pshufb instruction; pretend SSSE3 doesn't exist, as XOR_DEPENDS is much faster */
 				propPrefShuffleThresh = 2048;
+				propSlowShuffle = true;
 			}
 			if(model == 0x0F || model == 0x16) {
 				/* Conroe CPU with relatively slow pshufb; pretend SSSE3 doesn't exist, as XOR_DEPENDS is generally faster */
 				propPrefShuffleThresh = 16384;
+				propSlowShuffle = true;
 			}
 		}
 		if((family == 0x5f && (model == 0 || model == 1 || model == 2)) || (family == 0x6f && (model == 0 || model == 0x10 || model == 0x20 || model == 0x30))) {
 			/* Jaguar has a slow shuffle instruction and XOR is much faster; presumably the same for Bobcat/Puma */
 			propPrefShuffleThresh = 2048;
+			propSlowShuffle = true;
 		}
 		
 		propAVX128EU = ( // CPUs with 128-bit AVX units
@@ -89,7 +99,7 @@ struct CpuCap {
 			|| (family == 6 && model == 0xf) // Centaur/Zhaoxin; overlaps with Intel Core 2, but they don't support AVX
 		);
 		
-		hasAVX = false; hasAVX2 = false; hasAVX512VLBW = false; hasAVX512VBMI = false; hasGFNI = false;
+		hasAVX = false; hasAVX2 = false; hasAVX512VLBW = false; hasAVX512VBMI = false; hasGFNI = false; hasVPCLMUL = false;
 #if !defined(_MSC_VER) || _MSC_VER >= 1600
 		_cpuidX(cpuInfoX, 7, 0);
 		if(cpuInfo[2] & 0x8000000) { // has OSXSAVE
@@ -101,6 +111,7 @@ struct CpuCap {
 					// checks AVX512BW + AVX512VL + AVX512F
 					hasAVX512VLBW = ((cpuInfoX[1] & 0xC0010000) == 0xC0010000);
 					hasAVX512VBMI = ((cpuInfoX[2] & 2) == 2 && hasAVX512VLBW);
+					hasVPCLMUL = ((cpuInfoX[2] & 0x400) == 0x400 && hasAVX512VLBW);
 				}
 			}
 		}
@@ -122,9 +133,9 @@ struct CpuCap {
 		}
 		
 		// test for JIT capability
-		void* jitTest = jit_alloc(256);
-		canMemWX = (jitTest != NULL);
-		if(jitTest) jit_free(jitTest, 256);
+		jit_wx_pair jitTest;
+		canMemWX = jit_alloc(&jitTest, 256);
+		if(canMemWX) jit_free(&jitTest);
 	}
 };
 #endif
@@ -198,6 +209,11 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					}
 					_mul = &gf16_shuffle_mul_ssse3;
 					_mul_add = &gf16_shuffle_muladd_ssse3;
+					_pow_add = &gf16_shuffle_powadd_ssse3;
+					#ifdef PLATFORM_AMD64
+					_mul_add_multi = &gf16_shuffle_muladd_multi_ssse3;
+					_mul_multi = &gf16_shuffle_mul_multi_ssse3;
+					#endif
 					prepare = &gf16_shuffle_prepare_ssse3;
 					finish = &gf16_shuffle_finish_ssse3;
 				break;
@@ -208,6 +224,11 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					}
 					_mul = &gf16_shuffle_mul_avx;
 					_mul_add = &gf16_shuffle_muladd_avx;
+					_pow_add = &gf16_shuffle_powadd_avx;
+					#ifdef PLATFORM_AMD64
+					_mul_add_multi = &gf16_shuffle_muladd_multi_avx;
+					_mul_multi = &gf16_shuffle_mul_multi_avx;
+					#endif
 					prepare = &gf16_shuffle_prepare_avx;
 					finish = &gf16_shuffle_finish_avx;
 				break;
@@ -218,6 +239,11 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					}
 					_mul = &gf16_shuffle_mul_avx2;
 					_mul_add = &gf16_shuffle_muladd_avx2;
+					_pow_add = &gf16_shuffle_powadd_avx2;
+					#ifdef PLATFORM_AMD64
+					_mul_add_multi = &gf16_shuffle_muladd_multi_avx2;
+					_mul_multi = &gf16_shuffle_mul_multi_avx2;
+					#endif
 					prepare = &gf16_shuffle_prepare_avx2;
 					finish = &gf16_shuffle_finish_avx2;
 					_info.alignment = 32;
@@ -229,9 +255,11 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					}
 					_mul = &gf16_shuffle_mul_avx512;
 					_mul_add = &gf16_shuffle_muladd_avx512;
+					_pow_add = &gf16_shuffle_powadd_avx512;
 					#ifdef PLATFORM_AMD64
 					// if 32 registers are available, can do multi-region
 					_mul_add_multi = &gf16_shuffle_muladd_multi_avx512;
+					_mul_multi = &gf16_shuffle_mul_multi_avx512;
 					#endif
 					prepare = &gf16_shuffle_prepare_avx512;
 					finish = &gf16_shuffle_finish_avx512;
@@ -251,6 +279,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			_mul_add = &gf16_shuffle_muladd_vbmi;
 			#ifdef PLATFORM_AMD64
 			_mul_add_multi = &gf16_shuffle_muladd_multi_vbmi;
+			_mul_multi = &gf16_shuffle_mul_multi_vbmi;
 			#endif
 			prepare = &gf16_shuffle_prepare_avx512;
 			finish = &gf16_shuffle_finish_avx512;
@@ -266,6 +295,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			_mul_add = &gf16_shuffle2x_muladd_avx512;
 			#ifdef PLATFORM_AMD64
 			_mul_add_multi = &gf16_shuffle2x_muladd_multi_avx512;
+			_mul_multi = &gf16_shuffle2x_mul_multi_avx512;
 			#endif
 			prepare = &gf16_shuffle2x_prepare_avx512;
 			finish = &gf16_shuffle2x_finish_avx512;
@@ -281,6 +311,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			_mul_add = &gf16_shuffle2x_muladd_avx2;
 			#ifdef PLATFORM_AMD64
 			_mul_add_multi = &gf16_shuffle2x_muladd_multi_avx2;
+			_mul_multi = &gf16_shuffle2x_mul_multi_avx2;
 			#endif
 			prepare = &gf16_shuffle2x_prepare_avx2;
 			finish = &gf16_shuffle2x_finish_avx2;
@@ -303,6 +334,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			#ifdef __aarch64__
 			// enable only if 32 registers available
 			_mul_add_multi = &gf16_shuffle_muladd_multi_neon;
+			_mul_multi = &gf16_shuffle_mul_multi_neon;
 			#endif
 		break;
 		
@@ -316,13 +348,34 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			}
 			_mul = &gf16_affine_mul_avx512;
 			_mul_add = &gf16_affine_muladd_avx512;
+			_pow_add = &gf16_affine_powadd_avx512;
 			#ifdef PLATFORM_AMD64
 			_mul_add_multi = &gf16_affine_muladd_multi_avx512;
+			_mul_multi = &gf16_affine_mul_multi_avx512;
 			#endif
 			prepare = &gf16_shuffle_prepare_avx512;
 			finish = &gf16_shuffle_finish_avx512;
 		break;
 		
+		case GF16_AFFINE_AVX2:
+			scratch = gf16_affine_init_avx2(GF16_POLYNOMIAL);
+			_info.alignment = 32;
+			_info.stride = 64;
+			if(!gf16_affine_available_avx2 || !gf16_shuffle_available_avx2) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_affine_mul_avx2;
+			_mul_add = &gf16_affine_muladd_avx2;
+			_pow_add = &gf16_affine_powadd_avx2;
+			#ifdef PLATFORM_AMD64
+			_mul_add_multi = &gf16_affine_muladd_multi_avx2;
+			_mul_multi = &gf16_affine_mul_multi_avx2;
+			#endif
+			prepare = &gf16_shuffle_prepare_avx2;
+			finish = &gf16_shuffle_finish_avx2;
+		break;
+		
 		case GF16_AFFINE_GFNI:
 			scratch = gf16_affine_init_gfni(GF16_POLYNOMIAL);
 			_info.alignment = 16;
@@ -333,8 +386,10 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			}
 			_mul = &gf16_affine_mul_gfni;
 			_mul_add = &gf16_affine_muladd_gfni;
+			_pow_add = &gf16_affine_powadd_gfni;
 			#ifdef PLATFORM_AMD64
 			_mul_add_multi = &gf16_affine_muladd_multi_gfni;
+			_mul_multi = &gf16_affine_mul_multi_gfni;
 			#endif
 			prepare = &gf16_shuffle_prepare_ssse3;
 			finish = &gf16_shuffle_finish_ssse3;
@@ -348,12 +403,90 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 				setupMethod(GF16_AUTO);
 				return;
 			}
+			_mul = &gf16_affine2x_mul_avx512;
 			_mul_add = &gf16_affine2x_muladd_avx512;
 			_mul_add_multi = &gf16_affine2x_muladd_multi_avx512;
+			_mul_multi = &gf16_affine2x_mul_multi_avx512;
 			prepare = &gf16_affine2x_prepare_avx512;
 			finish = &gf16_affine2x_finish_avx512;
 		break;
 		
+		case GF16_AFFINE2X_AVX2:
+			scratch = gf16_affine_init_avx2(GF16_POLYNOMIAL);
+			_info.alignment = 32;
+			_info.stride = 32;
+			if(!gf16_affine_available_avx2 || !gf16_shuffle_available_avx2) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_affine2x_mul_avx2;
+			_mul_add = &gf16_affine2x_muladd_avx2;
+			_mul_add_multi = &gf16_affine2x_muladd_multi_avx2;
+			_mul_multi = &gf16_affine2x_mul_multi_avx2;
+			prepare = &gf16_affine2x_prepare_avx2;
+			finish = &gf16_affine2x_finish_avx2;
+		break;
+		
+		case GF16_AFFINE2X_NT_AVX512:
+			scratch = gf16_affine_init_avx512(GF16_POLYNOMIAL);
+			_info.alignment = 64;
+			_info.stride = 64;
+			if(!gf16_affine_available_avx512) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_affine2x_nt_mul_avx512;
+			_mul_add = &gf16_affine2x_nt_muladd_avx512;
+			_mul_add_multi = &gf16_affine2x_nt_muladd_multi_avx512;
+			_mul_multi = &gf16_affine2x_nt_mul_multi_avx512;
+		break;
+		
+		case GF16_AFFINE2X_NT_AVX2:
+			scratch = gf16_affine_init_avx2(GF16_POLYNOMIAL);
+			_info.alignment = 32;
+			_info.stride = 32;
+			if(!gf16_affine_available_avx2) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_affine2x_nt_mul_avx2;
+			_mul_add = &gf16_affine2x_nt_muladd_avx2;
+			_mul_add_multi = &gf16_affine2x_nt_muladd_multi_avx2;
+			_mul_multi = &gf16_affine2x_nt_mul_multi_avx2;
+		break;
+		
+		case GF16_CLMUL_SSE:
+			scratch = gf16_clmul_init(GF16_POLYNOMIAL);
+			_info.alignment = 16;
+			_info.stride = 16;
+			if(!gf16_clmul_available_sse) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_clmul_mul_sse;
+			_mul_add = &gf16_clmul_muladd_sse;
+			#ifdef PLATFORM_AMD64
+			_mul_add_multi = &gf16_clmul_muladd_multi_sse;
+			_mul_multi = &gf16_clmul_mul_multi_sse;
+			#endif
+		break;
+		
+		case GF16_CLMUL_AVX512:
+			scratch = gf16_clmul_init(GF16_POLYNOMIAL);
+			_info.alignment = 64;
+			_info.stride = 64;
+			if(!gf16_clmul_available_avx512) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_clmul_mul_avx512;
+			_mul_add = &gf16_clmul_muladd_avx512;
+			#ifdef PLATFORM_AMD64
+			_mul_add_multi = &gf16_clmul_muladd_multi_avx512;
+			_mul_multi = &gf16_clmul_mul_multi_avx512;
+			#endif
+		break;
+		
 		case GF16_AFFINE2X_GFNI:
 			scratch = gf16_affine_init_gfni(GF16_POLYNOMIAL);
 			_info.alignment = 16;
@@ -362,8 +495,10 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 				setupMethod(GF16_AUTO);
 				return;
 			}
+			_mul = &gf16_affine2x_mul_gfni;
 			_mul_add = &gf16_affine2x_muladd_gfni;
 			_mul_add_multi = &gf16_affine2x_muladd_multi_gfni;
+			_mul_multi = &gf16_affine2x_mul_multi_gfni;
 			prepare = &gf16_affine2x_prepare_gfni;
 			finish = &gf16_affine2x_finish_gfni;
 		break;
@@ -390,6 +525,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 						scratch = gf16_xor_jit_init_sse2(GF16_POLYNOMIAL);
 						_mul = &gf16_xor_jit_mul_sse2;
 						_mul_add = &gf16_xor_jit_muladd_sse2;
+						_pow_add = &gf16_xor_jit_powadd_sse2;
 					}
 					prepare = &gf16_xor_prepare_sse2;
 					finish = &gf16_xor_finish_sse2;
@@ -415,6 +551,7 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					scratch = gf16_xor_jit_init_avx2(GF16_POLYNOMIAL);
 					_mul = &gf16_xor_jit_mul_avx2;
 					_mul_add = &gf16_xor_jit_muladd_avx2;
+					_pow_add = &gf16_xor_jit_powadd_avx2;
 					prepare = &gf16_xor_prepare_avx2;
 					finish = &gf16_xor_finish_avx2;
 					_info.alignment = 32;
@@ -427,7 +564,9 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 					scratch = gf16_xor_jit_init_avx512(GF16_POLYNOMIAL);
 					_mul = &gf16_xor_jit_mul_avx512;
 					_mul_add = &gf16_xor_jit_muladd_avx512;
+					_pow_add = &gf16_xor_jit_powadd_avx512;
 					_mul_add_multi = &gf16_xor_jit_muladd_multi_avx512;
+					_mul_multi = &gf16_xor_jit_mul_multi_avx512;
 					prepare = &gf16_xor_prepare_avx512;
 					finish = &gf16_xor_finish_avx512;
 					_info.alignment = 64;
@@ -445,6 +584,28 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 			_info.stride = 16;
 		break;
 		
+		case GF16_LOOKUP_AVX2:
+			if(!gf16_lookup_available_avx2) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_lookup_mul_avx2;
+			_mul_add = &gf16_lookup_muladd_avx2;
+			_info.alignment = 32;
+			_info.stride = 32;
+		break;
+		
+		case GF16_LOOKUP_AVX512:
+			if(!gf16_lookup_available_avx512) {
+				setupMethod(GF16_AUTO);
+				return;
+			}
+			_mul = &gf16_lookup_mul_avx512;
+			_mul_add = &gf16_lookup_muladd_avx512;
+			_info.alignment = 64;
+			_info.stride = 64;
+		break;
+		
 		case GF16_LOOKUP3:
 			_mul = &gf16_lookup3_mul;
 			_mul_add = &gf16_lookup3_muladd;
@@ -465,27 +626,84 @@ void Galois16Mul::setupMethod(Galois16Methods method) {
 	_info.id = method;
 	_info.name = Galois16MethodsText[(int)method];
 	
-	// TODO: improve these?
-	// TODO: this probably needs to be variable depending on the CPU cache size
-	// although these defaults are pretty good across most CPUs
+	// multiplies by 1 are plain XORs; use vector kernels of the same ISA as the method, since the CPU is known to support it
+	switch(method) {
+		case GF16_SHUFFLE_AVX512:
+		case GF16_SHUFFLE_VBMI:
+		case GF16_SHUFFLE2X_AVX512:
+		case GF16_XOR_JIT_AVX512:
+		case GF16_AFFINE_AVX512:
+		case GF16_AFFINE2X_AVX512:
+		case GF16_AFFINE2X_NT_AVX512:
+		case GF16_CLMUL_AVX512:
+		case GF16_LOOKUP_AVX512:
+			if(gf16_add_available_avx512) {
+				_add = &gf16_add_avx512;
+				_add_multi = &gf16_add_multi_avx512;
+				_sum_multi = &gf16_sum_multi_avx512;
+			}
+		break;
+		case GF16_SHUFFLE_AVX2:
+		case GF16_SHUFFLE2X_AVX2:
+		case GF16_XOR_JIT_AVX2:
+		case GF16_AFFINE_AVX2:
+		case GF16_AFFINE2X_AVX2:
+		case GF16_AFFINE2X_NT_AVX2:
+		case GF16_LOOKUP_AVX2:
+			if(gf16_add_available_avx2) {
+				_add = &gf16_add_avx2;
+				_add_multi = &gf16_add_multi_avx2;
+				_sum_multi = &gf16_sum_multi_avx2;
+			}
+		break;
+		case GF16_SHUFFLE_SSSE3:
+		case GF16_SHUFFLE_AVX:
+		case GF16_XOR_SSE2:
+		case GF16_XOR_JIT_SSE2:
+		case GF16_LOOKUP_SSE2:
+		case GF16_AFFINE_GFNI:
+		case GF16_AFFINE2X_GFNI:
+		case GF16_CLMUL_SSE:
+			if(gf16_add_available_sse2) {
+				_add = &gf16_add_sse2;
+				_add_multi = &gf16_add_multi_sse2;
+				_sum_multi = &gf16_sum_multi_sse2;
+			}
+		break;
+		default: break; // use generic XOR
+	}
+	
+	// size chunks relative to the cache sizes of the CPU; the defaults are tuned for a 32KB L1D/256KB L2 core
+	const Galois16CacheInfo& cache = cache_info();
+	size_t l2PerThread = cache.l2 / cache.l2Shared;
+	_info.codeCacheCoeffs = 0;
 	switch(method) {
 		case GF16_XOR_JIT_SSE2: // JIT is a little slow, so larger blocks make things faster
 		case GF16_XOR_JIT_AVX2:
 		case GF16_XOR_JIT_AVX512:
-			_info.idealChunkSize = 128*1024; // half L2 cache?
+			_info.idealChunkSize = l2PerThread / 2; // half L2 cache
+			if(_info.idealChunkSize < 64*1024) _info.idealChunkSize = 64*1024;
+			if(_info.idealChunkSize > 256*1024) _info.idealChunkSize = 256*1024;
+			_info.minChunkSize = _info.idealChunkSize; // JIT overhead grows if chunks are shrunk
+			_info.codeCacheCoeffs = GF16_XOR_JIT_CACHE_SLOTS/2; // leave room for set conflicts
 		break;
 		case GF16_LOOKUP:
 		case GF16_LOOKUP_SSE2:
 		case GF16_LOOKUP3:
+		case GF16_LOOKUP_AVX2:
+		case GF16_LOOKUP_AVX512:
 		case GF16_XOR_SSE2:
-			_info.idealChunkSize = 96*1024; // 2* L1 data cache size ?
+			_info.idealChunkSize = cache.l1d * 3;
+			_info.minChunkSize = 4096;
 		break;
 		default: // Shuffle/Affine
-			_info.idealChunkSize = 48*1024; // ~=L1 * 1-2 data cache size seems to be efficient
+			_info.idealChunkSize = cache.l1d + cache.l1d/2; // ~=L1 * 1-2 data cache size seems to be efficient
+			_info.minChunkSize = 4096;
 	}
+	if(_info.minChunkSize < _info.stride) _info.minChunkSize = _info.stride;
 }
 
-Galois16Mul::Galois16Mul(Galois16Methods method) {
+Galois16Mul::Galois16Mul(Galois16Methods method, size_t regionSizeHint, unsigned outputs, unsigned threadCountHint) {
 	scratch = NULL;
 	prepare = &Galois16Mul::_prepare_none;
 	finish = &Galois16Mul::_finish_none;
@@ -495,10 +713,15 @@ Galois16Mul::Galois16Mul(Galois16Methods method) {
 	_mul = NULL;
 	_add = &Galois16Mul::addGeneric;
 	_mul_add_multi = &Galois16Mul::_mul_add_multi_none;
+	_mul_multi = NULL;
+	_add_multi = NULL;
+	_sum_multi = NULL;
 	
 	_pow = NULL;
 	_pow_add = NULL;
 	
+	if(method == GF16_AUTO)
+		method = default_method(regionSizeHint, outputs, threadCountHint);
 	setupMethod(method);
 }
 
@@ -519,6 +742,9 @@ void Galois16Mul::move(Galois16Mul& other) {
 	_add = other._add;
 	_mul_add = other._mul_add;
 	_mul_add_multi = other._mul_add_multi;
+	_mul_multi = other._mul_multi;
+	_add_multi = other._add_multi;
+	_sum_multi = other._sum_multi;
 	_pow = other._pow;
 	_pow_add = other._pow_add;
 }
@@ -551,27 +777,45 @@ void Galois16Mul::mutScratch_free(void* mutScratch) const {
 	}
 }
 
-Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*outputs*/, unsigned /*threadCountHint*/) {
+// below this many recovery slices, the cost of the XOR methods' prepare/finish transforms outweighs their faster multiply
+#define GF16_XOR_MIN_OUTPUTS 4
+// up to this many recovery slices, skipping the transform passes is worth more than Affine's slightly faster multiply
+#define GF16_AFFINE_NT_MAX_OUTPUTS 8
+
+Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned outputs, unsigned threadCountHint) {
 	const CpuCap caps(true);
 	
 #ifdef PLATFORM_X86
+	// JIT has a fixed cost per coefficient, which is only amortised over large regions
+	bool preferJit = caps.canMemWX && (!regionSizeHint || regionSizeHint > caps.propPrefShuffleThresh);
+	if(outputs && outputs < GF16_XOR_MIN_OUTPUTS && !caps.propSlowShuffle)
+		preferJit = false;
+	// HT only matters if sibling threads will be competing for the same core
+	bool htContention = caps.propHT && threadCountHint != 1;
+	
+	bool preferNonTransform = outputs && outputs <= GF16_AFFINE_NT_MAX_OUTPUTS;
+	
 	if(caps.hasAVX512VLBW) {
 		if(gf16_affine_available_avx512 && caps.hasGFNI)
-			return GF16_AFFINE_AVX512;
+			return preferNonTransform ? GF16_AFFINE2X_NT_AVX512 : GF16_AFFINE_AVX512;
 		if(gf16_shuffle_available_vbmi && caps.hasAVX512VBMI)
 			return GF16_SHUFFLE_VBMI;
 		if(gf16_shuffle_available_avx512)
 			return GF16_SHUFFLE_AVX512;
 	}
 	if(caps.hasAVX2) {
+		if(gf16_affine_available_avx2 && caps.hasGFNI && preferNonTransform)
+			return GF16_AFFINE2X_NT_AVX2;
+		if(gf16_affine_available_avx2 && caps.hasGFNI && gf16_shuffle_available_avx2)
+			return GF16_AFFINE_AVX2;
 # ifndef PLATFORM_AMD64
 		if(gf16_shuffle_available_avx2 && !caps.propAVX128EU)
 			return GF16_SHUFFLE2X_AVX2;
 # endif
-		if(gf16_shuffle_available_avx2 && caps.propHT) // Intel AVX2 CPU with HT - it seems that shuffle256 is roughly same as xor256 so prefer former
+		if(gf16_shuffle_available_avx2 && htContention) // Intel AVX2 CPU with HT - it seems that shuffle256 is roughly same as xor256 so prefer former
 			return GF16_SHUFFLE2X_AVX2;
 # ifdef PLATFORM_AMD64
-		if(gf16_xor_available_avx2 && caps.canMemWX) // TODO: check size hint?
+		if(gf16_xor_available_avx2 && preferJit)
 			return GF16_XOR_JIT_AVX2;
 		if(gf16_shuffle_available_avx2)
 			return GF16_SHUFFLE2X_AVX2;
@@ -579,11 +823,10 @@ Galois16Methods Galois16Mul::default_method(size_t regionSizeHint, unsigned /*ou
 	}
 	if(gf16_affine_available_gfni && caps.hasGFNI && gf16_shuffle_available_ssse3 && caps.hasSSSE3)
 		return GF16_AFFINE_GFNI; // presumably this beats XOR-JIT
-	if(!regionSizeHint || regionSizeHint > caps.propPrefShuffleThresh) {
-		// TODO: if only a few recovery slices being made (e.g. 3), prefer shuffle
-		//if(gf16_xor_available_avx && caps.hasAVX && caps.canMemWX)
+	if(preferJit) {
+		//if(gf16_xor_available_avx && caps.hasAVX)
 		//	return GF16_XOR_JIT_AVX;
-		if(gf16_xor_available_sse2 && caps.hasSSE2 && caps.canMemWX)
+		if(gf16_xor_available_sse2 && caps.hasSSE2)
 			return GF16_XOR_JIT_SSE2;
 	}
 	if(gf16_shuffle_available_avx && caps.hasAVX)
@@ -630,16 +873,32 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 			ret.push_back(GF16_AFFINE_GFNI);
 			ret.push_back(GF16_AFFINE2X_GFNI);
 		}
+		if(gf16_affine_available_avx2 && gf16_shuffle_available_avx2 && caps.hasAVX2) {
+			ret.push_back(GF16_AFFINE_AVX2);
+			ret.push_back(GF16_AFFINE2X_AVX2);
+		}
+		if(gf16_affine_available_avx2 && caps.hasAVX2)
+			ret.push_back(GF16_AFFINE2X_NT_AVX2);
 		if(gf16_affine_available_avx512 && gf16_shuffle_available_avx512 && caps.hasAVX512VLBW) {
 			ret.push_back(GF16_AFFINE_AVX512);
 			ret.push_back(GF16_AFFINE2X_AVX512);
 		}
+		if(gf16_affine_available_avx512 && caps.hasAVX512VLBW)
+			ret.push_back(GF16_AFFINE2X_NT_AVX512);
 	}
+	if(gf16_clmul_available_sse && caps.hasPCLMUL && caps.hasSSE2)
+		ret.push_back(GF16_CLMUL_SSE);
+	if(gf16_clmul_available_avx512 && caps.hasVPCLMUL)
+		ret.push_back(GF16_CLMUL_AVX512);
 	
 	if(gf16_xor_available_sse2 && caps.hasSSE2) {
 		ret.push_back(GF16_XOR_SSE2);
 		ret.push_back(GF16_LOOKUP_SSE2);
 	}
+	if(gf16_lookup_available_avx2 && caps.hasAVX2)
+		ret.push_back(GF16_LOOKUP_AVX2);
+	if(gf16_lookup_available_avx512 && caps.hasAVX512VLBW)
+		ret.push_back(GF16_LOOKUP_AVX512);
 	if(caps.canMemWX) {
 		if(gf16_xor_available_sse2 && caps.hasSSE2)
 			ret.push_back(GF16_XOR_JIT_SSE2);
@@ -659,6 +918,169 @@ std::vector<Galois16Methods> Galois16Mul::availableMethods(bool checkCpuid) {
 	return ret;
 }
 
+std::string Galois16Mul::cpu_signature() {
+	const CpuCap caps(true);
+	char sig[64];
+#ifdef PLATFORM_X86
+	int cpuInfo[4];
+	char vendor[13];
+	_cpuid(cpuInfo, 0);
+	memcpy(vendor, cpuInfo+1, 4);
+	memcpy(vendor+4, cpuInfo+3, 4);
+	memcpy(vendor+8, cpuInfo+2, 4);
+	vendor[12] = 0;
+	_cpuid(cpuInfo, 1);
+	
+	// include detected features, as VMs/OS settings can disable some on the same CPU model
+	unsigned features =
+		  (caps.hasSSE2 ? 1 : 0)
+		| (caps.hasSSSE3 ? 2 : 0)
+		| (caps.hasAVX ? 4 : 0)
+		| (caps.hasAVX2 ? 8 : 0)
+		| (caps.hasAVX512VLBW ? 16 : 0)
+		| (caps.hasAVX512VBMI ? 32 : 0)
+		| (caps.hasGFNI ? 64 : 0)
+		| (caps.propHT ? 128 : 0)
+		| (caps.canMemWX ? 256 : 0)
+		| (caps.hasPCLMUL ? 512 : 0)
+		| (caps.hasVPCLMUL ? 1024 : 0);
+	sprintf(sig, "%s-%08x-%x", vendor, (unsigned)cpuInfo[0], features);
+#elif defined(PLATFORM_ARM)
+	sprintf(sig, "arm%d-%x", (int)sizeof(void*)*8, caps.hasNEON ? 1 : 0);
+#else
+	sprintf(sig, "generic%d", (int)sizeof(void*)*8);
+#endif
+	return std::string(sig);
+}
+
+#ifdef __linux__
+// returns the number of CPUs in a list like "0-3,8-11"
+static unsigned count_cpu_list(const char* list) {
+	unsigned count = 0;
+	while(*list >= '0' && *list <= '9') {
+		char* end;
+		unsigned long from = strtoul(list, &end, 10), to = from;
+		if(*end == '-')
+			to = strtoul(end+1, &end, 10);
+		if(to >= from) count += (unsigned)(to - from + 1);
+		if(*end != ',') break;
+		list = end+1;
+	}
+	return count;
+}
+static bool read_sys_line(const char* path, char* buf, size_t len) {
+	FILE* f = fopen(path, "r");
+	if(!f) return false;
+	bool ret = fgets(buf, (int)len, f) != NULL;
+	fclose(f);
+	return ret;
+}
+// fill in any unknown details from the kernel's view of cpu0's caches
+static void detect_cache_sysfs(Galois16CacheInfo& info) {
+	char path[80], buf[256];
+	for(int i=0; i<16; i++) {
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+		if(!read_sys_line(path, buf, sizeof(buf))) break;
+		int level = atoi(buf);
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+		if(!read_sys_line(path, buf, sizeof(buf)) || buf[0] == 'I') continue; // skip instruction caches
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+		if(!read_sys_line(path, buf, sizeof(buf))) continue;
+		char* unit;
+		size_t size = strtoul(buf, &unit, 10);
+		if(*unit == 'K') size *= 1024;
+		else if(*unit == 'M') size *= 1024*1024;
+		unsigned shared = 0;
+		sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", i);
+		if(read_sys_line(path, buf, sizeof(buf)))
+			shared = count_cpu_list(buf);
+		
+		if(level == 1 && !info.l1d) {
+			info.l1d = size;
+			info.l1dShared = shared;
+		} else if(level == 2 && !info.l2) {
+			info.l2 = size;
+			info.l2Shared = shared;
+		} else if(level == 3 && !info.l3) {
+			info.l3 = size;
+			info.l3Shared = shared;
+		}
+	}
+}
+#endif
+
+const Galois16CacheInfo& Galois16Mul::cache_info() {
+	static Galois16CacheInfo info;
+	static bool detected = false;
+	if(detected) return info;
+	memset(&info, 0, sizeof(info));
+	
+#ifdef PLATFORM_X86
+	int cpuInfo[4];
+	_cpuid(cpuInfo, 0);
+	int maxLeaf = cpuInfo[0];
+	// AMD (and Hygon) report deterministic cache parameters in a separate leaf, if topology extensions are supported
+	bool isAMD = (cpuInfo[1] == 0x68747541 || cpuInfo[1] == 0x6f677948); // "Auth" / "Hygo"
+	unsigned leaf = maxLeaf >= 4 ? 4 : 0;
+	if(isAMD) {
+		leaf = 0;
+		_cpuid(cpuInfo, 0x80000000);
+		if((unsigned)cpuInfo[0] >= 0x8000001D) {
+			_cpuid(cpuInfo, 0x80000001);
+			if(cpuInfo[2] & (1<<22))
+				leaf = 0x8000001D;
+		}
+	}
+# if !defined(_MSC_VER) || _MSC_VER >= 1600
+	for(int i=0; leaf && i<16; i++) {
+		_cpuidX(cpuInfo, leaf, i);
+		int type = cpuInfo[0] & 0x1f;
+		if(type == 0) break;
+		if(type == 2) continue; // instruction cache
+		int level = (cpuInfo[0] >> 5) & 7;
+		unsigned shared = (((unsigned)cpuInfo[0] >> 14) & 0xfff) + 1;
+		size_t size = (size_t)(((unsigned)cpuInfo[1] >> 22) + 1) // ways
+			* ((((unsigned)cpuInfo[1] >> 12) & 0x3ff) + 1) // partitions
+			* (((unsigned)cpuInfo[1] & 0xfff) + 1) // line size
+			* ((unsigned)cpuInfo[2] + 1); // sets
+		if(level == 1) {
+			info.l1d = size;
+			info.l1dShared = shared;
+		} else if(level == 2) {
+			info.l2 = size;
+			info.l2Shared = shared;
+		} else if(level == 3) {
+			info.l3 = size;
+			info.l3Shared = shared;
+		}
+	}
+# endif
+	if(isAMD && !info.l1d) {
+		// legacy AMD cache info leaves
+		_cpuid(cpuInfo, 0x80000000);
+		if((unsigned)cpuInfo[0] >= 0x80000006) {
+			_cpuid(cpuInfo, 0x80000005);
+			info.l1d = ((unsigned)cpuInfo[2] >> 24) * 1024;
+			_cpuid(cpuInfo, 0x80000006);
+			info.l2 = ((unsigned)cpuInfo[2] >> 16) * 1024;
+			info.l3 = ((unsigned)cpuInfo[3] >> 18) * 512*1024;
+		}
+	}
+#endif
+#ifdef __linux__
+	if(!info.l1d || !info.l2 || !info.l3)
+		detect_cache_sysfs(info);
+#endif
+	
+	if(!info.l1d) info.l1d = 32*1024;
+	if(!info.l2) info.l2 = 256*1024;
+	if(!info.l1dShared) info.l1dShared = 1;
+	if(!info.l2Shared) info.l2Shared = 1;
+	if(!info.l3Shared) info.l3Shared = 1;
+	detected = true;
+	return info;
+}
+
 unsigned Galois16Mul::_mul_add_multi_none(const void *HEDLEY_RESTRICT, unsigned, size_t, void *HEDLEY_RESTRICT, const void* const*HEDLEY_RESTRICT, size_t, const uint16_t *HEDLEY_RESTRICT, void *HEDLEY_RESTRICT) {
 	return 0;
 }
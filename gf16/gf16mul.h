@@ -2,6 +2,7 @@
 #include "../src/stdint.h"
 #include "../src/hedley.h"
 #include <vector>
+#include <string>
 #include <cstring>
 
 typedef void(*Galois16MulTransform) (void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen);
@@ -9,6 +10,7 @@ typedef void(*Galois16MulUntransform) (void *HEDLEY_RESTRICT dst, size_t len);
 typedef void(*Galois16MulFunc) (const void *HEDLEY_RESTRICT scratch, void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch);
 typedef void(*Galois16PowFunc) (const void *HEDLEY_RESTRICT scratch, unsigned outputs, size_t offset, void **HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len, uint16_t coefficient, void *HEDLEY_RESTRICT mutScratch);
 typedef unsigned(*Galois16MulMultiFunc) (const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
+typedef unsigned(*Galois16AddMultiFunc) (unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len);
 typedef void(*Galois16AddFunc) (void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t len);
 
 
@@ -33,8 +35,16 @@ enum Galois16Methods {
 	GF16_AFFINE_GFNI,
 	GF16_AFFINE_AVX512,
 	GF16_AFFINE2X_GFNI,
-	GF16_AFFINE2X_AVX512
-	// TODO: consider non-transforming shuffle/affine
+	GF16_AFFINE2X_AVX512,
+	GF16_AFFINE_AVX2,
+	GF16_AFFINE2X_AVX2,
+	GF16_AFFINE2X_NT_AVX2,
+	GF16_AFFINE2X_NT_AVX512,
+	GF16_CLMUL_SSE,
+	GF16_CLMUL_AVX512,
+	GF16_LOOKUP_AVX2,
+	GF16_LOOKUP_AVX512
+	// TODO: consider non-transforming shuffle
 };
 static const char* Galois16MethodsText[] = {
 	"Auto",
@@ -56,7 +66,15 @@ static const char* Galois16MethodsText[] = {
 	"Affine (GFNI)",
 	"Affine (GFNI+AVX512)",
 	"Affine2x (GFNI)",
-	"Affine2x (GFNI+AVX512)"
+	"Affine2x (GFNI+AVX512)",
+	"Affine (GFNI+AVX2)",
+	"Affine2x (GFNI+AVX2)",
+	"Affine2x-NT (GFNI+AVX2)",
+	"Affine2x-NT (GFNI+AVX512)",
+	"CLMul (PCLMUL)",
+	"CLMul (VPCLMUL+AVX512)",
+	"LH Lookup (AVX2)",
+	"LH Lookup (AVX512)"
 };
 
 typedef struct {
@@ -65,8 +83,16 @@ typedef struct {
 	size_t alignment;
 	size_t stride;
 	size_t idealChunkSize;
+	size_t minChunkSize; // smallest chunk worth shrinking to, when fitting many inputs into cache
+	unsigned codeCacheCoeffs; // for methods which cache generated code per coefficient, how many coefficients can be in use before that cache starts thrashing (0 if not applicable)
 } Galois16MethodInfo;
 
+typedef struct {
+	// data/unified cache sizes in bytes, and number of logical CPUs sharing each
+	size_t l1d, l2, l3;
+	unsigned l1dShared, l2Shared, l3Shared;
+} Galois16CacheInfo;
+
 class Galois16Mul {
 private:
 	void* scratch;
@@ -79,6 +105,9 @@ private:
 	Galois16PowFunc _pow;
 	Galois16PowFunc _pow_add;
 	Galois16MulMultiFunc _mul_add_multi;
+	Galois16MulMultiFunc _mul_multi; // NULL if the method has no overwriting multi-region kernel
+	Galois16AddMultiFunc _add_multi; // for unit coefficients; NULL if no vector XOR kernel is available
+	Galois16AddMultiFunc _sum_multi;
 	
 	static unsigned _mul_add_multi_none(const void *HEDLEY_RESTRICT scratch, unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch);
 	static void _prepare_none(void *HEDLEY_RESTRICT dst, const void *HEDLEY_RESTRICT src, size_t srcLen) {
@@ -99,7 +128,8 @@ private:
 	
 public:
 	static Galois16Methods default_method(size_t regionSizeHint = 0, unsigned outputs = 0, unsigned threadCountHint = 0);
-	Galois16Mul(Galois16Methods method = GF16_AUTO);
+	// hints are only used if method is GF16_AUTO, and are passed through to default_method
+	Galois16Mul(Galois16Methods method = GF16_AUTO, size_t regionSizeHint = 0, unsigned outputs = 0, unsigned threadCountHint = 0);
 	~Galois16Mul();
 	
 #if __cplusplus >= 201100
@@ -123,6 +153,10 @@ public:
 	};
 	
 	static std::vector<Galois16Methods> availableMethods(bool checkCpuid);
+	// identifies the host CPU (vendor, family/model/stepping, enabled features); used to key persisted tuning results
+	static std::string cpu_signature();
+	// cache sizes of the host CPU; detected once, with conservative defaults substituted for anything unknown
+	static const Galois16CacheInfo& cache_info();
 	static inline const char* methodToText(Galois16Methods m) {
 		return Galois16MethodsText[(int)m];
 	}
@@ -241,5 +275,54 @@ public:
 			mul_add((uint8_t*)dst+offset, ((uint8_t*)src[region])+offset, len, coefficients[region], mutScratch);
 		}
 	}
+	// as above, but overwrites the destination instead of adding to it, which avoids having to zero it first
+	inline void mul_multi(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len, const uint16_t *HEDLEY_RESTRICT coefficients, void *HEDLEY_RESTRICT mutScratch) const {
+		assert((len & (_info.stride-1)) == 0);
+		assert(len > 0);
+		assert(regions > 0);
+		
+		unsigned region = 0;
+		if(_mul_multi)
+			region = _mul_multi(scratch, regions, offset, dst, src, len, coefficients, mutScratch);
+		if(region == 0) {
+			mul((uint8_t*)dst+offset, ((uint8_t*)src[0])+offset, len, coefficients[0], mutScratch);
+			region = 1;
+		}
+		
+		if(region < regions)
+			mul_add_multi(regions-region, offset, dst, src+region, len, coefficients+region, mutScratch);
+	}
+	
+	// XORs all sources into the destination, i.e. mul_add_multi where all coefficients are 1
+	inline void add_multi(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len) const {
+		assert((len & (_info.stride-1)) == 0);
+		assert(len > 0);
+		assert(regions > 0);
+		
+		unsigned region = 0;
+		if(_add_multi)
+			region = _add_multi(regions, offset, dst, src, len);
+		for(; region<regions; region++)
+			_add((uint8_t*)dst+offset, ((uint8_t*)src[region])+offset, len);
+	}
+	// as above, but overwrites the destination
+	inline void sum_multi(unsigned regions, size_t offset, void *HEDLEY_RESTRICT dst, const void* const*HEDLEY_RESTRICT src, size_t len) const {
+		assert((len & (_info.stride-1)) == 0);
+		assert(len > 0);
+		assert(regions > 0);
+		
+		if(_sum_multi) {
+			unsigned region = _sum_multi(regions, offset, dst, src, len);
+			if(region >= regions) return;
+			src += region;
+			regions -= region;
+		} else {
+			memcpy((uint8_t*)dst+offset, ((uint8_t*)src[0])+offset, len);
+			src++;
+			regions--;
+		}
+		if(regions)
+			add_multi(regions, offset, dst, src, len);
+	}
 	
 };
@@ -1,10 +1,10 @@
-#ifdef _OPENMP
-#include <omp.h>
-#endif
 #include "../src/stdint.h"
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
 #include "gf16mul.h"
+#include "module.h"
+#include "../src/thread_pool.h"
 
 #define CACHELINE_SIZE 64
 
@@ -36,31 +36,87 @@ static inline uint16_t calc_factor(uint_fast16_t inputBlock, uint_fast16_t recov
 	return gf_exp[result];
 }
 
-static Galois16Mul* gf = NULL;
-static std::vector<void*> gfScratch;
+// batch form of calc_factor, for a row of inputs against one recovery block, given the inputs' logarithms
+static void calc_factor_row(uint16_t* dst, const uint16_t* logs, unsigned int numInputs, uint_fast16_t recoveryBlock) {
+	// split into an exponent pass, which the compiler can vectorise, and a table lookup pass
+	uint32_t exps[256];
+	for(unsigned int i = 0; i < numInputs; i += 256) {
+		unsigned int count = numInputs-i < 256 ? numInputs-i : 256;
+		for(unsigned int j = 0; j < count; j++) {
+			uint32_t result = (uint32_t)logs[i+j] * (uint32_t)recoveryBlock;
+			result = (result >> 16) + (result & 65535);
+			result = (result >> 16) + (result & 65535);
+			exps[j] = result;
+		}
+		for(unsigned int j = 0; j < count; j++)
+			dst[i+j] = gf_exp[exps[j]];
+	}
+}
 
-static int maxNumThreads = 1, defaultNumThreads = 1;
+static int defaultNumThreads = 1;
 
-static void setup_gf(Galois16Methods method = GF16_AUTO, size_t size_hint = 0) {
-	if(!gfScratch.empty()) {
-		for(unsigned i=0; i<gfScratch.size(); i++)
-			if(gfScratch[i])
-				gf->mutScratch_free(gfScratch[i]);
-		gfScratch.clear();
-	}
-	delete gf;
-	gf = new Galois16Mul(method);
+// coefficients for a set of inputs against the recovery set: one row per output, each row cacheline aligned
+struct coeff_matrix {
+	std::vector<uint_fast16_t> iNums;
+	uint16_t* coeffs;
+	size_t stride; // row length, in coefficients
+};
+#define COEFF_CACHE_MAX_SIZE (16*1048576) // bytes of coefficients kept per context
+
+// everything needed to run a job; separate contexts can be used concurrently
+struct PPGFContext {
+	Galois16Mul* gf;
+	std::vector<void*> gfScratch;
+	int maxNumThreads;
+	ThreadPool pool;
+	int matSchedule;
+	
+	// coefficient matrices for recently seen input sets; all computed against coeffOutputs
+	std::vector<uint_fast16_t> coeffOutputs;
+	std::vector<coeff_matrix*> coeffCache;
+	size_t coeffCacheSize;
+	
+	PPGFContext() : gf(NULL), maxNumThreads(defaultNumThreads), pool(defaultNumThreads), matSchedule(PPGF_SCHEDULE_AUTO), coeffCacheSize(0) {}
+};
+static void coeff_cache_clear(PPGFContext* ctx);
+
+static void free_scratch(PPGFContext* ctx) {
+	for(unsigned i=0; i<ctx->gfScratch.size(); i++)
+		if(ctx->gfScratch[i])
+			ctx->gf->mutScratch_free(ctx->gfScratch[i]);
+	ctx->gfScratch.clear();
+}
+static void setup_gf(PPGFContext* ctx, Galois16Methods method = GF16_AUTO, size_t size_hint = 0, unsigned outputs_hint = 0) {
+	if(!ctx->gfScratch.empty())
+		free_scratch(ctx);
+	delete ctx->gf;
+	ctx->gf = new Galois16Mul(method, size_hint, outputs_hint, ctx->maxNumThreads);
 	
-	gfScratch.reserve(maxNumThreads);
-	for(int i=0; i<maxNumThreads; i++)
-		gfScratch.push_back(gf->mutScratch_alloc());
+	ctx->gfScratch.reserve(ctx->maxNumThreads);
+	for(int i=0; i<ctx->maxNumThreads; i++)
+		ctx->gfScratch.push_back(ctx->gf->mutScratch_alloc());
 }
-void ppgf_maybe_setup_gf() {
-	if(!gf) setup_gf();
+void ppgf_maybe_setup_gf(PPGFContext* ctx) {
+	if(!ctx->gf) setup_gf(ctx);
 }
 
+PPGFContext* ppgf_create_context() {
+	ppgf_init_gf_module();
+	return new PPGFContext();
+}
+void ppgf_destroy_context(PPGFContext* ctx) {
+	coeff_cache_clear(ctx);
+	if(ctx->gf) {
+		free_scratch(ctx);
+		delete ctx->gf;
+	}
+	delete ctx;
+}
 
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#ifndef MIN
+# define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
 #define CEIL_DIV(a, b) (((a) + (b)-1) / (b))
 #define ROUND_DIV(a, b) (((a) + ((b)>>1)) / (b))
 
@@ -79,6 +135,306 @@ void ppgf_maybe_setup_gf() {
 	#define ALIGN_FREE free
 #endif
 
+typedef struct {
+	uint16_t* coeffs;
+	size_t stride;
+	const uint16_t* logs;
+	unsigned int numInputs;
+	const uint_fast16_t* oNums;
+} coeff_job;
+static void coeff_task(void* arg, unsigned task, unsigned) {
+	const coeff_job* job = (const coeff_job*)arg;
+	calc_factor_row(job->coeffs + task*job->stride, job->logs, job->numInputs, job->oNums[task]);
+}
+// computes the coefficient matrix for the given inputs/outputs, which the caller must ALIGN_FREE; rows are computed in parallel
+static uint16_t* calc_coeff_matrix(ThreadPool* pool, const uint_fast16_t* iNums, unsigned int numInputs, const uint_fast16_t* oNums, unsigned int numOutputs, size_t* stride) {
+	coeff_job job;
+	job.stride = (numInputs + CACHELINE_SIZE/2-1) & ~(size_t)(CACHELINE_SIZE/2-1);
+	ALIGN_ALLOC(job.coeffs, job.stride * numOutputs * sizeof(uint16_t), CACHELINE_SIZE);
+	
+	// input logarithms are shared by all rows
+	std::vector<uint16_t> logs(numInputs + 1);
+	for(unsigned int i = 0; i < numInputs; i++)
+		logs[i] = input_lookup[iNums[i]];
+	job.logs = &logs[0];
+	job.numInputs = numInputs;
+	job.oNums = oNums;
+	pool->run(numOutputs, &coeff_task, &job);
+	
+	*stride = job.stride;
+	return job.coeffs;
+}
+
+static void coeff_cache_clear(PPGFContext* ctx) {
+	for(unsigned i=0; i<ctx->coeffCache.size(); i++) {
+		ALIGN_FREE(ctx->coeffCache[i]->coeffs);
+		delete ctx->coeffCache[i];
+	}
+	ctx->coeffCache.clear();
+	ctx->coeffCacheSize = 0;
+}
+// returns the coefficient matrix for the job, from the cache if it's been seen before
+// if the matrix couldn't be cached, *uncached is set to it, for the caller to free
+static const uint16_t* get_coeff_matrix(PPGFContext* ctx, const uint_fast16_t* iNums, unsigned int numInputs, const uint_fast16_t* oNums, unsigned int numOutputs, size_t* stride, uint16_t** uncached) {
+	*uncached = NULL;
+	if(ctx->coeffOutputs.size() != numOutputs || !std::equal(ctx->coeffOutputs.begin(), ctx->coeffOutputs.end(), oNums)) {
+		// recovery set changed, nothing cached is usable
+		coeff_cache_clear(ctx);
+		ctx->coeffOutputs.assign(oNums, oNums + numOutputs);
+	}
+	for(unsigned i=0; i<ctx->coeffCache.size(); i++) {
+		const coeff_matrix* m = ctx->coeffCache[i];
+		if(m->iNums.size() == numInputs && std::equal(m->iNums.begin(), m->iNums.end(), iNums)) {
+			*stride = m->stride;
+			return m->coeffs;
+		}
+	}
+	
+	uint16_t* coeffs = calc_coeff_matrix(&ctx->pool, iNums, numInputs, oNums, numOutputs, stride);
+	size_t size = *stride * numOutputs * sizeof(uint16_t);
+	// once full, entries are kept rather than evicted: chunked passes revisit input batches in the same order, where LRU would always miss
+	if(ctx->coeffCacheSize + size <= COEFF_CACHE_MAX_SIZE) {
+		coeff_matrix* m = new coeff_matrix;
+		m->iNums.assign(iNums, iNums + numInputs);
+		m->coeffs = coeffs;
+		m->stride = *stride;
+		ctx->coeffCache.push_back(m);
+		ctx->coeffCacheSize += size;
+	} else
+		*uncached = coeffs;
+	return coeffs;
+}
+
+typedef struct {
+	int schedule;
+	unsigned int numChunks;
+	size_t chunkSize;
+	size_t subChunkSize; // tiles are walked through in pieces of this size, to keep outputs in L1 (equals chunkSize if not needed)
+	unsigned int inputGroup, outputGroup;
+	unsigned int numSplits; // number of input partitions, each accumulated separately
+	unsigned int segmentChunks; // number of chunks processed at a time when splitting inputs
+} mat_schedule;
+
+// every output pass over a chunk streams through all inputs; if those input chunks fit in L2, they get re-used across outputs instead of being re-fetched from L3/memory
+static size_t calc_chunk_size(const Galois16Mul* gf, unsigned int numInputs) {
+	const Galois16MethodInfo& info = gf->info();
+	const Galois16CacheInfo& cache = Galois16Mul::cache_info();
+	size_t chunkSize = info.idealChunkSize;
+	if(numInputs) {
+		// only target half of this thread's L2 share, leaving space for the output and lookup tables
+		size_t l2Fit = cache.l2 / cache.l2Shared / 2 / numInputs;
+		if(l2Fit < chunkSize)
+			chunkSize = l2Fit > info.minChunkSize ? l2Fit : info.minChunkSize;
+	}
+	return chunkSize;
+}
+
+// the work is split into tasks of (chunk x output group); each task walks through the inputs a group at a time, applying every input group to all outputs in the group
+// the flat schedule is simply the case of one output per group and all inputs in one group
+static void plan_tiles(const Galois16Mul* gf, int schedule, int numThreads, unsigned int numInputs, size_t len, unsigned int numOutputs, mat_schedule* plan) {
+	const Galois16CacheInfo& cache = Galois16Mul::cache_info();
+	size_t l2PerThread = cache.l2 / cache.l2Shared;
+	
+	// break the slice into smaller chunks so that we maximise CPU cache usage
+	int numChunks = ROUND_DIV(len, calc_chunk_size(gf, numInputs));
+	if(numChunks < 1) numChunks = 1;
+	unsigned int alignMask = gf->info().stride-1;
+	plan->chunkSize = (CEIL_DIV(len, numChunks) + alignMask) & ~alignMask; // we'll assume that input chunks are memory aligned here
+	plan->numChunks = CEIL_DIV(len, plan->chunkSize); // alignment rounding may leave fewer chunks necessary
+	
+	plan->schedule = schedule;
+	plan->subChunkSize = plan->chunkSize;
+	plan->inputGroup = numInputs;
+	plan->outputGroup = 1;
+	if(plan->schedule == PPGF_SCHEDULE_FLAT) return;
+	
+	// if all input chunks fit in cache, the flat schedule already avoids re-fetching them
+	// this doesn't apply to methods caching generated code, which want to use small tiles instead
+	const Galois16MethodInfo& info = gf->info();
+	if(plan->schedule == PPGF_SCHEDULE_AUTO && !info.codeCacheCoeffs && numInputs * plan->chunkSize <= l2PerThread/2) {
+		plan->schedule = PPGF_SCHEDULE_FLAT;
+		return;
+	}
+	
+	// an input group takes half of L2, whilst a quarter holds the output group's chunks, which get revisited for every input group
+	unsigned int inputGroup = (unsigned)(l2PerThread/2 / plan->chunkSize);
+	unsigned int outputGroup = (unsigned)(l2PerThread/4 / plan->chunkSize);
+	if(inputGroup < 1) inputGroup = 1;
+	if(inputGroup > numInputs) inputGroup = numInputs;
+	if(outputGroup > numOutputs) outputGroup = numOutputs;
+	// don't starve threads of tasks
+	while(outputGroup > 1 && plan->numChunks * CEIL_DIV(numOutputs, outputGroup) < (unsigned)numThreads)
+		outputGroup = CEIL_DIV(outputGroup, 2);
+	
+	if(outputGroup < 1) outputGroup = 1;
+	plan->schedule = PPGF_SCHEDULE_BLOCKED;
+	
+	if(info.codeCacheCoeffs) {
+		// chunks are kept large for methods that generate code per coefficient, but if all of a tile's coefficients stay in the method's code cache, the tile can be processed in L1-sized pieces without re-generating any code
+		while(inputGroup * outputGroup > info.codeCacheCoeffs) {
+			if(inputGroup > outputGroup)
+				inputGroup = CEIL_DIV(inputGroup, 2);
+			else
+				outputGroup = CEIL_DIV(outputGroup, 2);
+		}
+		size_t subChunkSize = (cache.l1d / 2) & ~(size_t)alignMask;
+		if(subChunkSize < info.stride) subChunkSize = info.stride;
+		if(subChunkSize < plan->chunkSize) plan->subChunkSize = subChunkSize;
+	}
+	
+	// evenly size groups so that the last isn't tiny
+	plan->inputGroup = CEIL_DIV(numInputs, CEIL_DIV(numInputs, inputGroup));
+	plan->outputGroup = CEIL_DIV(numOutputs, CEIL_DIV(numOutputs, outputGroup));
+}
+
+#define MAT_POW_MAX_RUN 32 // longest chain of outputs generated per pass over an input
+// each task streams through all inputs once, whilst its group of outputs is revisited for every input, so it's the output group which is sized to stay in L2
+static void plan_pow(const Galois16Mul* gf, int numThreads, size_t len, unsigned int numOutputs, mat_schedule* plan) {
+	const Galois16MethodInfo& info = gf->info();
+	const Galois16CacheInfo& cache = Galois16Mul::cache_info();
+	size_t l2PerThread = cache.l2 / cache.l2Shared;
+	
+	unsigned int outputGroup = MIN(numOutputs, MAT_POW_MAX_RUN);
+	// table/code generation is only done once per input for the whole group, so chunks can go below the method's usual minimum
+	size_t chunkSize = l2PerThread/2 / outputGroup;
+	if(chunkSize > info.idealChunkSize) chunkSize = info.idealChunkSize;
+	if(chunkSize < 4096) chunkSize = 4096;
+	
+	int numChunks = ROUND_DIV(len, chunkSize);
+	if(numChunks < 1) numChunks = 1;
+	unsigned int alignMask = info.stride-1;
+	plan->chunkSize = (CEIL_DIV(len, numChunks) + alignMask) & ~alignMask;
+	plan->numChunks = CEIL_DIV(len, plan->chunkSize);
+	plan->subChunkSize = plan->chunkSize;
+	
+	// don't starve threads of tasks
+	while(outputGroup > 1 && plan->numChunks * CEIL_DIV(numOutputs, outputGroup) < (unsigned)numThreads)
+		outputGroup = CEIL_DIV(outputGroup, 2);
+	
+	plan->schedule = PPGF_SCHEDULE_POW;
+	plan->outputGroup = CEIL_DIV(numOutputs, CEIL_DIV(numOutputs, outputGroup));
+	plan->numSplits = 1;
+	plan->segmentChunks = plan->numChunks;
+}
+
+#define MAT_SPLIT_MIN_INPUTS 4 // don't bother splitting if each thread would get fewer inputs than this
+static void plan_schedule(const Galois16Mul* gf, int matSchedule, int numThreads, unsigned int numInputs, size_t len, unsigned int numOutputs, mat_schedule* plan) {
+	if(matSchedule == PPGF_SCHEDULE_POW) {
+		if(gf->hasPowAdd()) {
+			plan_pow(gf, numThreads, len, numOutputs, plan);
+			plan->inputGroup = numInputs;
+			return;
+		}
+		matSchedule = PPGF_SCHEDULE_AUTO;
+	}
+	plan_tiles(gf, matSchedule == PPGF_SCHEDULE_SPLIT ? PPGF_SCHEDULE_AUTO : matSchedule, numThreads, numInputs, len, numOutputs, plan);
+	plan->numSplits = 1;
+	plan->segmentChunks = plan->numChunks;
+	
+	// if there's too few output tasks to occupy all threads (e.g. few recovery slices), also partition the inputs, with each partition accumulating into private buffers that get merged afterwards
+	unsigned int tasks = plan->numChunks * CEIL_DIV(numOutputs, plan->outputGroup);
+	unsigned int numSplits = 1;
+	if(matSchedule == PPGF_SCHEDULE_SPLIT)
+		numSplits = numThreads > 2 ? numThreads : 2;
+	else if(matSchedule == PPGF_SCHEDULE_AUTO && tasks < (unsigned)numThreads) {
+		numSplits = CEIL_DIV(numThreads, tasks);
+		if(numSplits > numInputs / MAT_SPLIT_MIN_INPUTS) numSplits = numInputs / MAT_SPLIT_MIN_INPUTS;
+	}
+	if(numSplits > numInputs) numSplits = numInputs;
+	if(numSplits < 2) return;
+	
+	plan->schedule = PPGF_SCHEDULE_SPLIT;
+	plan->numSplits = numSplits;
+	// limit the private buffers to a segment of the slice, sized to stay within L3 for the merge
+	const Galois16CacheInfo& cache = Galois16Mul::cache_info();
+	size_t scratchLimit = cache.l3 ? cache.l3/2 : 8*1048576;
+	size_t segmentChunks = scratchLimit / ((numSplits-1) * numOutputs * plan->chunkSize);
+	if(segmentChunks < 1) segmentChunks = 1;
+	if(segmentChunks < plan->segmentChunks) plan->segmentChunks = (unsigned)segmentChunks;
+}
+
+// rows where every coefficient is 1 (e.g. the first recovery block) are just an XOR of the inputs
+static inline bool coeffs_all_one(const uint16_t* coeffs, unsigned int count) {
+	for(unsigned int i = 0; i < count; i++)
+		if(coeffs[i] != 1) return false;
+	return true;
+}
+
+// multiplies a range of inputs into a group of outputs for one chunk
+static inline void multiply_tile(const Galois16Mul* gf, void* scratch, const uint16_t* coeffs, size_t coeffStride, const void* const* inputs, unsigned int numInputs, unsigned int inputGroup, size_t offset, size_t procSize, size_t subChunkSize, void** outputs, unsigned int outFirst, unsigned int outEnd, int add) {
+	unsigned int out;
+	if(!add && !numInputs) {
+		for(out = outFirst; out < outEnd; out++)
+			memset(((uint8_t*)outputs[out])+offset, 0, procSize);
+	}
+	
+	for(unsigned int in = 0; in < numInputs; in += inputGroup) {
+		unsigned int inCount = MIN(inputGroup, numInputs-in);
+		for(size_t sub = 0; sub < procSize; sub += subChunkSize) {
+			size_t subSize = MIN(subChunkSize, procSize-sub);
+			// if not adding, the first group of inputs overwrites the outputs, so they don't need to be zeroed beforehand
+			for(out = outFirst; out < outEnd; out++) {
+				const uint16_t* rowCoeffs = coeffs + out*coeffStride + in;
+				if(coeffs_all_one(rowCoeffs, inCount)) {
+					if(in == 0 && !add)
+						gf->sum_multi(inCount, offset+sub, outputs[out], inputs, subSize);
+					else
+						gf->add_multi(inCount, offset+sub, outputs[out], inputs + in, subSize);
+				} else if(in == 0 && !add)
+					gf->mul_multi(inCount, offset+sub, outputs[out], inputs, subSize, rowCoeffs, scratch);
+				else
+					gf->mul_add_multi(inCount, offset+sub, outputs[out], inputs + in, subSize, rowCoeffs, scratch);
+			}
+		}
+	}
+}
+
+typedef struct {
+	const Galois16Mul* gf;
+	void** scratch;
+	const uint16_t* coeffs;
+	size_t coeffStride;
+	const mat_schedule* plan;
+	const void* const* inputs;
+	unsigned int numInputs;
+	size_t len;
+	void** outputs; // for the split schedule, numSplits sets of outputs, the first being the real outputs
+	unsigned int numOutputs;
+	unsigned int numOutGroups;
+	int add;
+} mat_job;
+
+// tasks go through output groups before chunks
+static void mat_task(void* arg, unsigned task, unsigned threadNum) {
+	const mat_job* job = (const mat_job*)arg;
+	const mat_schedule* plan = job->plan;
+	size_t offset = (task / job->numOutGroups) * plan->chunkSize;
+	unsigned int outFirst = (task % job->numOutGroups) * plan->outputGroup;
+	multiply_tile(job->gf, job->scratch[threadNum], job->coeffs, job->coeffStride, job->inputs, job->numInputs, plan->inputGroup, offset, MIN(job->len-offset, plan->chunkSize), plan->subChunkSize, job->outputs, outFirst, MIN(outFirst + plan->outputGroup, job->numOutputs), job->add);
+}
+// as above, but also goes through input partitions, each accumulating into its own set of outputs
+static void mat_split_task(void* arg, unsigned task, unsigned threadNum) {
+	const mat_job* job = (const mat_job*)arg;
+	const mat_schedule* plan = job->plan;
+	unsigned int split = task % plan->numSplits;
+	task /= plan->numSplits;
+	size_t offset = (task / job->numOutGroups) * plan->chunkSize;
+	unsigned int outFirst = (task % job->numOutGroups) * plan->outputGroup;
+	unsigned int inFirst = (unsigned)((uint64_t)job->numInputs * split / plan->numSplits);
+	unsigned int inEnd = (unsigned)((uint64_t)job->numInputs * (split+1) / plan->numSplits);
+	multiply_tile(job->gf, job->scratch[threadNum], job->coeffs + inFirst, job->coeffStride, job->inputs + inFirst, inEnd - inFirst, plan->inputGroup, offset, MIN(job->len-offset, plan->chunkSize), plan->subChunkSize, job->outputs + split*job->numOutputs, outFirst, MIN(outFirst + plan->outputGroup, job->numOutputs), split ? 0 : job->add);
+}
+// merge input partitions into the outputs
+static void mat_merge_task(void* arg, unsigned task, unsigned threadNum) {
+	const mat_job* job = (const mat_job*)arg;
+	const mat_schedule* plan = job->plan;
+	unsigned int out = task % job->numOutputs;
+	size_t offset = (task / job->numOutputs) * plan->chunkSize;
+	size_t procSize = MIN(job->len-offset, plan->chunkSize);
+	for(unsigned int split = 1; split < plan->numSplits; split++)
+		job->gf->mul_add((uint8_t*)job->outputs[out] + offset, (uint8_t*)job->outputs[split*job->numOutputs + out] + offset, procSize, 1, job->scratch[threadNum]);
+}
+
 // performs multiple multiplies for a region, using threads
 // note that inputs will get trashed
 /* REQUIRES:
@@ -86,8 +442,9 @@ void ppgf_maybe_setup_gf() {
    - len must be a multiple of stride
    - input and length of each output is the same and == len
    - number of outputs and scales is same and == numOutputs
+   - coeffs holds a row of numInputs coefficients for each output
 */
-void ppgf_multiply_mat(const void* const* inputs, uint_fast16_t* iNums, unsigned int numInputs, size_t len, void** outputs, uint_fast16_t* oNums, unsigned int numOutputs, int add) {
+static void multiply_mat(const Galois16Mul* gf, void** scratch, ThreadPool* pool, int schedule, const uint16_t* coeffs, size_t coeffStride, const void* const* inputs, unsigned int numInputs, size_t len, void** outputs, unsigned int numOutputs, int add) {
 	
 	/*
 	if(gf->needPrepare()) {
@@ -111,96 +468,405 @@ void ppgf_multiply_mat(const void* const* inputs, uint_fast16_t* iNums, unsigned
 	}
 	*/
 	
-	unsigned int factStride = sizeof(uint16_t) * numInputs;
-	factStride = (factStride + CACHELINE_SIZE-1) & ~(CACHELINE_SIZE-1);
-	uint16_t* factors;
-	ALIGN_ALLOC(factors, factStride * maxNumThreads, CACHELINE_SIZE);
+	mat_job job;
+	mat_schedule plan;
+	plan_schedule(gf, schedule, pool->threads(), numInputs, len, numOutputs, &plan);
+	job.gf = gf;
+	job.scratch = scratch;
+	job.coeffs = coeffs;
+	job.coeffStride = coeffStride;
+	job.plan = &plan;
+	job.inputs = inputs;
+	job.numInputs = numInputs;
+	job.len = len;
+	job.outputs = outputs;
+	job.numOutputs = numOutputs;
+	job.numOutGroups = CEIL_DIV(numOutputs, plan.outputGroup);
+	job.add = add;
 	
-	// break the slice into smaller chunks so that we maximise CPU cache usage
-	int numChunks = ROUND_DIV(len, gf->info().idealChunkSize);
-	if(numChunks < 1) numChunks = 1;
-	unsigned int alignMask = gf->info().stride-1;
-	unsigned int chunkSize = (CEIL_DIV(len, numChunks) + alignMask) & ~alignMask; // we'll assume that input chunks are memory aligned here
-	
-	// avoid nested loop issues by combining chunk & output loop into one
-	// the loop goes through outputs before chunks
-	int loop = 0;
-	#pragma omp parallel for num_threads(maxNumThreads)
-	for(loop = 0; loop < (int)(numOutputs * numChunks); loop++) {
-		size_t offset = (loop / numOutputs) * chunkSize;
-		unsigned int out = loop % numOutputs;
-		int procSize = MIN(len-offset, chunkSize);
-#ifdef _OPENMP
-		int threadNum = omp_get_thread_num();
-#else
-		const int threadNum = 0;
-#endif
-		uint16_t* vals = (uint16_t*)((uint8_t*)factors + factStride * threadNum);
-		unsigned int i;
-		for(i=0; i<numInputs; i++)
-			vals[i] = calc_factor(iNums[i], oNums[out]);
+	if(plan.schedule != PPGF_SCHEDULE_SPLIT) {
+		pool->run(job.numOutGroups * plan.numChunks, &mat_task, &job);
+	} else {
+		// input partition 0 goes directly to the outputs, the others to private buffers covering one segment of the slice
+		unsigned int numSplits = plan.numSplits;
+		size_t segmentLen = plan.segmentChunks * plan.chunkSize;
+		uint8_t* partials;
+		ALIGN_ALLOC(partials, (numSplits-1) * numOutputs * segmentLen, CACHELINE_SIZE);
+		const void** segInputs = (const void**)malloc(numInputs * sizeof(void*));
+		void** segOutputs = (void**)malloc(numSplits * numOutputs * sizeof(void*));
+		for(unsigned int split = 1; split < numSplits; split++)
+			for(unsigned int out = 0; out < numOutputs; out++)
+				segOutputs[split*numOutputs + out] = partials + ((split-1)*numOutputs + out) * segmentLen;
+		job.inputs = segInputs;
+		job.outputs = segOutputs;
+		
+		for(size_t segStart = 0; segStart < len; segStart += segmentLen) {
+			job.len = MIN(len - segStart, segmentLen);
+			unsigned int segChunks = CEIL_DIV(job.len, plan.chunkSize);
+			for(unsigned int in = 0; in < numInputs; in++)
+				segInputs[in] = (const uint8_t*)inputs[in] + segStart;
+			for(unsigned int out = 0; out < numOutputs; out++)
+				segOutputs[out] = (uint8_t*)outputs[out] + segStart;
+			
+			pool->run(numSplits * segChunks * job.numOutGroups, &mat_split_task, &job);
+			pool->run(numOutputs * segChunks, &mat_merge_task, &job);
+		}
+		
+		free(segOutputs);
+		free(segInputs);
+		ALIGN_FREE(partials);
+	}
+}
+
+
+typedef struct {
+	const Galois16Mul* gf;
+	void** scratch;
+	const mat_schedule* plan;
+	const void* const* inputs;
+	const uint_fast16_t* iNums;
+	unsigned int numInputs;
+	size_t len;
+	void** outputs;
+	const uint_fast16_t* oNums;
+	unsigned int numOutputs;
+	unsigned int numOutGroups;
+	uint8_t* scaled; // a chunk per thread, for inputs scaled to the start of a run
+	int add;
+} mat_pow_job;
+
+static void mat_pow_task(void* arg, unsigned task, unsigned threadNum) {
+	const mat_pow_job* job = (const mat_pow_job*)arg;
+	const mat_schedule* plan = job->plan;
+	const Galois16Mul* gf = job->gf;
+	void* scratch = job->scratch[threadNum];
+	size_t offset = (task / job->numOutGroups) * plan->chunkSize;
+	size_t procSize = MIN(job->len-offset, plan->chunkSize);
+	unsigned int outFirst = (task % job->numOutGroups) * plan->outputGroup;
+	unsigned int outEnd = MIN(outFirst + plan->outputGroup, job->numOutputs);
+	
+	unsigned int out;
+	if(!job->add) {
+		for(out = outFirst; out < outEnd; out++)
+			memset(((uint8_t*)job->outputs[out])+offset, 0, procSize);
+	}
+	
+	void* dst[MAT_POW_MAX_RUN];
+	for(unsigned int in = 0; in < job->numInputs; in++) {
+		const uint8_t* src = (const uint8_t*)job->inputs[in] + offset;
+		uint16_t base = calc_factor(job->iNums[in], 1);
+		for(out = outFirst; out < outEnd; ) {
+			// find the run of consecutive exponents starting here
+			unsigned int runEnd = out+1;
+			while(runEnd < outEnd && job->oNums[runEnd] == job->oNums[runEnd-1]+1)
+				runEnd++;
+			
+			// pow_add starts the chain at the first power of the input's constant, so other starting exponents need the input scaled first
+			const void* runSrc = src;
+			unsigned int runStart = out;
+			uint_fast16_t exp = job->oNums[out];
+			if(exp == 0) {
+				gf->mul_add((uint8_t*)job->outputs[out] + offset, src, procSize, 1, scratch);
+				runStart++;
+			} else if(exp > 1) {
+				uint8_t* scaled = job->scaled + threadNum * plan->chunkSize;
+				gf->mul(scaled, src, procSize, calc_factor(job->iNums[in], exp-1), scratch);
+				runSrc = scaled;
+			}
+			if(runStart < runEnd) {
+				for(unsigned int i = runStart; i < runEnd; i++)
+					dst[i-runStart] = (uint8_t*)job->outputs[i] + offset;
+				gf->pow_add(runEnd-runStart, 0, dst, runSrc, procSize, base, scratch);
+			}
+			out = runEnd;
+		}
+	}
+}
 
-		if(!add) memset(((uint8_t*)outputs[out])+offset, 0, procSize);
-		gf->mul_add_multi(numInputs, offset, outputs[out], inputs, procSize, vals, gfScratch[threadNum]);
+// as multiply_mat, but uses the PPGF_SCHEDULE_POW schedule, which computes coefficients itself
+static void multiply_mat_pow(const Galois16Mul* gf, void** scratch, ThreadPool* pool, const void* const* inputs, const uint_fast16_t* iNums, unsigned int numInputs, size_t len, void** outputs, const uint_fast16_t* oNums, unsigned int numOutputs, int add) {
+	mat_pow_job job;
+	mat_schedule plan;
+	plan_schedule(gf, PPGF_SCHEDULE_POW, pool->threads(), numInputs, len, numOutputs, &plan);
+	job.gf = gf;
+	job.scratch = scratch;
+	job.plan = &plan;
+	job.inputs = inputs;
+	job.iNums = iNums;
+	job.numInputs = numInputs;
+	job.len = len;
+	job.outputs = outputs;
+	job.oNums = oNums;
+	job.numOutputs = numOutputs;
+	job.numOutGroups = CEIL_DIV(numOutputs, plan.outputGroup);
+	job.add = add;
+	
+	// scaled inputs are only needed if a run starts above the first power
+	job.scaled = NULL;
+	for(unsigned int out = 0; out < numOutputs; out++) {
+		bool runStart = (out % plan.outputGroup) == 0 || oNums[out] != oNums[out-1]+1;
+		if(runStart && oNums[out] > 1) {
+			ALIGN_ALLOC(job.scaled, pool->threads() * plan.chunkSize, CACHELINE_SIZE);
+			break;
+		}
 	}
 	
-	ALIGN_FREE(factors);
+	pool->run(job.numOutGroups * plan.numChunks, &mat_pow_task, &job);
+	
+	if(job.scaled) ALIGN_FREE(job.scaled);
 }
 
 
-void ppgf_prep_input(size_t destLen, size_t inputLen, char* dest, char* src) {
-	ppgf_maybe_setup_gf();
+void ppgf_multiply_mat(PPGFContext* ctx, const void* const* inputs, uint_fast16_t* iNums, unsigned int numInputs, size_t len, void** outputs, uint_fast16_t* oNums, unsigned int numOutputs, int add) {
+	if(ctx->matSchedule == PPGF_SCHEDULE_POW && ctx->gf->hasPowAdd()) {
+		multiply_mat_pow(ctx->gf, &ctx->gfScratch[0], &ctx->pool, inputs, iNums, numInputs, len, outputs, oNums, numOutputs, add);
+		return;
+	}
+	size_t coeffStride;
+	uint16_t* uncached;
+	const uint16_t* coeffs = get_coeff_matrix(ctx, iNums, numInputs, oNums, numOutputs, &coeffStride, &uncached);
+	multiply_mat(ctx->gf, &ctx->gfScratch[0], &ctx->pool, ctx->matSchedule, coeffs, coeffStride, inputs, numInputs, len, outputs, numOutputs, add);
+	if(uncached) ALIGN_FREE(uncached);
+}
+
+
+void ppgf_prep_input(PPGFContext* ctx, size_t destLen, size_t inputLen, char* dest, char* src) {
+	ppgf_maybe_setup_gf(ctx);
 	if(inputLen < destLen) {
 		// need to zero out empty space at end (for final block)
 		memset(dest + inputLen, 0, destLen - inputLen);
 	}
-	gf->prepare(dest, src, inputLen);
+	ctx->gf->prepare(dest, src, inputLen);
 }
-void ppgf_finish_input(unsigned int numInputs, uint16_t** inputs, size_t len) {
-	ppgf_maybe_setup_gf();
-	if(gf->needPrepare()) {
-		// TODO: multi-thread this?
-		for(int in = 0; in < (int)numInputs; in++)
-			gf->finish(inputs[in], len);
+typedef struct {
+	const Galois16Mul* gf;
+	uint16_t** inputs;
+	size_t len;
+} finish_job;
+static void finish_task(void* arg, unsigned task, unsigned) {
+	const finish_job* job = (const finish_job*)arg;
+	job->gf->finish(job->inputs[task], job->len);
+}
+void ppgf_finish_input(PPGFContext* ctx, unsigned int numInputs, uint16_t** inputs, size_t len) {
+	ppgf_maybe_setup_gf(ctx);
+	if(ctx->gf->needPrepare()) {
+		finish_job job;
+		job.gf = ctx->gf;
+		job.inputs = inputs;
+		job.len = len;
+		ctx->pool.run(numInputs, &finish_task, &job);
 	}
 }
 
-void ppgf_get_method(int* rMethod, const char** rMethLong, int* align, int* stride) {
-	ppgf_maybe_setup_gf();
-	const Galois16MethodInfo& info = gf->info();
+void ppgf_finish_partial(PPGFContext* ctx, void* data, size_t len) {
+	if(ctx->gf->needPrepare())
+		ctx->gf->finish(data, len);
+}
+
+void ppgf_get_method(PPGFContext* ctx, int* rMethod, const char** rMethLong, int* align, int* stride) {
+	ppgf_maybe_setup_gf(ctx);
+	const Galois16MethodInfo& info = ctx->gf->info();
 	*rMethod = info.id;
 	*rMethLong = info.name;
 	*align = info.alignment;
 	*stride = info.stride;
 }
 
-int ppgf_get_num_threads() {
-#ifdef _OPENMP
-	return maxNumThreads;
-#else
-	return 1;
-#endif
+void ppgf_set_schedule(PPGFContext* ctx, int schedule) {
+	ctx->matSchedule = schedule;
 }
-void ppgf_set_num_threads(int threads) {
-#ifdef _OPENMP
-	maxNumThreads = threads;
-	if(maxNumThreads < 1) maxNumThreads = defaultNumThreads;
-	if(gf && (unsigned)maxNumThreads > gfScratch.size()) {
-		gfScratch.reserve(maxNumThreads);
-		for(unsigned i=gfScratch.size(); i<(unsigned)maxNumThreads; i++)
-			gfScratch.push_back(gf->mutScratch_alloc());
+void ppgf_get_schedule(PPGFContext* ctx, unsigned int numInputs, size_t len, unsigned int numOutputs, int* schedule, size_t* chunkSize, unsigned int* inputGroup, unsigned int* outputGroup, unsigned int* inputSplits) {
+	ppgf_maybe_setup_gf(ctx);
+	mat_schedule plan;
+	plan_schedule(ctx->gf, ctx->matSchedule, ctx->maxNumThreads, numInputs, len, numOutputs, &plan);
+	*schedule = plan.schedule;
+	*chunkSize = plan.chunkSize;
+	*inputGroup = plan.inputGroup;
+	*outputGroup = plan.outputGroup;
+	*inputSplits = plan.numSplits;
+}
+
+int ppgf_get_num_threads(PPGFContext* ctx) {
+	return ctx->maxNumThreads;
+}
+void ppgf_set_num_threads(PPGFContext* ctx, int threads) {
+	ctx->maxNumThreads = threads;
+	if(ctx->maxNumThreads < 1) ctx->maxNumThreads = defaultNumThreads;
+	if(ctx->gf && (unsigned)ctx->maxNumThreads > ctx->gfScratch.size()) {
+		ctx->gfScratch.reserve(ctx->maxNumThreads);
+		for(unsigned i=ctx->gfScratch.size(); i<(unsigned)ctx->maxNumThreads; i++)
+			ctx->gfScratch.push_back(ctx->gf->mutScratch_alloc());
 	}
-#endif
+	ctx->pool.setThreads(ctx->maxNumThreads);
+}
+
+static uv_once_t initOnce = UV_ONCE_INIT;
+static void init_gf_module() {
+	ppgf_init_constants();
+	Galois16Mul::cache_info(); // detect now, so that contexts on different threads don't race to do so
+	
+	uv_cpu_info_t* cpus;
+	int numCpus = 0;
+	uv_cpu_info(&cpus, &numCpus); // return type differs across libuv versions, so rely on numCpus instead
+	if(numCpus > 0)
+		uv_free_cpu_info(cpus, numCpus);
+	defaultNumThreads = numCpus > 0 ? numCpus : 1;
 }
+// safe to call multiple times, e.g. once for each worker thread loading the module
 void ppgf_init_gf_module() {
-#ifdef _OPENMP
-	maxNumThreads = omp_get_num_procs();
-	if(maxNumThreads < 1) maxNumThreads = 1;
-	defaultNumThreads = maxNumThreads;
-#endif
+	uv_once(&initOnce, &init_gf_module);
+}
+
+void ppgf_run_tasks(PPGFContext* ctx, unsigned int numTasks, void(*func)(void*, unsigned, unsigned), void* arg) {
+	ctx->pool.run(numTasks, func, arg);
 }
 
-int ppgf_set_method(int meth, int size_hint) {
-	setup_gf((Galois16Methods)meth, size_hint);
+int ppgf_set_method(PPGFContext* ctx, int meth, size_t size_hint, unsigned outputs_hint) {
+	setup_gf(ctx, (Galois16Methods)meth, size_hint, outputs_hint);
 	return 0;
 }
+
+
+#define TIMER_NOW() ((double)uv_hrtime() / 1e9)
+#include <stdio.h>
+
+// parameters for the autotune benchmark; region size + outputs are capped to keep the test short, beyond these, relative method performance doesn't change much
+#define AUTOTUNE_MAX_REGION (1024*1024)
+#define AUTOTUNE_MIN_REGION 4096
+#define AUTOTUNE_DEFAULT_OUTPUTS 16
+#define AUTOTUNE_MAX_OUTPUTS 32
+#define AUTOTUNE_INPUTS 16
+#define AUTOTUNE_MIN_TIME 0.05 // seconds
+
+// returns throughput (bytes/sec) of a method on the given job shape, or 0 if the method can't be used
+static double autotune_bench(PPGFContext* ctx, Galois16Methods method, size_t regionSize, unsigned numOutputs) {
+	Galois16Mul testGf(method);
+	const Galois16MethodInfo& info = testGf.info();
+	if(info.id != method) return 0; // method unavailable, fell back to something else
+	
+	size_t len = (regionSize + info.stride-1) & ~(info.stride-1);
+	std::vector<void*> scratch;
+	for(int i=0; i<ctx->maxNumThreads; i++)
+		scratch.push_back(testGf.mutScratch_alloc());
+	
+	uint8_t *inputBuf, *outputBuf, *srcBuf;
+	ALIGN_ALLOC(inputBuf, len * AUTOTUNE_INPUTS, info.alignment);
+	ALIGN_ALLOC(outputBuf, len * numOutputs, info.alignment);
+	ALIGN_ALLOC(srcBuf, len, info.alignment);
+	double result = 0;
+	if(inputBuf && outputBuf && srcBuf) {
+		// fill inputs with junk; data content doesn't affect speed, but avoid all zeroes just in case
+		uint32_t rand = 0x12345678;
+		for(size_t i=0; i<len; i++) {
+			rand = rand * 1103515245 + 12345;
+			srcBuf[i] = rand >> 24;
+		}
+		for(unsigned i=0; i<AUTOTUNE_INPUTS; i++)
+			testGf.prepare(inputBuf + len*i, srcBuf, len);
+		
+		const void* inputs[AUTOTUNE_INPUTS];
+		uint_fast16_t iNums[AUTOTUNE_INPUTS];
+		for(unsigned i=0; i<AUTOTUNE_INPUTS; i++) {
+			inputs[i] = inputBuf + len*i;
+			iNums[i] = i;
+		}
+		std::vector<void*> outputs(numOutputs);
+		std::vector<uint_fast16_t> oNums(numOutputs);
+		for(unsigned i=0; i<numOutputs; i++) {
+			outputs[i] = outputBuf + len*i;
+			oNums[i] = i+1;
+		}
+		
+		size_t coeffStride;
+		uint16_t* coeffs = calc_coeff_matrix(&ctx->pool, iNums, AUTOTUNE_INPUTS, &oNums[0], numOutputs, &coeffStride);
+		
+		// warm-up round (faults in memory, primes caches)
+		multiply_mat(&testGf, &scratch[0], &ctx->pool, ctx->matSchedule, coeffs, coeffStride, inputs, AUTOTUNE_INPUTS, len, &outputs[0], numOutputs, false);
+		unsigned rounds = 0;
+		double start = TIMER_NOW(), elapsed;
+		do {
+			// include copying inputs in, as methods which transform data do so here; like the real thing, this is done once per input, rather than per input+output
+			// finishing outputs is left out, since it's only done once per recovery slice, regardless of the number of inputs
+			for(unsigned i=0; i<AUTOTUNE_INPUTS; i++)
+				testGf.prepare(inputBuf + len*i, srcBuf, len);
+			multiply_mat(&testGf, &scratch[0], &ctx->pool, ctx->matSchedule, coeffs, coeffStride, inputs, AUTOTUNE_INPUTS, len, &outputs[0], numOutputs, true);
+			rounds++;
+			elapsed = TIMER_NOW() - start;
+		} while(elapsed < AUTOTUNE_MIN_TIME);
+		result = (double)rounds * len * AUTOTUNE_INPUTS * numOutputs / elapsed;
+		ALIGN_FREE(coeffs);
+	}
+	
+	if(inputBuf) ALIGN_FREE(inputBuf);
+	if(outputBuf) ALIGN_FREE(outputBuf);
+	if(srcBuf) ALIGN_FREE(srcBuf);
+	for(unsigned i=0; i<scratch.size(); i++)
+		if(scratch[i])
+			testGf.mutScratch_free(scratch[i]);
+	return result;
+}
+
+// looks up a previously stored result; last matching entry wins
+static Galois16Methods autotune_cache_get(const char* cacheFile, const std::string& key, const std::vector<Galois16Methods>& methods) {
+	Galois16Methods result = GF16_AUTO;
+	FILE* fp = fopen(cacheFile, "r");
+	if(!fp) return result;
+	
+	char line[256];
+	while(fgets(line, sizeof(line), fp)) {
+		if(strncmp(line, key.c_str(), key.length()) || line[key.length()] != '\t')
+			continue;
+		char* name = line + key.length() + 1;
+		name[strcspn(name, "\r\n")] = 0;
+		// match against name, rather than ID, so that cache files survive changes to the method list
+		for(unsigned i=0; i<methods.size(); i++)
+			if(!strcmp(name, Galois16Mul::methodToText(methods[i])))
+				result = methods[i];
+	}
+	fclose(fp);
+	return result;
+}
+static void autotune_cache_put(const char* cacheFile, const std::string& key, Galois16Methods method) {
+	FILE* fp = fopen(cacheFile, "a");
+	if(!fp) return; // failing to persist isn't fatal
+	fprintf(fp, "%s\t%s\n", key.c_str(), Galois16Mul::methodToText(method));
+	fclose(fp);
+}
+
+// benchmarks all available methods on the specified job shape and returns the fastest
+// if cacheFile is given, results are looked up from/persisted to it, keyed by CPU signature + job shape
+int ppgf_autotune_method(PPGFContext* ctx, size_t size_hint, unsigned outputs, const char* cacheFile) {
+	// bucket the job shape, so that similar jobs can share a cached result
+	size_t regionSize = AUTOTUNE_MIN_REGION;
+	if(!size_hint) size_hint = AUTOTUNE_MAX_REGION;
+	while(regionSize < size_hint && regionSize < AUTOTUNE_MAX_REGION)
+		regionSize <<= 1;
+	unsigned numOutputs = 1;
+	if(!outputs) outputs = AUTOTUNE_DEFAULT_OUTPUTS;
+	while(numOutputs < outputs && numOutputs < AUTOTUNE_MAX_OUTPUTS)
+		numOutputs <<= 1;
+	
+	std::vector<Galois16Methods> methods = Galois16Mul::availableMethods(true);
+	
+	char shape[64];
+	sprintf(shape, "\t%u\t%u\t%d", (unsigned)regionSize, numOutputs, ctx->maxNumThreads);
+	std::string key = Galois16Mul::cpu_signature() + shape;
+	if(cacheFile && *cacheFile) {
+		Galois16Methods cached = autotune_cache_get(cacheFile, key, methods);
+		if(cached != GF16_AUTO) return cached;
+	}
+	
+	Galois16Methods best = Galois16Mul::default_method(size_hint, outputs, ctx->maxNumThreads);
+	double bestSpeed = 0;
+	for(unsigned i=0; i<methods.size(); i++) {
+		double speed = autotune_bench(ctx, methods[i], regionSize, numOutputs);
+		if(speed > bestSpeed) {
+			bestSpeed = speed;
+			best = methods[i];
+		}
+	}
+	
+	if(cacheFile && *cacheFile && bestSpeed > 0)
+		autotune_cache_put(cacheFile, key, best);
+	return best;
+}
@@ -1,16 +1,35 @@
 #include "../src/stdint.h"
 
+// holds the method, scratch memory and threads for running jobs; each context can be used concurrently with others
+struct PPGFContext;
+PPGFContext* ppgf_create_context();
+void ppgf_destroy_context(PPGFContext* ctx);
+
 void ppgf_init_gf_module();
 void ppgf_init_constants();
 
-void ppgf_omp_check_num_threads();
-void ppgf_multiply_mat(const void* const* inputs, uint_fast16_t* iNums, unsigned int numInputs, size_t len, void** outputs, uint_fast16_t* oNums, unsigned int numOutputs, int add);
+// how ppgf_multiply_mat orders its work
+enum {
+	PPGF_SCHEDULE_AUTO,
+	PPGF_SCHEDULE_FLAT, // each task multiplies all inputs into one output chunk
+	PPGF_SCHEDULE_BLOCKED, // each task applies cache-sized input groups to a group of output chunks
+	PPGF_SCHEDULE_SPLIT, // inputs are also partitioned across threads, and partial results merged
+	PPGF_SCHEDULE_POW // runs of consecutive outputs are generated from one pass over each input, as successive powers of its constant (needs a method with pow_add)
+};
+void ppgf_set_schedule(PPGFContext* ctx, int schedule);
+void ppgf_get_schedule(PPGFContext* ctx, unsigned int numInputs, size_t len, unsigned int numOutputs, int* schedule, size_t* chunkSize, unsigned int* inputGroup, unsigned int* outputGroup, unsigned int* inputSplits);
+void ppgf_multiply_mat(PPGFContext* ctx, const void* const* inputs, uint_fast16_t* iNums, unsigned int numInputs, size_t len, void** outputs, uint_fast16_t* oNums, unsigned int numOutputs, int add);
 
-void ppgf_prep_input(size_t destLen, size_t inputLen, char* dest, char* src);
-void ppgf_finish_input(unsigned int numInputs, uint16_t** inputs, size_t len);
-void ppgf_get_method(int* rMethod, const char** rMethLong, int* align, int* stride);
-int ppgf_set_method(int meth, int size_hint);
+void ppgf_prep_input(PPGFContext* ctx, size_t destLen, size_t inputLen, char* dest, char* src);
+void ppgf_finish_input(PPGFContext* ctx, unsigned int numInputs, uint16_t** inputs, size_t len);
+// untransforms part of one buffer on the calling thread, for callers fusing it with other work; len must be a multiple of the stride, and ppgf_maybe_setup_gf must have been called
+void ppgf_finish_partial(PPGFContext* ctx, void* data, size_t len);
+void ppgf_get_method(PPGFContext* ctx, int* rMethod, const char** rMethLong, int* align, int* stride);
+int ppgf_set_method(PPGFContext* ctx, int meth, size_t size_hint, unsigned outputs_hint);
 
-void ppgf_maybe_setup_gf();
-int ppgf_get_num_threads();
-void ppgf_set_num_threads(int threads);
+void ppgf_maybe_setup_gf(PPGFContext* ctx);
+int ppgf_get_num_threads(PPGFContext* ctx);
+void ppgf_set_num_threads(PPGFContext* ctx, int threads);
+// runs func(arg, task, threadNum) for each task in [0, numTasks) on the context's worker pool, returning once all are done
+void ppgf_run_tasks(PPGFContext* ctx, unsigned int numTasks, void(*func)(void*, unsigned, unsigned), void* arg);
+int ppgf_autotune_method(PPGFContext* ctx, size_t size_hint, unsigned outputs, const char* cacheFile);
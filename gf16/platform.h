@@ -66,8 +66,12 @@
 #if defined(__AVX512F__) && _MSC_VER >= 1914
 	#define __AVX512VBMI__ 1
 #endif
+#if defined(__SSE2__) && _MSC_VER >= 1600
+	#define __PCLMUL__ 1
+#endif
 #if defined(__SSE2__) && _MSC_VER >= 1920
 	#define __GFNI__ 1
+	#define __VPCLMULQDQ__ 1
 #endif
 
 #endif /* _MSC_VER */
@@ -79,6 +83,9 @@
 #ifdef __SSSE3__
 # include <tmmintrin.h>
 #endif
+#ifdef __PCLMUL__
+# include <wmmintrin.h>
+#endif
 #if defined(__AVX__) || defined(__GFNI__)
 # include <immintrin.h>
 #endif
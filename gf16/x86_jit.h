@@ -672,22 +672,63 @@ static inline size_t _jit_ret(uint8_t* jit) {
 }
 
 
+/* memory for generated code: code is written through `w` and executed through `x`
+ * these are the same if the OS allows writable+executable memory; otherwise (e.g. SELinux deny_execmem, PaX MPROTECT) the same pages are mapped twice, once writable and once executable */
+typedef struct {
+	uint8_t* w;
+	uint8_t* x;
+	size_t len;
+} jit_wx_pair;
+
 #if defined(_WINDOWS) || defined(__WINDOWS__) || defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
-static inline void* jit_alloc(size_t len) {
-	return VirtualAlloc(NULL, len, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+static inline int jit_alloc(jit_wx_pair* mem, size_t len) {
+	mem->len = len;
+	mem->w = mem->x = (uint8_t*)VirtualAlloc(NULL, len, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+	return mem->x != NULL;
 }
-static inline void jit_free(void* mem, size_t len) {
-	UNUSED(len);
-	VirtualFree(mem, 0, MEM_RELEASE);
+static inline void jit_free(jit_wx_pair* mem) {
+	VirtualFree(mem->x, 0, MEM_RELEASE);
 }
 #else
 #include <sys/mman.h>
-static inline void* jit_alloc(size_t len) {
-	return mmap(NULL, len, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANON, -1, 0);
+#include <unistd.h>
+#ifdef __linux__
+# include <sys/syscall.h>
+# ifndef MFD_CLOEXEC
+#  define MFD_CLOEXEC 1
+# endif
+#endif
+static inline int jit_alloc(jit_wx_pair* mem, size_t len) {
+	mem->len = len;
+	void* p = mmap(NULL, len, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANON, -1, 0);
+	if(p != MAP_FAILED) {
+		mem->w = mem->x = (uint8_t*)p;
+		return 1;
+	}
+	mem->w = mem->x = NULL;
+#ifdef SYS_memfd_create
+	/* RWX denied: create an anonymous file and map it twice (a shared mapping, so both views refer to the same pages) */
+	int fd = (int)syscall(SYS_memfd_create, "parpar-jit", MFD_CLOEXEC);
+	if(fd < 0) return 0;
+	if(ftruncate(fd, len) == 0) {
+		void* w = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		void* x = mmap(NULL, len, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+		if(w != MAP_FAILED && x != MAP_FAILED) {
+			mem->w = (uint8_t*)w;
+			mem->x = (uint8_t*)x;
+		} else {
+			if(w != MAP_FAILED) munmap(w, len);
+			if(x != MAP_FAILED) munmap(x, len);
+		}
+	}
+	close(fd); /* mappings keep the file alive */
+#endif
+	return mem->x != NULL;
 }
-static inline void jit_free(void* mem, size_t len) {
-	munmap(mem, len); /* TODO: needs to be aligned?? */
+static inline void jit_free(jit_wx_pair* mem) {
+	if(mem->w != mem->x) munmap(mem->w, mem->len);
+	munmap(mem->x, mem->len);
 }
 #endif
 
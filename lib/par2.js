@@ -2,10 +2,10 @@
 
 var crypto = require('crypto');
 var gf = require('../build/Release/parpar_gf.node');
-var y = require('yencode');
 var Queue = require('./queue');
 
-var gfMethod = gf.set_method();
+var gfMethod = gf.set_method(); // method info for the default context
+var defaultMethod = 0; // method new PAR2 instances will use; 0 = auto
 var allocBuffer = (Buffer.allocUnsafe || Buffer);
 var toBuffer = (Buffer.alloc ? Buffer.from : Buffer);
 
@@ -59,21 +59,31 @@ var CHAR_CONST = {
 	UNICODE: 3,
 };
 
-var AlignedBuffer = function(len) { // note, this aligns to alignment, but doesn't align to stride
+var AlignedBuffer = function(len, alignment) { // note, this aligns to alignment, but doesn't align to stride
 	// emulate AlignedBuffer with native node Buffers
-	var buf = allocBuffer(len + gfMethod.alignment-1);
-	var ao = gf.alignment_offset(buf);
-	if(ao) ao = gfMethod.alignment - ao;
+	alignment = alignment || gfMethod.alignment;
+	var buf = allocBuffer(len + alignment-1);
+	var ao = gf.alignment_offset(buf, alignment);
+	if(ao) ao = alignment - ao;
 	return buf.slice(ao, ao + len);
 };
 
-var alignedBufferArray = function(num, len) {
+var alignedBufferArray = function(num, len, alignment) {
 	var bufs = Array(num);
 	for(var i=0; i<num; i++)
-		bufs[i] = AlignedBuffer(len);
+		bufs[i] = AlignedBuffer(len, alignment);
 	return bufs;
 };
 
+// resolves a method name to its ID; 'autotune' benchmarks all methods on the job shape via the given context, persisting results to autotuneCache, if specified
+var methodId = function(ctx, method, sliceSize, numRecovery, autotuneCache) {
+	if(method == 'autotune')
+		return ctx.autotune_method(sliceSize || 0, numRecovery || 0, autotuneCache || undefined);
+	var meth = GF_METHODS.indexOf(method);
+	if(meth < 0) throw new Error('Unknown method "' + method + '"');
+	return meth;
+};
+
 var _md5InitCtx;
 var md5_init = function() {
 	if(!_md5InitCtx) _md5InitCtx = gf.md5_init();
@@ -121,6 +131,8 @@ var GFWrapper = {
 	//recoveryData: null,
 	//recoverySlices: null,
 	//chunkSize: null,
+	//_gf: null, // GF context
+	//_gfMethod: null, // info on the context's method
 	
 	// do not call this function after processing has started!
 	setInputBufferSize: function(bufferInputs, bgProcessInputs) {
@@ -148,7 +160,7 @@ var GFWrapper = {
 						iSlices[j] = inputs[j][1];
 					}
 					if(iSlices.length) {
-						gf.generate(iSlices, iNums, this.recoveryData, this.recoverySlices, this._mergeRecovery, function() {
+						this._gf.generate(iSlices, iNums, this.recoveryData, this.recoverySlices, this._mergeRecovery, function() {
 							for(var j = 0; j < iSlices.length; j++)
 								this.qInputEmpty.add(inputs[j]);
 							
@@ -172,15 +184,15 @@ var GFWrapper = {
 			
 			//this._processStarted = true;
 			if(!this.bufferedInputs) {
-				this.bufferedInputs = alignedBufferArray(this.bufferInputs, len);
+				this.bufferedInputs = alignedBufferArray(this.bufferInputs, len, this._gfMethod.alignment);
 				this.bufferedInSlices = Array(this.bufferInputs);
 				this.bufferedInputPos = 0;
 			}
-			gf.copy(dataSlice, this.bufferedInputs[this.bufferedInputPos]);
+			this._gf.copy(dataSlice, this.bufferedInputs[this.bufferedInputPos]);
 			this.bufferedInSlices[this.bufferedInputPos] = sliceNum;
 			this.bufferedInputPos++;
 			if(this.bufferedInputPos >= this.bufferInputs) {
-				gf.generate(this.bufferedInputs, this.bufferedInSlices, this.recoveryData, this.recoverySlices, this._mergeRecovery, cb);
+				this._gf.generate(this.bufferedInputs, this.bufferedInSlices, this.recoveryData, this.recoverySlices, this._mergeRecovery, cb);
 				this._mergeRecovery = true;
 				this.bufferedInputPos = 0;
 			} else
@@ -191,7 +203,7 @@ var GFWrapper = {
 			if(!this.qInputEmpty) {
 				this.qInputEmpty = new Queue();
 				this.qInputReady = new Queue();
-				alignedBufferArray(this.bufferInputs + this.bgProcessInputs, len).forEach(function(buf) {
+				alignedBufferArray(this.bufferInputs + this.bgProcessInputs, len, this._gfMethod.alignment).forEach(function(buf) {
 					this.qInputEmpty.add([0, buf]);
 				}.bind(this));
 				this.bufferedInputPos = 0; // this is just used as a counter
@@ -204,7 +216,7 @@ var GFWrapper = {
 			}
 			this.qInputEmpty.take(function(input) {
 				input[0] = sliceNum;
-				gf.copy(dataSlice, input[1]);
+				this._gf.copy(dataSlice, input[1]);
 				this.qInputReady.add(input);
 				cb();
 			}.bind(this));
@@ -216,14 +228,13 @@ var GFWrapper = {
 			
 			var recData = this.recoveryData;
 			var size = this.chunkSize;
+			var ctx = this._gf;
 			if(this.bufferedInputPos) {
-				gf.generate(this.bufferedInputs.slice(0, this.bufferedInputPos), this.bufferedInSlices.slice(0, this.bufferedInputPos), recData, this.recoverySlices, this._mergeRecovery, function() {
-					gf.finish(recData, size, md5);
-					cb();
+				ctx.generate(this.bufferedInputs.slice(0, this.bufferedInputPos), this.bufferedInSlices.slice(0, this.bufferedInputPos), recData, this.recoverySlices, this._mergeRecovery, function() {
+					ctx.finish(recData, size, md5, cb);
 				});
 			} else {
-				gf.finish(recData, size, md5);
-				process.nextTick(cb);
+				ctx.finish(recData, size, md5, cb);
 			}
 			//this._processStarted = false;
 			this.bufferedClear(!clear);
@@ -233,12 +244,13 @@ var GFWrapper = {
 			if(this.qInputReady && this.bufferedInputPos) {
 				var self = this;
 				this.qDone = function() {
-					gf.finish(self.recoveryData, self.chunkSize, md5);
-					self._processStarted = false;
-					self.bufferedClear(!clear);
-					self.qDone = null;
-					self.qInputReady = new Queue();
-					cb();
+					self._gf.finish(self.recoveryData, self.chunkSize, md5, function() {
+						self._processStarted = false;
+						self.bufferedClear(!clear);
+						self.qDone = null;
+						self.qInputReady = new Queue();
+						cb();
+					});
 				};
 				this.qInputReady.finished();
 			} else {
@@ -247,10 +259,11 @@ var GFWrapper = {
 				this.recoveryData.forEach(function(data) {
 					data.fill(0, 0, data.length); // need to supply defaults if using underlying buffers
 				});
-				gf.finish(this.recoveryData, this.chunkSize, md5); // TODO: this could be optimized
 				this._processStarted = false;
-				this.bufferedClear(!clear);
-				process.nextTick(cb);
+				this._gf.finish(this.recoveryData, this.chunkSize, md5, function() {
+					this.bufferedClear(!clear);
+					cb();
+				}.bind(this)); // TODO: this could be optimized
 			}
 		}
 	},
@@ -278,6 +291,11 @@ function PAR2(files, sliceSize) {
 	this.chunkSize = sliceSize; // compatibility with PAR2Chunked
 	this.chunkSizeStride = sliceSize;
 	
+	// each instance gets its own GF context, so that multiple jobs can be processed concurrently
+	this._gf = new gf.GfContext();
+	this._gf.set_max_threads(gf.get_num_threads());
+	this._gfMethod = this._gf.set_method(defaultMethod, sliceSize);
+	
 	var self = this;
 	
 	// process files list to get IDs
@@ -328,6 +346,26 @@ PAR2.prototype = {
 		return files;
 	},
 	
+	// sets the method for this instance's GF context; method can also be 'autotune'
+	// !! will not reset buffers etc; data may become invalid if setting this after processing has started
+	setMethod: function(method, sizeHint, numRecovery, autotuneCache) {
+		sizeHint = sizeHint || this.sliceSize;
+		var meth = methodId(this._gf, method, sizeHint, numRecovery, autotuneCache);
+		this._gfMethod = this._gf.set_method(meth, sizeHint, numRecovery || 0);
+	},
+	getMethod: function() {
+		return {
+			method: GF_METHODS[this._gfMethod.method],
+			description: this._gfMethod.method_desc
+		};
+	},
+	setMaxThreads: function(threads) {
+		this._gf.set_max_threads(threads);
+	},
+	getNumThreads: function() {
+		return this._gf.get_num_threads();
+	},
+	
 	// write in a packet's header; data must already be present at offset+64 (unless skipMD5 is true)
 	_writePktHeader: function(buf, name, offset, len, skipMD5) {
 		if(!offset) offset = 0;
@@ -361,7 +399,7 @@ PAR2.prototype = {
 			pkt.write("PAR 2.0\0RecvSlic", 48);
 		}
 		
-		var c = new PAR2Chunked(recoverySlices, pkt);
+		var c = new PAR2Chunked(recoverySlices, pkt, this._gf, this._gfMethod);
 		c.bufferInputs = this.bufferInputs;
 		c.bgProcessInputs = this.bgProcessInputs;
 		return c;
@@ -405,12 +443,13 @@ PAR2.prototype = {
 		}
 		
 		// allocate new buffers
+		var gfMethod = this._gfMethod;
 		this.chunkSizeStride = Math.ceil(this.sliceSize / gfMethod.stride) * gfMethod.stride;
 		// allocate space for recvslic header & alignment
 		var headerSize = Math.ceil(68 / gfMethod.alignment) * gfMethod.alignment;
 		var size = this.chunkSizeStride + headerSize;
 		for(; oldLen < this.recoverySlices.length; oldLen++) {
-			var buffer = AlignedBuffer(size); // this is an over-allocation to ensure recovery data is aligned
+			var buffer = AlignedBuffer(size, gfMethod.alignment); // this is an over-allocation to ensure recovery data is aligned
 			this.recoveryPackets[oldLen] = buffer.slice(headerSize - 68, headerSize + this.sliceSize); // chop off over-allocation (space for end-of-header alignment, plus stride allocation)
 			this.recoveryPackets[oldLen].writeUInt32LE(this.recoverySlices[oldLen], 64);
 			
@@ -542,6 +581,84 @@ PAR2.prototype = {
 		return pkt;
 	},
 	
+	// hashes the next slices of several files in one go, so that their MD5s can share SIMD lanes; process() then skips hashing these slices
+	// each file's data must follow on from what it was last fed, and hold whole slices (only the file's last slice may be short)
+	hashSlices: function(files, datas) {
+		var job = this._hashJob(files, datas);
+		if(!job.files.length) return;
+		gf.slice_hash_multi(job.md5s, job.datas, this.sliceSize, job.outs, job.offsets);
+		this._hashJobDone(job);
+	},
+	// as above, but hashing runs on the libuv worker pool, leaving this thread free to read and process data in the meantime
+	// jobs run one at a time, in the order given, so file MD5s (and the callbacks) stay in slice order; datas must not be modified until cb is called
+	// whilst any of this hashing is pending, slices can only be given to PAR2File.process if they've been claimed here, and PAR2File.processHash must be given a callback (so that it queues behind); otherwise use hashWait first
+	hashSlicesAsync: function(files, datas, cb) {
+		var self = this;
+		var job = this._hashJob(files, datas);
+		this._hashQueueRun(function(done) {
+			if(!job.files.length) return process.nextTick(done);
+			gf.slice_hash_multi(job.md5s, job.datas, self.sliceSize, job.outs, job.offsets, function() {
+				self._hashJobDone(job);
+				done();
+			});
+		}, cb);
+	},
+	// calls cb once all hashing started by hashSlicesAsync (or PAR2File.processHash) has completed
+	hashWait: function(cb) {
+		this._hashQueueRun(function(done) {
+			process.nextTick(done);
+		}, cb);
+	},
+	_hashPending: function() {
+		return !!(this._hashQueue && this._hashQueue.length);
+	},
+	// runs fn(done) once all previously queued hashing has completed, then calls cb
+	_hashQueueRun: function(fn, cb) {
+		if(!this._hashQueue) this._hashQueue = [];
+		this._hashQueue.push({run: fn, cb: cb});
+		if(this._hashQueue.length == 1)
+			this._hashNext();
+	},
+	_hashNext: function() {
+		var self = this;
+		var job = this._hashQueue[0];
+		job.run(function() {
+			self._hashQueue.shift();
+			if(self._hashQueue.length)
+				self._hashNext();
+			job.cb();
+		});
+	},
+	_hashJob: function(files, datas) {
+		var sliceSize = this.sliceSize;
+		var job = {files: [], md5s: [], datas: [], outs: [], offsets: [], last: []};
+		files.forEach(function(file, i) {
+			if(!file.pktCheck) return; // nothing to do, or the odd case in process()
+			var pos = Math.max(file.slicePos, file._hashedTo);
+			var numSlices = Math.ceil(datas[i].length / sliceSize);
+			if(pos + numSlices > file.numSlices) throw new Error('Too many slices given');
+			if(datas[i].length != Math.min(file.size - pos*sliceSize, numSlices*sliceSize))
+				throw new Error('Invalid data length');
+			job.files.push(file);
+			job.md5s.push(file.md5 ? null : file._md5ctx);
+			job.datas.push(datas[i]);
+			job.outs.push(file.pktCheck);
+			job.offsets.push(64 + 16 + 20*pos);
+			// claim the slices now, so that process() skips them even if they're still being hashed
+			file._hashedTo = pos + numSlices;
+			job.last.push(file._hashedTo == file.numSlices);
+		});
+		return job;
+	},
+	_hashJobDone: function(job) {
+		job.files.forEach(function(file, i) {
+			if(job.last[i] && !file.md5) {
+				file.md5 = gf.md5_final(file._md5ctx);
+				file._md5ctx = null;
+			}
+		});
+	},
+	
 	processSlice: function(data, sliceNum, cb) {
 		if(this.recoverySlices.length)
 			this.bufferedProcess(data, sliceNum, this.chunkSizeStride, cb);
@@ -557,6 +674,7 @@ PAR2.prototype = {
 		if(files) {
 			files.forEach(function(file) {
 				file.slicePos = 0;
+				file._hashedTo = 0;
 				if(!file.md5)
 					file._md5ctx = md5_init();
 			});
@@ -618,38 +736,12 @@ function PAR2File(par2, file) {
 	this.slicePos = 0;
 }
 
-// for zero-filling, to avoid constant allocating of new buffers
-var nulls;
-var _md5FeedZeroes = function(md5, amount) {
-	// feed in zero padding
-	if(!nulls) {
-		nulls = allocBuffer(8192);
-		nulls.fill(0);
-	}
-	var p;
-	for(p = 0; p < amount - nulls.length; p += nulls.length) {
-		md5.update(nulls);
-	}
-	md5.update(nulls.slice(0, amount - p));
-};
-
-
 PAR2File.prototype = {
 	sliceOffset: 0,
 	chunkSlicePos: 0, // only used externally
 	_slicePartPos: 0,
-	_crcSlice: null,
-	_md5slice: null,
-	
-	_processWriteHash: function(md5, crc) {
-		var chkAddr = 64 + 16 + 20*this.slicePos;
-		md5.copy(this.pktCheck, chkAddr);
-		// need to reverse the CRC
-		this.pktCheck[chkAddr + 16] = crc[3];
-		this.pktCheck[chkAddr + 17] = crc[2];
-		this.pktCheck[chkAddr + 18] = crc[1];
-		this.pktCheck[chkAddr + 19] = crc[0];
-	},
+	_sliceHash: null,
+	_hashedTo: 0, // slices already hashed (or being hashed) by PAR2.hashSlices
 	
 	process: function(data, cb) {
 			if(this.slicePos >= this.numSlices) throw new Error('Too many slices given');
@@ -665,44 +757,23 @@ PAR2File.prototype = {
 					throw new Error('Invalid data length');
 			}
 		
-		// multi-MD5
-		var md5; // piece MD5 context
-		if(this.pktCheck || !this.md5) {
-			if(this.pktCheck && !this.md5) {
-				md5 = md5_init();
-				gf.md5_update2(this._md5ctx, md5, data);
-				if(data.length < this.par2.sliceSize)
-					gf.md5_update_zeroes(md5, this.par2.sliceSize - data.length);
-				md5 = gf.md5_final(md5);
-			} else {
-				// only need to do one, use single
-				if(this.pktCheck) {
-					md5 = crypto.createHash('md5').update(data);
-					if(data.length < this.par2.sliceSize)
-						_md5FeedZeroes(md5, this.par2.sliceSize - data.length);
-					md5 = md5.digest();
-				}
-				if(!this.md5) {
-					// odd case (calc file MD5 but not piece MD5) - feed it through multi-hasher anyway
-					// this will be slower than a single MD5, but I don't expect this to occur in normal situations
-					gf.md5_update2(this._md5ctx, md5_init(), data);
-				}
+		// slices claimed by PAR2.hashSlices are hashed (and the file MD5 finalised) there
+		if(this.slicePos >= this._hashedTo) {
+			// hashing here would overtake the queued hashing, which may be for earlier parts of this file
+			if(this.par2._hashPending())
+				throw new Error('Slice not claimed by hashSlicesAsync whilst hashing is pending');
+			if(this.pktCheck) {
+				// slice MD5 + CRC32 (with zero padding) and file MD5, in one native pass
+				gf.slice_hash(this.md5 ? null : this._md5ctx, data, this.par2.sliceSize, this.pktCheck, 64 + 16 + 20*this.slicePos);
+			} else if(!this.md5) {
+				// odd case (calc file MD5 but not piece MD5)
+				gf.md5_update_multi([this._md5ctx], [data]);
 			}
-		}
-		
-		// calc slice CRC/MD5
-		if(this.pktCheck) {
-			var crc = y.crc32(data);
-			if(data.length != this.par2.sliceSize) {
-				var zeroLen = this.par2.sliceSize - data.length;
-				crc = y.crc32_combine(crc, y.crc32_zeroes(zeroLen), zeroLen);
+			
+			if(!this.md5 && lastPiece) {
+				this.md5 = gf.md5_final(this._md5ctx);
+				this._md5ctx = null;
 			}
-			this._processWriteHash(md5, crc);
-		}
-		
-		if(!this.md5 && lastPiece) {
-			this.md5 = gf.md5_final(this._md5ctx);
-			this._md5ctx = null;
 		}
 		
 		this.slicePos++;
@@ -718,22 +789,9 @@ PAR2File.prototype = {
 			throw new Error('Invalid data length for last slice');
 		
 		// zero fill & write
-		if(this.pktCheck && this._md5slice && this.slicePos < this.numSlices && this._slicePartPos < this.par2.sliceSize) {
-			var zeroLen = this.par2.sliceSize - this._slicePartPos;
-			var md5;
-			if(!this.md5) {
-				gf.md5_update_zeroes(this._md5slice, zeroLen);
-				md5 = gf.md5_final(this._md5slice);
-			} else {
-				_md5FeedZeroes(this._md5slice, zeroLen);
-				md5 = this._md5slice.digest();
-			}
-			this._crcSlice = y.crc32_combine(this._crcSlice, y.crc32_zeroes(zeroLen), zeroLen);
-			
-			// write it
-			this._processWriteHash(md5, this._crcSlice);
-			this._md5slice = null;
-			this._crcSlice = null;
+		if(this.pktCheck && this._sliceHash && this.slicePos < this.numSlices) {
+			gf.slice_hash_final(this._sliceHash, this.par2.sliceSize, this.pktCheck, 64 + 16 + 20*this.slicePos);
+			this._sliceHash = null;
 			this.slicePos++;
 		}
 		
@@ -742,52 +800,54 @@ PAR2File.prototype = {
 			this._md5ctx = null;
 		}
 	},
-	_processHashFeed: function(data) {
+	_processHashFeed: function(data, cb) {
 		if(this.slicePos >= this.numSlices) throw new Error('Too many slices given');
 		
-		if(this.pktCheck && !this.md5) {
-			if(!this._md5slice) this._md5slice = md5_init();
-			gf.md5_update2(this._md5ctx, this._md5slice, data);
-		} else if(this.pktCheck) {
-			// only need to do one, use single
-			if(!this._md5slice) this._md5slice = crypto.createHash('md5');
-			this._md5slice.update(data);
-		} else if(!this.md5) {
-			// odd case (calc file MD5 but not piece MD5) - feed it through multi-hasher anyway
-			// this will be slower than a single MD5, but I don't expect this to occur in normal situations
-			gf.md5_update2(this._md5ctx, md5_init(), data);
-		}
 		if(this.pktCheck) {
-			this._crcSlice = this._crcSlice ? y.crc32(data, this._crcSlice) : y.crc32(data);
+			if(!this._sliceHash) this._sliceHash = gf.slice_hash_init();
+			gf.slice_hash_update(this.md5 ? null : this._md5ctx, this._sliceHash, data, cb);
+			return;
+		} else if(!this.md5) {
+			// odd case (calc file MD5 but not piece MD5)
+			gf.md5_update_multi([this._md5ctx], [data]);
 		}
+		if(cb) process.nextTick(cb);
 	},
-	processHash: function(data) {
-		while(this._slicePartPos + data.length >= this.par2.sliceSize) {
-			var dataPart = data.slice(0, this.par2.sliceSize - this._slicePartPos);
-			// feed stuff thru
-			this._processHashFeed(dataPart);
-			
-			// end part
-			if(this.pktCheck) {
-				var md5;
-				if(!this.md5)
-					md5 = gf.md5_final(this._md5slice);
-				else
-					md5 = this._md5slice.digest();
-				this._processWriteHash(md5, this._crcSlice);
-				this._md5slice = null;
-				this._crcSlice = null;
-			}
-			
-			this.slicePos++;
-			this._slicePartPos = 0;
-			data = data.slice(dataPart.length);
+	// feeds part of a slice; if cb is given, hashing runs on the worker pool, queued behind hashing started by PAR2.hashSlicesAsync, and data must not be modified until cb is called
+	processHash: function(data, cb) {
+		var self = this;
+		if(cb)
+			this.par2._hashQueueRun(function(done) {
+				self._processHashParts(data, done);
+			}, cb);
+		else {
+			if(this.par2._hashPending())
+				throw new Error('Callback required whilst hashing is pending');
+			this._processHashParts(data);
 		}
-		// feed thru remainder
-		if(data.length) {
-			this._processHashFeed(data);
-			this._slicePartPos += data.length;
+	},
+	_processHashParts: function(data, cb) {
+		var self = this;
+		var partLen = Math.min(data.length, this.par2.sliceSize - this._slicePartPos);
+		if(!partLen) {
+			if(cb) process.nextTick(cb);
+			return;
 		}
+		var fed = function() {
+			self._slicePartPos += partLen;
+			if(self._slicePartPos == self.par2.sliceSize) {
+				// end part
+				if(self.pktCheck) {
+					gf.slice_hash_final(self._sliceHash, self.par2.sliceSize, self.pktCheck, 64 + 16 + 20*self.slicePos);
+					self._sliceHash = null;
+				}
+				self.slicePos++;
+				self._slicePartPos = 0;
+			}
+			self._processHashParts(data.slice(partLen), cb);
+		};
+		this._processHashFeed(data.slice(0, partLen), cb && fed);
+		if(!cb) fed();
 	},
 	
 	packetChecksumsSize: function() {
@@ -873,8 +933,11 @@ PAR2File.prototype = {
 };
 
 
-function PAR2Chunked(recoverySlices, packetHeader) {
+// shares the GF context of the PAR2 instance which created it
+function PAR2Chunked(recoverySlices, packetHeader, gfContext, gfMethod) {
 	this.packetHeader = packetHeader;
+	this._gf = gfContext;
+	this._gfMethod = gfMethod;
 	this.setRecoverySlices(recoverySlices);
 	if(!this.recoveryData)
 		throw new Error('Must supply recovery slices for chunked operation');
@@ -917,7 +980,7 @@ PAR2Chunked.prototype = {
 		// allocate new buffers
 		if(this._allocSize) {
 			for(; oldLen < this.recoverySlices.length; oldLen++) {
-				this._buffers[oldLen] = AlignedBuffer(this._allocSize);
+				this._buffers[oldLen] = AlignedBuffer(this._allocSize, this._gfMethod.alignment);
 				this.recoveryData[oldLen] = this._buffers[oldLen].slice(0, this.chunkSizeStride);
 			}
 		}
@@ -946,11 +1009,11 @@ PAR2Chunked.prototype = {
 		
 		if(size) {
 			this.chunkSize = size;
-			this.chunkSizeStride = Math.ceil(size / gfMethod.stride) * gfMethod.stride;
+			this.chunkSizeStride = Math.ceil(size / this._gfMethod.stride) * this._gfMethod.stride;
 			if(!this._allocSize || size > this._allocSize) {
 				// requested size is larger than what's allocated - need to reallocate
 				this._allocSize = this.chunkSizeStride;
-				this._buffers = alignedBufferArray(this.recoverySlices.length, this._allocSize);
+				this._buffers = alignedBufferArray(this.recoverySlices.length, this._allocSize, this._gfMethod.alignment);
 				this.recoveryData = Array(this.recoverySlices.length);
 			}
 			// size buffers correctly
@@ -1029,7 +1092,11 @@ var GF_METHODS = [
 	'shuffle2x-avx2', 'shuffle2x-avx512',
 	'xor-sse', 'xorjit-sse', 'xorjit-avx2', 'xorjit-avx512',
 	'affine-sse', 'affine-avx512',
-	'affine2x-sse', 'affine2x-avx512'
+	'affine2x-sse', 'affine2x-avx512',
+	'affine-avx2', 'affine2x-avx2',
+	'affine2x-nt-avx2', 'affine2x-nt-avx512',
+	'clmul-sse', 'clmul-avx512',
+	'lh_lookup-avx2', 'lh_lookup-avx512'
 ];
 
 module.exports = {
@@ -1039,11 +1106,10 @@ module.exports = {
 	PAR2: PAR2,
 	setMaxThreads: gf.set_max_threads,
 	getNumThreads: gf.get_num_threads,
-	setMethod: function(method, sliceSize) {
-		// !! will not reset buffers etc; data may become invalid if setting this after processing has started
-		var meth = GF_METHODS.indexOf(method);
-		if(meth < 0) throw new Error('Unknown method "' + method + '"');
-		gfMethod = gf.set_method(meth, sliceSize);
+	// sets the default method, used by PAR2 instances created afterwards
+	setMethod: function(method, sliceSize, numRecovery, autotuneCache) {
+		defaultMethod = methodId(gf, method, sliceSize, numRecovery, autotuneCache);
+		gfMethod = gf.set_method(defaultMethod, sliceSize || 0, numRecovery || 0);
 	},
 	getMethod: function() {
 		return {
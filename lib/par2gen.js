@@ -533,9 +533,9 @@ function PAR2Gen(fileInfo, sliceSize, opts) {
 	if(o.processBatchSize === null) {
 		// calc default
 		// TODO: grabbing number of threads used here isn't ideal :/
-		o.processBatchSize = Math.max(Par2.getNumThreads() * 16, Math.ceil(4096*1024 / this._chunkSize));
+		o.processBatchSize = Math.max(par.getNumThreads() * 16, Math.ceil(4096*1024 / this._chunkSize));
 		if(o.processBatchSize*this._chunkSize > 64*1048576 && o.processBatchSize > 16) // if excessively large, scale it down
-			o.processBatchSize = Math.max(Math.min(4, Par2.getNumThreads()) * 4, Math.ceil(64*1048576 / this._chunkSize));
+			o.processBatchSize = Math.max(Math.min(4, par.getNumThreads()) * 4, Math.ceil(64*1048576 / this._chunkSize));
 	}
 	o.processBatchSize = Math.min(o.processBatchSize, o.recoverySlices); // it's pointless to try buffering more slices than we have
 	if(o.processBufferSize === null) o.processBufferSize = o.processBatchSize;
@@ -575,7 +575,17 @@ PAR2Gen.prototype = {
 	chunkOffset: 0,
 	readSize: 0,
 	_buf: null,
+	_buf2: null, // alternates with _buf on the first pass, so one can be hashed whilst the other is read into
 
+	// selects the GF method, using this job's shape as a hint; method can also be 'autotune'
+	// must be called before processing starts
+	setMethod: function(method, autotuneCache) {
+		this.par2.setMethod(method, this._chunkSize, this.opts.recoverySlices, autotuneCache);
+	},
+	getMethod: function() {
+		return this.par2.getMethod();
+	},
+	
 	_rfPush: function(numSlices, sliceOffset, critPackets, creator) {
 		var packets, recvSize = 0, critTotalSize = 0;
 		if(numSlices) recvSize = this.par2.packetRecoverySize();
@@ -873,7 +883,53 @@ PAR2Gen.prototype = {
 			this._buf = allocBuffer(this.readSize);
 		}
 		var seeking = (chunkSize != this.opts.sliceSize) && !firstPass;
-		async.eachSeries(this.files, function(file, cb) {
+		
+		// on the first pass, slices are hashed in the background (see PAR2.hashSlicesAsync and PAR2File.processHash), so reads alternate between two buffers; a buffer is only reused once hashing has finished with it
+		var readBufs = [this._buf];
+		var hashAsync = firstPass;
+		if(hashAsync) {
+			if(!this._buf2 || this._buf2.length < this.readSize)
+				this._buf2 = allocBuffer(this.readSize);
+			readBufs.push(this._buf2);
+		}
+		var readBufNum = 0;
+		var readBufHashing = [false, false], readBufWaiting = [null, null];
+		var nextReadBuf = function(cb) {
+			var i = readBufNum;
+			readBufNum = (readBufNum + 1) % readBufs.length;
+			if(readBufHashing[i])
+				readBufWaiting[i] = cb.bind(null, readBufs[i], i);
+			else
+				cb(readBufs[i], i);
+		};
+		// marks a buffer as being hashed; returns the callback to release it
+		var hashReadBuf = function(i) {
+			readBufHashing[i] = true;
+			return function() {
+				readBufHashing[i] = false;
+				var waiting = readBufWaiting[i];
+				readBufWaiting[i] = null;
+				if(waiting) waiting();
+			};
+		};
+		var sequential = self.readSize >= self.opts.sliceSize || (firstPass && self.opts.noChunkFirstPass);
+		
+		// on the first pass, small files are read together, so that they can be hashed in one batch
+		var fileGroups = [];
+		var groupSize = 0;
+		this.files.forEach(function(file) {
+			var space = Math.ceil(file.size / self.opts.sliceSize) * self.opts.sliceSize;
+			var lastGroup = fileGroups[fileGroups.length-1];
+			if(firstPass && self.readSize >= self.opts.sliceSize && file.size && lastGroup && lastGroup[0].size && groupSize + space <= self.readSize) {
+				lastGroup.push(file);
+				groupSize += space;
+			} else {
+				fileGroups.push([file]);
+				groupSize = space;
+			}
+		});
+		
+		var readFile = function(file, cb) {
 			if(cbProgress) cbProgress('processing_file', file);
 			
 			if(file.size == 0) return cb();
@@ -895,21 +951,25 @@ PAR2Gen.prototype = {
 							self.process(file, self._buf.slice(0, bytesRead), cb);
 						});
 					}, loopDone);
-				} else if(self.readSize >= self.opts.sliceSize || (firstPass && self.opts.noChunkFirstPass)) {
+				} else if(sequential) {
 					// sequential read - read multiple blocks at once
 					var slicesPerRead = Math.max(1, Math.floor(self.readSize / self.opts.sliceSize));
 					async.timesSeries(Math.ceil(file.numSlices / slicesPerRead), function(sliceBatchNum, cb) {
-						fs.read(fd, self._buf, 0, self.opts.sliceSize*slicesPerRead, null, function(err, bytesRead) {
-							if(err) return cb(err);
-							var sliceBatchPos = sliceBatchNum*slicesPerRead;
-							var slicesExpected = Math.min(file.numSlices, slicesPerRead+sliceBatchPos) - sliceBatchPos;
-							if(Math.ceil(bytesRead / self.opts.sliceSize) != slicesExpected)
-								cb(new Error('Data read failure: read ' + bytesRead + ' bytes (' + Math.ceil(bytesRead / self.opts.sliceSize) + ' slices) but expected ' + slicesExpected + ' slices'));
-							async.timesSeries(slicesExpected, function(sliceOffNum, cb) {
-								if(cbProgress) cbProgress('processing_slice', file, sliceBatchPos + sliceOffNum);
-								var bp = sliceOffNum * self.opts.sliceSize;
-								self.process(file, self._buf.slice(bp, Math.min(bytesRead, bp+self.opts.sliceSize)), cb);
-							}, cb);
+						nextReadBuf(function(buf, bufNum) {
+							fs.read(fd, buf, 0, self.opts.sliceSize*slicesPerRead, null, function(err, bytesRead) {
+								if(err) return cb(err);
+								var sliceBatchPos = sliceBatchNum*slicesPerRead;
+								var slicesExpected = Math.min(file.numSlices, slicesPerRead+sliceBatchPos) - sliceBatchPos;
+								if(Math.ceil(bytesRead / self.opts.sliceSize) != slicesExpected)
+									return cb(new Error('Data read failure: read ' + bytesRead + ' bytes (' + Math.ceil(bytesRead / self.opts.sliceSize) + ' slices) but expected ' + slicesExpected + ' slices'));
+								if(hashAsync)
+									self.par2.hashSlicesAsync([file], [buf.slice(0, bytesRead)], hashReadBuf(bufNum));
+								async.timesSeries(slicesExpected, function(sliceOffNum, cb) {
+									if(cbProgress) cbProgress('processing_slice', file, sliceBatchPos + sliceOffNum);
+									var bp = sliceOffNum * self.opts.sliceSize;
+									self.process(file, buf.slice(bp, Math.min(bytesRead, bp+self.opts.sliceSize)), cb);
+								}, cb);
+							});
 						});
 					}, loopDone);
 				} else {
@@ -923,27 +983,77 @@ PAR2Gen.prototype = {
 						var chunkProcessed = false;
 						(function readLoop(cb) {
 							if(!sliceLeft) return cb();
-							fs.read(fd, self._buf, 0, Math.min(sliceLeft, self.readSize), null, function(err, bytesRead) {
-								if(err) return cb(err);
-								if(!bytesRead) return cb(); // EOF
-								sliceLeft -= bytesRead;
-								file.processHash(self._buf.slice(0, bytesRead));
-								if(!chunkProcessed && self._chunker) { // first part - need to feed to chunker
-									chunkProcessed = true;
-									self._chunker.process(file, self._buf.slice(0, Math.min(chunkSize, bytesRead)), function(err) {
-										if(err) cb(err);
-										else readLoop(cb);
-									});
-								} else readLoop(cb);
+							nextReadBuf(function(buf, bufNum) {
+								fs.read(fd, buf, 0, Math.min(sliceLeft, self.readSize), null, function(err, bytesRead) {
+									if(err) return cb(err);
+									if(!bytesRead) return cb(); // EOF
+									sliceLeft -= bytesRead;
+									file.processHash(buf.slice(0, bytesRead), hashReadBuf(bufNum));
+									if(!chunkProcessed && self._chunker) { // first part - need to feed to chunker
+										chunkProcessed = true;
+										self._chunker.process(file, buf.slice(0, Math.min(chunkSize, bytesRead)), function(err) {
+											if(err) cb(err);
+											else readLoop(cb);
+										});
+									} else readLoop(cb);
+								});
 							});
 						})(cb);
 					}, function(err) {
-						if(!err) file.processHashEnd();
-						loopDone(err);
+						if(err) return loopDone(err);
+						// the last slice can only be finalised once all of the file has been hashed
+						self.par2.hashWait(function() {
+							file.processHashEnd();
+							loopDone();
+						});
 					});
 				}
 			});
-		}, cb);
+		};
+		// reads a group of whole files into a buffer, hashes them together, then processes their slices
+		var readFileGroup = function(files, cb) {
+			nextReadBuf(function(buf, bufNum) {
+				var datas = [];
+				var bufPos = 0;
+				async.eachSeries(files, function(file, cb) {
+					fs.open(file.name, 'r', function(err, fd) {
+						if(err) return cb(err);
+						fs.read(fd, buf, bufPos, file.size, 0, function(err, bytesRead) {
+							if(!err && bytesRead != file.size)
+								err = new Error('Data read failure: read ' + bytesRead + ' bytes but expected ' + file.size + ' bytes');
+							if(err) return fs.close(fd, function() { cb(err); });
+							datas.push(buf.slice(bufPos, bufPos + file.size));
+							bufPos += Math.ceil(file.size / self.opts.sliceSize) * self.opts.sliceSize;
+							fs.close(fd, cb);
+						});
+					});
+				}, function(err) {
+					if(err) return cb(err);
+					self.par2.hashSlicesAsync(files, datas, hashReadBuf(bufNum));
+					async.timesSeries(files.length, function(fileNum, cb) {
+						var file = files[fileNum];
+						if(cbProgress) cbProgress('processing_file', file);
+						async.timesSeries(file.numSlices, function(sliceNum, cb) {
+							if(cbProgress) cbProgress('processing_slice', file, sliceNum);
+							var bp = sliceNum * self.opts.sliceSize;
+							self.process(file, datas[fileNum].slice(bp, Math.min(file.size, bp+self.opts.sliceSize)), cb);
+						}, cb);
+					}, cb);
+				});
+			});
+		};
+		async.eachSeries(fileGroups, function(files, cb) {
+			if(files.length == 1)
+				readFile(files[0], cb);
+			else
+				readFileGroup(files, cb);
+		}, function(err) {
+			if(err || !hashAsync) return cb(err);
+			self.par2.hashWait(function() {
+				self._buf2 = null; // only needed for the first pass
+				cb();
+			});
+		});
 	},
 	
 	runChunkPass: function(cbProgress, cb) {
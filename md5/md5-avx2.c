@@ -0,0 +1,18 @@
+#include "md5.h"
+
+#if defined(__AVX2__)
+
+#define MWORD __m256i
+#define MWORD_SIZE 32
+#define MMCLEAR _mm256_zeroupper();
+#define _FN(f) f ## _avx2
+
+#include "md5-sse2.c"
+int md5_available_avx2 = 1;
+
+#else
+int md5_available_avx2 = 0;
+void md5_update_avx2(uint32_t *vals_, const void** data_, size_t num) {
+	(void)vals_; (void)data_; (void)num;
+}
+#endif
@@ -0,0 +1,18 @@
+#include "md5.h"
+
+#if defined(__AVX512F__)
+
+#define MWORD __m512i
+#define MWORD_SIZE 64
+#define MMCLEAR
+#define _FN(f) f ## _avx512
+
+#include "md5-sse2.c"
+int md5_available_avx512 = 1;
+
+#else
+int md5_available_avx512 = 0;
+void md5_update_avx512(uint32_t *vals_, const void** data_, size_t num) {
+	(void)vals_; (void)data_; (void)num;
+}
+#endif
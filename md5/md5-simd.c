@@ -1,12 +1,77 @@
 #include "md5.h"
+#include "../gf16/platform.h"
 
-#ifdef MD5_SIMD_USE_SSE
+#if defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP == 2) || defined(_M_X64)
 
 #define MWORD __m128i
 #define MWORD_SIZE 16
 #define MMCLEAR
+#define _FN(f) f ## _sse
 
 #include "md5-sse2.c"
+int md5_available_sse = 1;
 
+#else
+int md5_available_sse = 0;
+void md5_update_sse(uint32_t *vals_, const void** data_, size_t num) {
+	(void)vals_; (void)data_; (void)num;
+}
 #endif
 
+
+/* CPU detection; see gf16mul.cpp */
+#ifdef PLATFORM_X86
+# ifdef _MSC_VER
+	#include <intrin.h>
+	#define _cpuid __cpuid
+	#define _cpuidX __cpuidex
+	#if _MSC_VER >= 1600
+		#include <immintrin.h>
+		#define _GET_XCR() _xgetbv(_XCR_XFEATURE_ENABLED_MASK)
+	#endif
+# else
+	#include <cpuid.h>
+	#define _cpuid(ar, eax) __cpuid(eax, ar[0], ar[1], ar[2], ar[3])
+	#define _cpuidX(ar, eax, ecx) __cpuid_count(eax, ecx, ar[0], ar[1], ar[2], ar[3])
+	
+	static inline int _GET_XCR() {
+		int xcr0;
+		__asm__ __volatile__("xgetbv" : "=a" (xcr0) : "c" (0) : "%edx");
+		return xcr0;
+	}
+# endif
+#endif
+
+int md5_simd_num = 1;
+md5_update_block_func md5_simd_update_block = &md5_update_single;
+
+/* picks the widest block function the CPU supports; must be called once, before md5_multi_update is used */
+void md5_multi_init(void) {
+	int num = 1;
+	md5_update_block_func func = &md5_update_single;
+#ifdef PLATFORM_X86
+	int cpuInfo[4];
+	_cpuid(cpuInfo, 1);
+	if(md5_available_sse && (cpuInfo[3] & 0x4000000)) { // SSE2
+		num = 4;
+		func = &md5_update_sse;
+	}
+# if !defined(_MSC_VER) || _MSC_VER >= 1600
+	if(cpuInfo[2] & 0x8000000) { // has OSXSAVE
+		int cpuInfoX[4];
+		int xcr = _GET_XCR() & 0xff;
+		_cpuidX(cpuInfoX, 7, 0);
+		if((xcr & 6) == 6 && (cpuInfoX[1] & 0x20) && md5_available_avx2) { // AVX2
+			num = 8;
+			func = &md5_update_avx2;
+		}
+		if((xcr & 0xE6) == 0xE6 && (cpuInfoX[1] & 0x10000) && md5_available_avx512) { // AVX512F
+			num = 16;
+			func = &md5_update_avx512;
+		}
+	}
+# endif
+#endif
+	md5_simd_num = num;
+	md5_simd_update_block = func;
+}
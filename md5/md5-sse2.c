@@ -1,17 +1,29 @@
 
 /* code was originally based off OpenSSL's implementation */
 
-#if defined(__XOP__) || defined(__AVX512VL__)
+#if MWORD_SIZE > 16
+# include <immintrin.h>
+#elif defined(__XOP__) || defined(__AVX512VL__)
 # include <x86intrin.h>
 #else
 # include <emmintrin.h>
 #endif
 
-#define _mm(f) _mm_ ##f
-#define _mmi(f) _mm_ ##f## _si128
+#if MWORD_SIZE == 64
+# define _mm(f) _mm512_ ##f
+# define _mmi(f) _mm512_ ##f## _si512
+#elif MWORD_SIZE == 32
+# define _mm(f) _mm256_ ##f
+# define _mmi(f) _mm256_ ##f## _si256
+#else
+# define _mm(f) _mm_ ##f
+# define _mmi(f) _mm_ ##f## _si128
+#endif
+/* one buffer per 32-bit lane */
+#define MD5_LANES (MWORD_SIZE/4)
 
 
-#ifdef __AVX512VL__
+#if defined(__AVX512VL__) || MWORD_SIZE == 64
 # define F(b,c,d)        _mm(ternarylogic_epi32)(b,c,d,0xCA) /*0b11001010*/
 # define G(b,c,d)        _mm(ternarylogic_epi32)(b,c,d,0xE4) /*0b11100100*/
 # define H(b,c,d)        _mm(ternarylogic_epi32)(b,c,d,0x96) /*0b10010110*/
@@ -30,7 +42,7 @@
 # define H(b,c,d)        _mmi(xor)(_mmi(xor)((d), (c)), (b))
 # define I(b,c,d)        _mmi(xor)(_mmi(or)(_mmi(xor)((d), _mm(set1_epi8(0xFF))), (b)), (c))
 
-# if defined(__XOP__) && MD5_SIMD_NUM == 4
+# if defined(__XOP__) && MWORD_SIZE == 16
 #  define ROTATE          _mm_roti_epi32
 # else
 // TODO: investigate with SSSE3 byte shuffle
@@ -65,12 +77,48 @@ _mm(shufflehi_epi16)(_mm(shufflelo_epi16)((a), 0xb1), 0xb1) \
         (d) = _mm(unpackhi_epi64)(T1, T3); \
 }
 
-void md5_update_sse(uint32_t *vals_, const void** data_, size_t num)
+/* wider vectors: transpose 4x4 within each 128-bit lane, then shuffle the 128-bit lanes across registers */
+#if MD5_LANES == 8
+#define TRANSPOSE8(a, b, c, d, e, f, g, h) { \
+        TRANSPOSE4(a, b, c, d); \
+        TRANSPOSE4(e, f, g, h); \
+        MWORD T4 = _mm256_permute2x128_si256((a), (e), 0x20); \
+        MWORD T5 = _mm256_permute2x128_si256((b), (f), 0x20); \
+        MWORD T6 = _mm256_permute2x128_si256((c), (g), 0x20); \
+        MWORD T7 = _mm256_permute2x128_si256((d), (h), 0x20); \
+        (e) = _mm256_permute2x128_si256((a), (e), 0x31); \
+        (f) = _mm256_permute2x128_si256((b), (f), 0x31); \
+        (g) = _mm256_permute2x128_si256((c), (g), 0x31); \
+        (h) = _mm256_permute2x128_si256((d), (h), 0x31); \
+        (a) = T4; (b) = T5; (c) = T6; (d) = T7; \
+}
+#elif MD5_LANES == 16
+/* a..d hold words k, 4+k, 8+k, 12+k of buffers 0-3, 4-7, 8-11, 12-15 (one per 128-bit lane) */
+#define TRANSPOSE4X128(a, b, c, d) { \
+        MWORD T4 = _mm512_shuffle_i32x4((a), (b), 0x44); \
+        MWORD T5 = _mm512_shuffle_i32x4((a), (b), 0xEE); \
+        MWORD T6 = _mm512_shuffle_i32x4((c), (d), 0x44); \
+        MWORD T7 = _mm512_shuffle_i32x4((c), (d), 0xEE); \
+        (a) = _mm512_shuffle_i32x4(T4, T6, 0x88); \
+        (b) = _mm512_shuffle_i32x4(T4, T6, 0xDD); \
+        (c) = _mm512_shuffle_i32x4(T5, T7, 0x88); \
+        (d) = _mm512_shuffle_i32x4(T5, T7, 0xDD); \
+}
+#endif
+
+void _FN(md5_update)(uint32_t *vals_, const void** data_, size_t num)
 {
+#if MD5_LANES == 4 || MD5_LANES == 2
     const MWORD *data0 = (MWORD*)data_[0];
     const MWORD *data1 = (MWORD*)data_[1];
     const MWORD *data2 = (MWORD*)data_[2];
     const MWORD *data3 = (MWORD*)data_[3];
+#else
+    const MWORD *data[MD5_LANES];
+    int lane;
+    for(lane=0; lane<MD5_LANES; lane++)
+        data[lane] = (MWORD*)data_[lane];
+#endif
     MWORD A, B, C, D;
     MWORD oA, oB, oC, oD;
     MWORD* vals = (MWORD*)vals_;
@@ -87,8 +135,56 @@ void md5_update_sse(uint32_t *vals_, const void** data_, size_t num)
     /* this may spill too much on 32-bit, consider 64-bit reads? */
 /* TODO: enforce alignment? */
 
-#if MD5_SIMD_NUM == 4
+#if MD5_LANES == 16
+#define READ2(a, b)
+#define READ4(a, b, c, d)
+#define READ8(a, b, c, d, e, f, g, h)
+/* each buffer's whole block is one vector, so X(n) initially holds buffer n's block */
+#define READ16() \
+        X(0) = _mmi(loadu)(data[0]++); \
+        X(1) = _mmi(loadu)(data[1]++); \
+        X(2) = _mmi(loadu)(data[2]++); \
+        X(3) = _mmi(loadu)(data[3]++); \
+        X(4) = _mmi(loadu)(data[4]++); \
+        X(5) = _mmi(loadu)(data[5]++); \
+        X(6) = _mmi(loadu)(data[6]++); \
+        X(7) = _mmi(loadu)(data[7]++); \
+        X(8) = _mmi(loadu)(data[8]++); \
+        X(9) = _mmi(loadu)(data[9]++); \
+        X(10) = _mmi(loadu)(data[10]++); \
+        X(11) = _mmi(loadu)(data[11]++); \
+        X(12) = _mmi(loadu)(data[12]++); \
+        X(13) = _mmi(loadu)(data[13]++); \
+        X(14) = _mmi(loadu)(data[14]++); \
+        X(15) = _mmi(loadu)(data[15]++); \
+        \
+        TRANSPOSE4(X( 0), X( 1), X( 2), X( 3)); \
+        TRANSPOSE4(X( 4), X( 5), X( 6), X( 7)); \
+        TRANSPOSE4(X( 8), X( 9), X(10), X(11)); \
+        TRANSPOSE4(X(12), X(13), X(14), X(15)); \
+        TRANSPOSE4X128(X( 0), X( 4), X( 8), X(12)); \
+        TRANSPOSE4X128(X( 1), X( 5), X( 9), X(13)); \
+        TRANSPOSE4X128(X( 2), X( 6), X(10), X(14)); \
+        TRANSPOSE4X128(X( 3), X( 7), X(11), X(15))
+#elif MD5_LANES == 8
+#define READ2(a, b)
+#define READ4(a, b, c, d)
+#define READ16()
+#define READ8(a, b, c, d, e, f, g, h) \
+        X(a) = _mmi(loadu)(data[0]++); \
+        X(b) = _mmi(loadu)(data[1]++); \
+        X(c) = _mmi(loadu)(data[2]++); \
+        X(d) = _mmi(loadu)(data[3]++); \
+        X(e) = _mmi(loadu)(data[4]++); \
+        X(f) = _mmi(loadu)(data[5]++); \
+        X(g) = _mmi(loadu)(data[6]++); \
+        X(h) = _mmi(loadu)(data[7]++); \
+        \
+        do TRANSPOSE8(X(a), X(b), X(c), X(d), X(e), X(f), X(g), X(h)) while(0)
+#elif MD5_LANES == 4
 #define READ2(a, b)
+#define READ8(a, b, c, d, e, f, g, h)
+#define READ16()
 #define READ4(a, b, c, d) \
         X(a) = _mmi(loadu)(data0++); \
         X(b) = _mmi(loadu)(data1++); \
@@ -96,7 +192,9 @@ void md5_update_sse(uint32_t *vals_, const void** data_, size_t num)
         X(d) = _mmi(loadu)(data3++); \
         \
         do TRANSPOSE4(X(a), X(b), X(c), X(d)) while(0)
-#elif MD5_SIMD_NUM == 2
+#elif MD5_LANES == 2
+#define READ8(a, b, c, d, e, f, g, h)
+#define READ16()
 #define READ2(a, b) \
         X(a) = _mm_loadl_epi64(data0++); \
         X(b) = _mm_loadl_epi64(data1++); \
@@ -118,6 +216,8 @@ void md5_update_sse(uint32_t *vals_, const void** data_, size_t num)
         C = oC;
         D = oD;
 
+        READ16();
+        READ8(0, 1, 2, 3, 4, 5, 6, 7);
         READ4(0, 1, 2, 3);
         READ2(0, 1);
         /* Round 0 */
@@ -133,6 +233,7 @@ void md5_update_sse(uint32_t *vals_, const void** data_, size_t num)
         READ2(6, 7);
         RX(F, C, D, A, B, X( 6), 17, 0xa8304613L);
         RX(F, B, C, D, A, X( 7), 22, 0xfd469501L);
+        READ8( 8,  9, 10, 11, 12, 13, 14, 15);
         READ4( 8,  9, 10, 11);
         READ2( 8,  9);
         RX(F, A, B, C, D, X( 8),  7, 0x698098d8L);
@@ -285,11 +285,10 @@ void md5_init(MD5_CTX *c)
 	c->h[3] = 0x10325476L;
 }
 
-/* TODO: do we care about runtime CPU detection here? */
-void md5_multi_update(MD5_CTX **c, const void **data_, size_t len)
+static void md5_multi_update_lanes(MD5_CTX **c, const void **data_, size_t len, const int lanes, md5_update_block_func update_block)
 {
-    const unsigned char *data[MD5_SIMD_NUM];
-    uint32_t md5vals[MD5_SIMD_NUM*4];
+    const unsigned char *data[MD5_SIMD_MAX];
+    uint32_t md5vals[MD5_SIMD_MAX*4];
     size_t n = len / MD5_BLOCKSIZE;
     int i;
 
@@ -298,13 +297,13 @@ void md5_multi_update(MD5_CTX **c, const void **data_, size_t len)
 
     if (n) {
          /* firstly, if there's any pending block, reduce number of blocks by 1 */
-        for(i=0; i<MD5_SIMD_NUM; i++)
+        for(i=0; i<lanes; i++)
             if (c[i]->dataLen != 0) {
                 n--;
                 break;
             }
     }
-    for(i=0; i<MD5_SIMD_NUM; i++) {
+    for(i=0; i<lanes; i++) {
         size_t leftOver = len - (n*MD5_BLOCKSIZE) + c[i]->dataLen;
         data[i] = data_[i];
         while (leftOver >= MD5_BLOCKSIZE) {
@@ -324,22 +323,144 @@ void md5_multi_update(MD5_CTX **c, const void **data_, size_t len)
         /* re-arrange ABCD from contexts to easy to use SIMD form */
         /* TODO: this should be done by callee? */
         if(n) {
-            md5vals[0*MD5_SIMD_NUM + i] = c[i]->h[0];
-            md5vals[1*MD5_SIMD_NUM + i] = c[i]->h[1];
-            md5vals[2*MD5_SIMD_NUM + i] = c[i]->h[2];
-            md5vals[3*MD5_SIMD_NUM + i] = c[i]->h[3];
+            md5vals[0*lanes + i] = c[i]->h[0];
+            md5vals[1*lanes + i] = c[i]->h[1];
+            md5vals[2*lanes + i] = c[i]->h[2];
+            md5vals[3*lanes + i] = c[i]->h[3];
         }
     }
 
     if (n > 0) {
-        MD5_SIMD_UPDATE_BLOCK(md5vals, (const void**)data, n);
+        update_block(md5vals, (const void**)data, n);
         n *= MD5_BLOCKSIZE;
-        for(i=0; i<MD5_SIMD_NUM; i++) {
+        for(i=0; i<lanes; i++) {
             data[i] += n;
-            c[i]->h[0] = md5vals[0*MD5_SIMD_NUM + i];
-            c[i]->h[1] = md5vals[1*MD5_SIMD_NUM + i];
-            c[i]->h[2] = md5vals[2*MD5_SIMD_NUM + i];
-            c[i]->h[3] = md5vals[3*MD5_SIMD_NUM + i];
+            c[i]->h[0] = md5vals[0*lanes + i];
+            c[i]->h[1] = md5vals[1*lanes + i];
+            c[i]->h[2] = md5vals[2*lanes + i];
+            c[i]->h[3] = md5vals[3*lanes + i];
+        }
+    }
+}
+
+/* processes md5_simd_num contexts, using the block function selected by md5_multi_init */
+void md5_multi_update(MD5_CTX **c, const void **data_, size_t len)
+{
+    md5_multi_update_lanes(c, data_, len, md5_simd_num, md5_simd_update_block);
+}
+
+/* single context update, for when there's nothing to fill the other SIMD lanes with */
+void md5_update(MD5_CTX *c, const void *data, size_t len)
+{
+    md5_multi_update_lanes(&c, &data, len, 1, &md5_update_single);
+}
+
+/* adds len bytes to c, hashing any pending partial block and buffering the trailing partial block;
+ * returns the number of whole blocks left for the caller to hash, which start at the updated *data */
+static size_t md5_batch_prepare(MD5_CTX *c, const unsigned char **data, size_t len)
+{
+    size_t n, leftOver;
+
+    c->length += ((uint64_t)len) << 3;
+    if (c->dataLen) {
+        size_t fill = MD5_BLOCKSIZE - c->dataLen;
+        if (len < fill) {
+            memcpy((char*)c->data + c->dataLen, *data, len);
+            c->dataLen += (int8_t)len;
+            return 0;
+        }
+        memcpy((char*)c->data + c->dataLen, *data, fill);
+        md5_update_block(c->h, c->data);
+        c->dataLen = 0;
+        *data += fill;
+        len -= fill;
+    }
+    n = len / MD5_BLOCKSIZE;
+    leftOver = len - n*MD5_BLOCKSIZE;
+    if (leftOver) {
+        memcpy(c->data, *data + n*MD5_BLOCKSIZE, leftOver);
+        c->dataLen = (int8_t)leftOver;
+    }
+    return n;
+}
+
+/* updates num contexts, each with its own data and length, using all md5_simd_num lanes
+ * a lane takes the next context as soon as its current one runs out of blocks, so differing lengths only leave lanes idle once the batch runs dry
+ * each context must appear at most once in the batch */
+void md5_update_batch(MD5_CTX **c, const void **data_, const size_t *len, unsigned num)
+{
+    const int lanes = md5_simd_num;
+    const unsigned char *data[MD5_SIMD_MAX];
+    size_t blocks[MD5_SIMD_MAX];
+    unsigned laneCtx[MD5_SIMD_MAX];
+    uint32_t md5vals[MD5_SIMD_MAX*4];
+    unsigned next = 0;
+    int i, active = 0;
+
+    for(i=0; i<lanes; i++)
+        blocks[i] = 0;
+
+    while (1) {
+        const unsigned char *activeData = NULL;
+        size_t run = 0;
+
+        /* hand contexts to idle lanes */
+        for(i=0; i<lanes; i++) {
+            while (!blocks[i] && next < num) {
+                MD5_CTX *ctx = c[next];
+                data[i] = (const unsigned char*)data_[next];
+                blocks[i] = md5_batch_prepare(ctx, &data[i], len[next]);
+                laneCtx[i] = next++;
+                if (blocks[i]) {
+                    md5vals[0*lanes + i] = ctx->h[0];
+                    md5vals[1*lanes + i] = ctx->h[1];
+                    md5vals[2*lanes + i] = ctx->h[2];
+                    md5vals[3*lanes + i] = ctx->h[3];
+                    active++;
+                }
+            }
+        }
+        if (!active)
+            break;
+
+        if (active == 1) {
+            /* nothing to share the vector with (either out of contexts, or no SIMD), so a scalar hash is faster */
+            for(i=0; !blocks[i]; i++);
+            c[laneCtx[i]]->h[0] = md5vals[0*lanes + i];
+            c[laneCtx[i]]->h[1] = md5vals[1*lanes + i];
+            c[laneCtx[i]]->h[2] = md5vals[2*lanes + i];
+            c[laneCtx[i]]->h[3] = md5vals[3*lanes + i];
+            md5_update_single(c[laneCtx[i]]->h, (const void**)&data[i], blocks[i]);
+            blocks[i] = 0;
+            active = 0;
+            continue;
+        }
+
+        /* run until the shortest lane retires; idle lanes hash (and discard) a copy of an active lane's data */
+        for(i=0; i<lanes; i++) {
+            if (blocks[i] && (!run || blocks[i] < run)) {
+                run = blocks[i];
+                activeData = data[i];
+            }
+        }
+        for(i=0; i<lanes; i++)
+            if (!blocks[i])
+                data[i] = activeData;
+        md5_simd_update_block(md5vals, (const void**)data, run);
+
+        for(i=0; i<lanes; i++) {
+            if (!blocks[i])
+                continue;
+            data[i] += run*MD5_BLOCKSIZE;
+            blocks[i] -= run;
+            if (!blocks[i]) {
+                MD5_CTX *ctx = c[laneCtx[i]];
+                ctx->h[0] = md5vals[0*lanes + i];
+                ctx->h[1] = md5vals[1*lanes + i];
+                ctx->h[2] = md5vals[2*lanes + i];
+                ctx->h[3] = md5vals[3*lanes + i];
+                active--;
+            }
         }
     }
 }
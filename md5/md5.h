@@ -13,21 +13,24 @@ typedef struct {
 void md5_final(unsigned char md[16], MD5_CTX *c);
 void md5_init(MD5_CTX *c);
 void md5_multi_update(MD5_CTX **c, const void **data_, size_t len);
+void md5_update(MD5_CTX *c, const void *data, size_t len);
+void md5_update_batch(MD5_CTX **c, const void **data_, const size_t *len, unsigned num);
 void md5_update_zeroes(MD5_CTX *c, size_t len);
 
 
-#if defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP == 2) || defined(_M_X64)
-/* SSE2 support */
-#define MD5_SIMD_NUM 4
-#define MD5_SIMD_UPDATE_BLOCK md5_update_sse
-#define MD5_SIMD_USE_SSE
-#endif
+/* md5_multi_update processes md5_simd_num contexts at once; this is picked at runtime by md5_multi_init, based on the CPU */
+#define MD5_SIMD_MAX 16
+extern int md5_simd_num;
+void md5_multi_init(void);
 
+typedef void(*md5_update_block_func)(uint32_t *vals_, const void** data_, size_t num);
+extern md5_update_block_func md5_simd_update_block;
 
-/* fallback */
-#ifndef MD5_SIMD_UPDATE_BLOCK
-#define MD5_SIMD_NUM 1
-#define MD5_SIMD_UPDATE_BLOCK md5_update_single
-#endif
-
-void MD5_SIMD_UPDATE_BLOCK(uint32_t *vals_, const void** data_, size_t num);
+/* block functions; each takes md5_simd_num sets of ABCD, arranged as A[lanes], B[lanes] etc */
+void md5_update_single(uint32_t *vals_, const void** data_, size_t num);
+void md5_update_sse(uint32_t *vals_, const void** data_, size_t num);
+void md5_update_avx2(uint32_t *vals_, const void** data_, size_t num);
+void md5_update_avx512(uint32_t *vals_, const void** data_, size_t num);
+extern int md5_available_sse;
+extern int md5_available_avx2;
+extern int md5_available_avx512;
@@ -1,6 +1,7 @@
 
 #include <node.h>
 #include <node_buffer.h>
+#include <node_object_wrap.h>
 #include <node_version.h>
 #include <v8.h>
 #include <stdlib.h>
@@ -15,15 +16,10 @@
 #include "../gf16/module.h"
 
 extern "C" {
-#ifdef _OPENMP
-#include <omp.h>
-#endif
 #include "../md5/md5.h"
+#include "../crc/crc32.h"
 }
 
-static int MEM_ALIGN, MEM_STRIDE;
-
-
 using namespace v8;
 
 /*******************************************/
@@ -84,30 +80,155 @@ using namespace v8;
 
 
 
-int mmActiveTasks = 0;
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+# define NEW_FUNC_TEMPLATE(f, data) FunctionTemplate::New(isolate, f, data)
+# define NEW_EXTERNAL(p) External::New(isolate, p)
+#else
+# define NEW_FUNC_TEMPLATE(f, data) FunctionTemplate::New(f, data)
+# define NEW_EXTERNAL(p) External::New(p)
+#endif
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+# define TEMPLATE_TO_FUNC(t) (t)->GetFunction(isolate->GetCurrentContext()).ToLocalChecked()
+#else
+# define TEMPLATE_TO_FUNC(t) (t)->GetFunction()
+#endif
+
+
+#if NODE_VERSION_AT_LEAST(14, 8, 0)
+static void free_context_hook(void* _gfc, void (*done)(void*), void* doneArg);
+#elif NODE_VERSION_AT_LEAST(12, 0, 0)
+static void free_context_hook(void* _gfc);
+#endif
+
+// a GF context exposed to JS; each has its own method, scratch memory and threads, so jobs on different contexts can run concurrently
+class GfContext : public node::ObjectWrap {
+public:
+	PPGFContext* ctx;
+	int memAlign, memStride;
+	int activeTasks;
+	bool dying; // set when the context's environment (e.g. a worker thread) is torn down; if a job is running, the context is freed when it completes
+#if NODE_VERSION_AT_LEAST(14, 8, 0)
+	node::AsyncCleanupHookHandle cleanupHook;
+	void (*cleanupDone)(void*);
+	void* cleanupDoneArg;
+#elif NODE_VERSION_AT_LEAST(12, 0, 0)
+	Isolate* isolate;
+#endif
+	using node::ObjectWrap::Wrap;
+	
+	GfContext() : activeTasks(0), dying(false) {
+		ctx = ppgf_create_context();
+		update_method_info();
+	}
+	~GfContext() {
+		// if not freed by the cleanup hook (i.e. garbage collected), the hook is no longer needed
+#if NODE_VERSION_AT_LEAST(14, 8, 0)
+		if(!dying) node::RemoveEnvironmentCleanupHook(std::move(cleanupHook));
+#elif NODE_VERSION_AT_LEAST(12, 0, 0)
+		if(!dying) node::RemoveEnvironmentCleanupHook(isolate, free_context_hook, this);
+#endif
+		ppgf_destroy_context(ctx);
+	}
+	void update_method_info(int* rMethod = NULL, const char** rMethLong = NULL) {
+		int method;
+		const char* methLong;
+		ppgf_get_method(ctx, &method, &methLong, &memAlign, &memStride);
+		if(rMethod) *rMethod = method;
+		if(rMethLong) *rMethLong = methLong;
+	}
+#if NODE_VERSION_AT_LEAST(12, 0, 0)
+	// free the context when its environment (e.g. a worker thread) is torn down
+	void add_cleanup_hook(Isolate* isolate) {
+# if NODE_VERSION_AT_LEAST(14, 8, 0)
+		cleanupHook = node::AddEnvironmentCleanupHook(isolate, free_context_hook, this);
+# else
+		this->isolate = isolate;
+		node::AddEnvironmentCleanupHook(isolate, free_context_hook, this);
+# endif
+	}
+#endif
+};
+
+#if NODE_VERSION_AT_LEAST(12, 0, 0)
+static void free_dying_context(GfContext* gfc) {
+# if NODE_VERSION_AT_LEAST(14, 8, 0)
+	void (*done)(void*) = gfc->cleanupDone;
+	void* doneArg = gfc->cleanupDoneArg;
+	delete gfc;
+	done(doneArg);
+# else
+	delete gfc;
+# endif
+}
+# if NODE_VERSION_AT_LEAST(14, 8, 0)
+// the environment's teardown waits until done is called, so a running job can finish using the context first
+static void free_context_hook(void* _gfc, void (*done)(void*), void* doneArg) {
+	GfContext* gfc = (GfContext*)_gfc;
+	gfc->cleanupDone = done;
+	gfc->cleanupDoneArg = doneArg;
+# else
+static void free_context_hook(void* _gfc) {
+	GfContext* gfc = (GfContext*)_gfc;
+# endif
+	gfc->dying = true;
+	if(!gfc->activeTasks)
+		free_dying_context(gfc);
+}
+#endif
+
+// called from the after-work callbacks; returns false if the context's environment is going away, in which case JS mustn't be called
+static bool context_task_done(GfContext* gfc) {
+	gfc->activeTasks--;
+#if NODE_VERSION_AT_LEAST(12, 0, 0)
+	if(gfc->dying) {
+		if(!gfc->activeTasks)
+			free_dying_context(gfc);
+		return false;
+	}
+#endif
+	return true;
+}
+
+// functions are either called on a GfContext object, or at module level, where they're bound to the module's default context
+#define GET_CONTEXT \
+	GfContext* gfc = args.Data()->IsExternal() ? (GfContext*)Local<External>::Cast(args.Data())->Value() : node::ObjectWrap::Unwrap<GfContext>(args.Holder())
+
+FUNC(NewContext) {
+	FUNC_START;
+	if (!args.IsConstructCall())
+		RETURN_ERROR("GfContext must be called with `new`");
+	
+	GfContext* gfc = new GfContext();
+#if NODE_VERSION_AT_LEAST(12, 0, 0)
+	gfc->add_cleanup_hook(isolate);
+#endif
+	gfc->Wrap(args.This());
+	RETURN_VAL(args.This());
+}
 
-#ifdef _OPENMP
 FUNC(SetMaxThreads) {
 	FUNC_START;
+	GET_CONTEXT;
 	
 	if (args.Length() < 1)
 		RETURN_ERROR("Argument required");
-	if (mmActiveTasks)
+	if (gfc->activeTasks)
 		RETURN_ERROR("Calculation already in progress");
 	
-	ppgf_set_num_threads(ARG_TO_INT(args[0]));
+	ppgf_set_num_threads(gfc->ctx, ARG_TO_INT(args[0]));
 	
 	RETURN_UNDEF
 }
-#endif
 
 FUNC(GetNumThreads) {
 	FUNC_START;
-	RETURN_VAL(Integer::New(ISOLATE ppgf_get_num_threads()));
+	GET_CONTEXT;
+	RETURN_VAL(Integer::New(ISOLATE ppgf_get_num_threads(gfc->ctx)));
 }
 
 FUNC(PrepInput) {
 	FUNC_START;
+	GET_CONTEXT;
 	
 	if (args.Length() < 2 || !node::Buffer::HasInstance(args[0]) || !node::Buffer::HasInstance(args[1]))
 		RETURN_ERROR("Two Buffers required");
@@ -117,18 +238,19 @@ FUNC(PrepInput) {
 	char* dest = node::Buffer::Data(args[1]);
 	char* src = node::Buffer::Data(args[0]);
 	
-	if((uintptr_t)dest & (MEM_ALIGN-1))
+	if((uintptr_t)dest & (gfc->memAlign-1))
 		RETURN_ERROR("Destination not aligned");
-	if(((inputLen + (MEM_STRIDE-1)) & ~(MEM_STRIDE-1)) > destLen)
+	if(((inputLen + (gfc->memStride-1)) & ~(gfc->memStride-1)) > destLen)
 		RETURN_ERROR("Destination not large enough to hold input");
 	
-	ppgf_prep_input(destLen, inputLen, dest, src);
+	ppgf_prep_input(gfc->ctx, destLen, inputLen, dest, src);
 	
 	RETURN_UNDEF
 }
 
 FUNC(AlignmentOffset) {
 	FUNC_START;
+	GET_CONTEXT;
 	
 	if (args.Length() < 1)
 		RETURN_ERROR("Argument required");
@@ -136,7 +258,15 @@ FUNC(AlignmentOffset) {
 	if (!node::Buffer::HasInstance(args[0]))
 		RETURN_ERROR("Argument must be a Buffer");
 	
-	RETURN_VAL( Integer::New(ISOLATE (intptr_t)node::Buffer::Data(args[0]) & (MEM_ALIGN-1)) );
+	// defaults to the context's alignment
+	intptr_t align = gfc->memAlign;
+	if (args.Length() >= 2 && !args[1]->IsUndefined()) {
+		align = ARG_TO_INT(args[1]);
+		if (align < 1 || (align & (align-1)))
+			RETURN_ERROR("Alignment must be a power of 2");
+	}
+	
+	RETURN_VAL( Integer::New(ISOLATE (intptr_t)node::Buffer::Data(args[0]) & (align-1)) );
 }
 
 #define CLEANUP_MM { \
@@ -153,10 +283,12 @@ struct MMRequest {
 #if NODE_VERSION_AT_LEAST(0, 11, 0)
 		inputBuffers.Reset();
 		outputBuffers.Reset();
+		contextObj.Reset();
 		obj_.Reset();
 #else
 		inputBuffers.Dispose();
 		outputBuffers.Dispose();
+		contextObj.Dispose();
 		//if (obj_.IsEmpty()) return;
 		obj_.Dispose();
 		obj_.Clear();
@@ -169,6 +301,7 @@ struct MMRequest {
 	Persistent<Object> obj_;
 	uv_work_t work_req_;
 	
+	GfContext* gfc;
 	const void* const* inputs;
 	uint_fast16_t* iNums;
 	unsigned int numInputs;
@@ -181,19 +314,18 @@ struct MMRequest {
 	// persist copies of buffers for the duration of the job
 	Persistent<Array> inputBuffers;
 	Persistent<Array> outputBuffers;
+	// also keep the context alive
+	Persistent<Object> contextObj;
 };
 
 static void MMWork(uv_work_t* work_req) {
 	MMRequest* req = (MMRequest*)work_req->data;
 	ppgf_multiply_mat(
-		req->inputs, req->iNums, req->numInputs, req->len, req->outputs, req->oNums, req->numOutputs, req->add
+		req->gfc->ctx, req->inputs, req->iNums, req->numInputs, req->len, req->outputs, req->oNums, req->numOutputs, req->add
 	);
 }
-static void MMAfter(uv_work_t* work_req, int status) {
-	assert(status == 0);
-	MMRequest* req = (MMRequest*)work_req->data;
-	
-	mmActiveTasks--;
+// calls the JS callback of a completed async request
+template<class R> static void req_call_ondone(R* req) {
 #if NODE_VERSION_AT_LEAST(0, 11, 0)
 	HandleScope scope(req->isolate);
 	Local<Object> obj = Local<Object>::New(req->isolate, req->obj_);
@@ -208,14 +340,22 @@ static void MMAfter(uv_work_t* work_req, int status) {
 	HandleScope scope;
 	node::MakeCallback(req->obj_, "ondone", 0, NULL);
 #endif
+}
+static void MMAfter(uv_work_t* work_req, int status) {
+	assert(status == 0);
+	MMRequest* req = (MMRequest*)work_req->data;
+	
+	if(context_task_done(req->gfc))
+		req_call_ondone(req);
 	
 	delete req;
 }
 
 FUNC(MultiplyMulti) {
 	FUNC_START;
+	GET_CONTEXT;
 	
-	if (mmActiveTasks)
+	if (gfc->activeTasks)
 		RETURN_ERROR("Calculation already in progress");
 	if (args.Length() < 4)
 		RETURN_ERROR("4 arguments required");
@@ -256,7 +396,7 @@ FUNC(MultiplyMulti) {
 		
 		inputs[i] = node::Buffer::Data(input);
 		uintptr_t inputAddr = (uintptr_t)inputs[i];
-		if (inputAddr & (MEM_ALIGN-1))
+		if (inputAddr & (gfc->memAlign-1))
 			RTN_ERROR("All input buffers must be address aligned");
 		
 		if(i) {
@@ -264,7 +404,7 @@ FUNC(MultiplyMulti) {
 				RTN_ERROR("All inputs' length must be equal");
 		} else {
 			len = node::Buffer::Length(input);
-			if ((len & (MEM_STRIDE-1)) != 0)
+			if ((len & (gfc->memStride-1)) != 0)
 				RTN_ERROR("Length of input must be a multiple of stride");
 		}
 		
@@ -283,7 +423,7 @@ FUNC(MultiplyMulti) {
 			RTN_ERROR("All outputs' length must equal or greater than the input's length");
 		// the length of output buffers should all be equal, but I'm too lazy to check for that :P
 		outputs[i] = node::Buffer::Data(output);
-		if ((uintptr_t)outputs[i] & (MEM_ALIGN-1))
+		if ((uintptr_t)outputs[i] & (gfc->memAlign-1))
 			RTN_ERROR("All output buffers must be address aligned");
 		int rbNum = ARG_TO_INT(GET_ARR(oRBNums, i));
 		if (rbNum < 0 || rbNum > 65535)
@@ -302,7 +442,7 @@ FUNC(MultiplyMulti) {
 #endif
 	}
 	
-	ppgf_maybe_setup_gf();
+	ppgf_maybe_setup_gf(gfc->ctx);
 	
 	if (args.Length() >= 6 && args[5]->IsFunction()) {
 		MMRequest* req = new MMRequest();
@@ -312,6 +452,7 @@ FUNC(MultiplyMulti) {
 		req->isolate = isolate;
 #endif
 		
+		req->gfc = gfc;
 		req->inputs = inputs;
 		req->iNums = iNums;
 		req->numInputs = numInputs;
@@ -331,6 +472,7 @@ FUNC(MultiplyMulti) {
 		// keep a copy of the buffers so that they don't get GC'd whilst being written to
 		req->inputBuffers.Reset(ISOLATE Local<Array>::Cast(args[0]));
 		req->outputBuffers.Reset(ISOLATE Local<Array>::Cast(args[2]));
+		req->contextObj.Reset(ISOLATE args.Holder());
 #else
 		req->obj_ = Persistent<Object>::New(ISOLATE Object::New());
 		req->obj_->Set(NEW_STRING("ondone"), args[5]);
@@ -339,13 +481,13 @@ FUNC(MultiplyMulti) {
 		// keep a copy of the buffers so that they don't get GC'd whilst being written to
 		req->inputBuffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[0]));
 		req->outputBuffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[2]));
+		req->contextObj = Persistent<Object>::New(ISOLATE args.Holder());
 #endif
 		
-		mmActiveTasks++;
+		gfc->activeTasks++;
 		uv_queue_work(
-#if NODE_VERSION_AT_LEAST(0, 11, 0)
-			//env->event_loop(),
-			uv_default_loop(),
+#if NODE_VERSION_AT_LEAST(10, 0, 0)
+			node::GetCurrentEventLoop(isolate), // may be a worker thread's loop
 #else
 			uv_default_loop(),
 #endif
@@ -356,7 +498,7 @@ FUNC(MultiplyMulti) {
 		// does req->obj_ need to be returned?
 	} else {
 		ppgf_multiply_mat(
-			inputs, iNums, numInputs,
+			gfc->ctx, inputs, iNums, numInputs,
 			len, outputs, oNums, numOutputs, add
 		);
 		CLEANUP_MM
@@ -364,9 +506,108 @@ FUNC(MultiplyMulti) {
 	RETURN_UNDEF
 }
 
+// untransforms recovery buffers, optionally updating an MD5 for each
+struct FinishJob {
+	FinishJob() : inputs(NULL), md5(NULL) {}
+	~FinishJob() {
+		delete[] inputs;
+		delete[] md5;
+	}
+	PPGFContext* ctx;
+	uint16_t** inputs;
+	unsigned int numInputs;
+	size_t bufLen;
+	MD5_CTX** md5; // NULL if not hashing
+	size_t md5Len;
+	unsigned int group; // buffers per task
+	size_t chunkSize;
+};
+// each task handles a group of buffers (up to one per MD5 lane), a chunk at a time, so that MD5 reads data which finish has just written
+static void finish_md5_task(void* arg, unsigned task, unsigned) {
+	FinishJob* job = (FinishJob*)arg;
+	unsigned first = task * job->group;
+	unsigned num = job->numInputs - first;
+	if(num > job->group) num = job->group;
+	const void* data[MD5_SIMD_MAX];
+	size_t lens[MD5_SIMD_MAX];
+	
+	for(size_t pos = 0; pos < job->bufLen; pos += job->chunkSize) {
+		size_t chunkLen = job->bufLen - pos;
+		if(chunkLen > job->chunkSize) chunkLen = job->chunkSize;
+		for(unsigned i = 0; i < num; i++)
+			ppgf_finish_partial(job->ctx, (char*)job->inputs[first+i] + pos, chunkLen);
+		
+		if(pos < job->md5Len) {
+			size_t hashLen = job->md5Len - pos;
+			if(hashLen > chunkLen) hashLen = chunkLen;
+			for(unsigned i = 0; i < num; i++) {
+				data[i] = (char*)job->inputs[first+i] + pos;
+				lens[i] = hashLen;
+			}
+			md5_update_batch(job->md5 + first, data, lens, num);
+		}
+	}
+}
+static void finish_run(FinishJob* job) {
+	if(!job->numInputs) return;
+	if(!job->md5) {
+		ppgf_finish_input(job->ctx, job->numInputs, job->inputs, job->bufLen);
+		return;
+	}
+	ppgf_run_tasks(job->ctx, (job->numInputs + job->group-1) / job->group, &finish_md5_task, job);
+}
+
+struct FinishRequest {
+	~FinishRequest() {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		inputBuffers.Reset();
+		md5Buffers.Reset();
+		contextObj.Reset();
+		obj_.Reset();
+#else
+		inputBuffers.Dispose();
+		md5Buffers.Dispose();
+		contextObj.Dispose();
+		obj_.Dispose();
+		obj_.Clear();
+#endif
+	};
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Isolate* isolate;
+#endif
+	Persistent<Object> obj_;
+	uv_work_t work_req_;
+	
+	GfContext* gfc;
+	FinishJob job;
+	
+	// persist copies of buffers for the duration of the job
+	Persistent<Array> inputBuffers;
+	Persistent<Array> md5Buffers;
+	Persistent<Object> contextObj;
+};
+
+static void FinishWork(uv_work_t* work_req) {
+	FinishRequest* req = (FinishRequest*)work_req->data;
+	finish_run(&req->job);
+}
+static void FinishAfter(uv_work_t* work_req, int status) {
+	assert(status == 0);
+	FinishRequest* req = (FinishRequest*)work_req->data;
+	
+	if(context_task_done(req->gfc))
+		req_call_ondone(req);
+	
+	delete req;
+}
+
+// untransforms recovery data from the method's internal layout, updating the MD5 contexts (if given) with the first len bytes of each buffer
 FUNC(Finish) {
 	FUNC_START;
+	GET_CONTEXT;
 	
+	if (gfc->activeTasks)
+		RETURN_ERROR("Calculation already in progress");
 	if (args.Length() < 2)
 		RETURN_ERROR("At least two arguments required");
 	
@@ -374,26 +615,22 @@ FUNC(Finish) {
 		RETURN_ERROR("First argument must be an array");
 	
 	unsigned int numInputs = Local<Array>::Cast(args[0])->Length();
-	unsigned int allocArrSize = numInputs;
-	if(numInputs < 1) RETURN_UNDEF
 	
 	Local<Object> oInputs = ARG_TO_OBJ(args[0]);
 	bool calcMd5 = false;
-	if (args.Length() >= 3 && !args[2]->IsUndefined()) {
+	if (args.Length() >= 3 && !args[2]->IsUndefined() && !args[2]->IsNull()) {
 		if (!args[2]->IsArray())
 			RETURN_ERROR("MD5 contexts not an array");
 		if (Local<Array>::Cast(args[2])->Length() != numInputs)
 			RETURN_ERROR("Number of MD5 contexts doesn't equal number of inputs");
-		calcMd5 = true;
-		
-		if(numInputs % MD5_SIMD_NUM)
-			// if calculating MD5, allocate some more space to make parallel processing easier
-			allocArrSize += MD5_SIMD_NUM - (numInputs % MD5_SIMD_NUM);
+		calcMd5 = numInputs > 0;
 	}
-	uint16_t** inputs = new uint16_t*[allocArrSize];
+	uint16_t** inputs = new uint16_t*[numInputs];
+	MD5_CTX** md5 = calcMd5 ? new MD5_CTX*[numInputs] : NULL;
 	
 	#define RTN_ERROR(m) { \
 		delete[] inputs; \
+		delete[] md5; \
 		RETURN_ERROR(m); \
 	}
 	
@@ -416,54 +653,89 @@ FUNC(Finish) {
 		} else {
 			bufLen = currentLen;
 		}
-		if((uintptr_t)(node::Buffer::Data(input)) & (MEM_ALIGN-1))
-			RETURN_ERROR("All inputs' must be aligned");
+		if((uintptr_t)(node::Buffer::Data(input)) & (gfc->memAlign-1))
+			RTN_ERROR("All inputs' must be aligned");
 	}
-	if ((bufLen & (MEM_STRIDE-1)) != 0)
+	if ((bufLen & (gfc->memStride-1)) != 0)
 		RTN_ERROR("Length of input must be a multiple of stride");
-	#undef RTN_ERROR
 	
-	MD5_CTX** md5 = NULL;
-	MD5_CTX dummyMd5;
 	if(calcMd5) {
 		Local<Object> oMd5 = ARG_TO_OBJ(args[2]);
-		md5 = new MD5_CTX*[allocArrSize];
-		
-		unsigned int i = 0;
-		for(; i < numInputs; i++) {
+		for(unsigned int i = 0; i < numInputs; i++) {
 			Local<Value> md5Ctx = GET_ARR(oMd5, i);
-			if (!node::Buffer::HasInstance(md5Ctx) || node::Buffer::Length(md5Ctx) != sizeof(MD5_CTX)) {
-				delete[] inputs;
-				delete[] md5;
-				RETURN_ERROR("Invalid MD5 contexts provided");
-			}
+			if (!node::Buffer::HasInstance(md5Ctx) || node::Buffer::Length(md5Ctx) != sizeof(MD5_CTX))
+				RTN_ERROR("Invalid MD5 contexts provided");
 			md5[i] = (MD5_CTX*)node::Buffer::Data(md5Ctx);
-			if(md5[i]->dataLen > MD5_BLOCKSIZE) {
-				delete[] inputs;
-				delete[] md5;
-				RETURN_ERROR("Invalid MD5 contexts provided");
-			}
-		}
-		// for padding, fill with dummy pointers
-		for(; i < allocArrSize; i++) {
-			md5[i] = &dummyMd5;
-			inputs[i] = inputs[0];
+			if(md5[i]->dataLen > MD5_BLOCKSIZE)
+				RTN_ERROR("Invalid MD5 contexts provided");
 		}
-		dummyMd5.dataLen = md5[0]->dataLen;
 	}
+	#undef RTN_ERROR
 	
-	// TODO: make this stuff async
-	ppgf_finish_input(numInputs, inputs, bufLen);
-	if(calcMd5) {
-		int i=0;
-		#pragma omp parallel for num_threads(ppgf_get_num_threads())
-		for(i=0; i<(int)numInputs; i+=MD5_SIMD_NUM) {
-			md5_multi_update(md5 + i, (const void**)(inputs + i), len);
-		}
-		delete[] md5;
+	ppgf_maybe_setup_gf(gfc->ctx);
+	
+	FinishJob* job;
+	FinishRequest* req = NULL;
+	FinishJob syncJob;
+	if (args.Length() >= 4 && args[3]->IsFunction()) {
+		req = new FinishRequest();
+		job = &req->job;
+	} else
+		job = &syncJob;
+	
+	job->ctx = gfc->ctx;
+	job->inputs = inputs;
+	job->numInputs = numInputs;
+	job->bufLen = bufLen;
+	job->md5 = md5;
+	job->md5Len = len;
+	// spread buffers across threads, but give each task up to one per MD5 lane
+	unsigned int numThreads = (unsigned int)ppgf_get_num_threads(gfc->ctx);
+	job->group = numThreads ? (numInputs + numThreads-1) / numThreads : numInputs;
+	if(job->group > (unsigned int)md5_simd_num) job->group = md5_simd_num;
+	if(job->group < 1) job->group = 1;
+	#define FINISH_CHUNK 16384
+	job->chunkSize = (FINISH_CHUNK + gfc->memStride-1) / gfc->memStride * gfc->memStride;
+	#undef FINISH_CHUNK
+	
+	if (req) {
+		req->work_req_.data = req;
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		req->isolate = isolate;
+#endif
+		req->gfc = gfc;
+		
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		Local<Object> obj = Object::New(isolate);
+		SET_OBJ(obj, "ondone", args[3]);
+		req->obj_.Reset(ISOLATE obj);
+		req->inputBuffers.Reset(ISOLATE Local<Array>::Cast(args[0]));
+		if(calcMd5)
+			req->md5Buffers.Reset(ISOLATE Local<Array>::Cast(args[2]));
+		req->contextObj.Reset(ISOLATE args.Holder());
+#else
+		req->obj_ = Persistent<Object>::New(ISOLATE Object::New());
+		req->obj_->Set(NEW_STRING("ondone"), args[3]);
+		req->inputBuffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[0]));
+		if(calcMd5)
+			req->md5Buffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[2]));
+		req->contextObj = Persistent<Object>::New(ISOLATE args.Holder());
+#endif
+		
+		gfc->activeTasks++;
+		uv_queue_work(
+#if NODE_VERSION_AT_LEAST(10, 0, 0)
+			node::GetCurrentEventLoop(isolate),
+#else
+			uv_default_loop(),
+#endif
+			&req->work_req_,
+			FinishWork,
+			FinishAfter
+		);
+	} else {
+		finish_run(job);
 	}
-	
-	delete[] inputs;
 	RETURN_UNDEF
 }
 
@@ -539,6 +811,13 @@ FUNC(MD5Finish) {
 #endif
 }
 
+static void md5_update_pair(MD5_CTX* md5a, MD5_CTX* md5b, const void* data, size_t len) {
+	MD5_CTX* md5[2] = {md5a, md5b};
+	const void* inputs[2] = {data, data};
+	size_t lens[2] = {len, len};
+	md5_update_batch(md5, inputs, lens, 2);
+}
+
 // update two MD5 contexts with one input
 FUNC(MD5Update2) {
 	FUNC_START;
@@ -554,35 +833,501 @@ FUNC(MD5Update2) {
 	|| ((MD5_CTX*)node::Buffer::Data(args[1]))->dataLen > MD5_BLOCKSIZE)
 		RETURN_ERROR("Invalid MD5 context data");
 	
+	md5_update_pair((MD5_CTX*)node::Buffer::Data(args[0]), (MD5_CTX*)node::Buffer::Data(args[1]), node::Buffer::Data(args[2]), node::Buffer::Length(args[2]));
+	
+	RETURN_UNDEF
+}
+
+// update several MD5 contexts, each with its own input, in as few SIMD passes as possible: (ctxs, inputs)
+FUNC(MD5UpdateMulti) {
+	FUNC_START;
+	
+	if (args.Length() < 2)
+		RETURN_ERROR("2 arguments required");
+	if (!args[0]->IsArray() || !args[1]->IsArray())
+		RETURN_ERROR("Arguments must be arrays");
+	
+	unsigned int num = Local<Array>::Cast(args[0])->Length();
+	if (Local<Array>::Cast(args[1])->Length() != num)
+		RETURN_ERROR("Number of MD5 contexts doesn't equal number of inputs");
+	if(num < 1) RETURN_UNDEF
+	
+	Local<Object> oMd5 = ARG_TO_OBJ(args[0]);
+	Local<Object> oInputs = ARG_TO_OBJ(args[1]);
+	MD5_CTX** md5 = new MD5_CTX*[num];
+	const void** inputs = new const void*[num];
+	size_t* lens = new size_t[num];
+	
+	#define RTN_ERROR(m) { \
+		delete[] md5; \
+		delete[] inputs; \
+		delete[] lens; \
+		RETURN_ERROR(m); \
+	}
+	for(unsigned int i = 0; i < num; i++) {
+		Local<Value> md5Ctx = GET_ARR(oMd5, i);
+		Local<Value> input = GET_ARR(oInputs, i);
+		if (!node::Buffer::HasInstance(md5Ctx) || node::Buffer::Length(md5Ctx) != sizeof(MD5_CTX))
+			RTN_ERROR("Invalid MD5 contexts provided");
+		if (!node::Buffer::HasInstance(input))
+			RTN_ERROR("All inputs must be Buffers");
+		md5[i] = (MD5_CTX*)node::Buffer::Data(md5Ctx);
+		if(md5[i]->dataLen > MD5_BLOCKSIZE)
+			RTN_ERROR("Invalid MD5 contexts provided");
+		for(unsigned int j = 0; j < i; j++)
+			if(md5[j] == md5[i])
+				RTN_ERROR("MD5 contexts must be distinct");
+		inputs[i] = node::Buffer::Data(input);
+		lens[i] = node::Buffer::Length(input);
+	}
+	#undef RTN_ERROR
+	
+	md5_update_batch(md5, inputs, lens, num);
+	
+	delete[] md5;
+	delete[] inputs;
+	delete[] lens;
+	RETURN_UNDEF
+}
+
+// running hash state for an input slice's IFSC entry (slice MD5 + CRC32)
+typedef struct {
+	MD5_CTX md5;
+	uint32_t crc;
+	uint64_t length;
+} SliceHashCtx;
+
+static void slice_hash_init(SliceHashCtx* ctx) {
+	md5_init(&ctx->md5);
+	ctx->crc = 0;
+	ctx->length = 0;
+}
+// updates the slice hashes and, if given, the file MD5, in one pass over the data
+#define SLICE_HASH_CHUNK 16384 // hash in small chunks so the CRC reads data the MD5 just brought into cache
+static void slice_hash_update(MD5_CTX* fileMd5, SliceHashCtx* ctx, const char* data, size_t len) {
+	for(size_t pos = 0; pos < len; pos += SLICE_HASH_CHUNK) {
+		size_t chunkLen = len - pos;
+		if(chunkLen > SLICE_HASH_CHUNK) chunkLen = SLICE_HASH_CHUNK;
+		if(fileMd5)
+			md5_update_pair(fileMd5, &ctx->md5, data + pos, chunkLen);
+		else
+			md5_update(&ctx->md5, data + pos, chunkLen);
+		ctx->crc = crc32_calc(data + pos, chunkLen, ctx->crc);
+	}
+	ctx->length += len;
+}
+// zero pads the slice to sliceSize and writes the 20 byte IFSC entry (MD5, then CRC32 in little endian)
+static void slice_hash_final(SliceHashCtx* ctx, size_t sliceSize, unsigned char* out) {
+	if(ctx->length < sliceSize) {
+		md5_update_zeroes(&ctx->md5, sliceSize - ctx->length);
+		ctx->crc = crc32_zeroes(ctx->crc, sliceSize - ctx->length);
+	}
+	md5_final(out, &ctx->md5);
+	out[16] = ctx->crc & 0xff;
+	out[17] = (ctx->crc >> 8) & 0xff;
+	out[18] = (ctx->crc >> 16) & 0xff;
+	out[19] = ctx->crc >> 24;
+}
+
+// consecutive slices of one file held in a buffer (only the last may be short), and where their IFSC entries go
+typedef struct {
+	MD5_CTX* fileMd5;
+	const char* data;
+	size_t len;
+	unsigned char* out;
+} SliceHashInput;
+
+// hashes the slices of several files together, so that independent MD5s fill the SIMD lanes
+// slices are walked in rows of one chunk each, with each file MD5 taking an equal share of its buffer per row; a file MD5 is a serial chain, so only hashing several files at once can speed it up
+static void slice_hash_batch(const SliceHashInput* inputs, unsigned numInputs, size_t sliceSize) {
+	unsigned numSlices = 0;
+	size_t rowLen = 0;
+	for(unsigned f = 0; f < numInputs; f++) {
+		numSlices += (unsigned)((inputs[f].len + sliceSize-1) / sliceSize);
+		size_t firstLen = inputs[f].len < sliceSize ? inputs[f].len : sliceSize;
+		if(firstLen > rowLen) rowLen = firstLen;
+	}
+	if(!numSlices) return;
+	size_t rows = (rowLen + SLICE_HASH_CHUNK-1) / SLICE_HASH_CHUNK;
+	
+	SliceHashCtx* ctx = new SliceHashCtx[numSlices];
+	MD5_CTX** md5 = new MD5_CTX*[numSlices + numInputs];
+	const void** data = new const void*[numSlices + numInputs];
+	size_t* lens = new size_t[numSlices + numInputs];
+	unsigned* chunkSlice = new unsigned[numSlices];
+	size_t* filePos = new size_t[numInputs];
+	
+	for(unsigned i = 0; i < numSlices; i++)
+		slice_hash_init(ctx + i);
+	for(unsigned f = 0; f < numInputs; f++)
+		filePos[f] = 0;
+	
+	for(size_t pos = 0; pos < rowLen; pos += SLICE_HASH_CHUNK) {
+		unsigned num = 0, slice = 0;
+		for(unsigned f = 0; f < numInputs; f++) {
+			const SliceHashInput* in = inputs + f;
+			for(size_t sliceStart = 0; sliceStart < in->len; sliceStart += sliceSize, slice++) {
+				size_t sliceLen = in->len - sliceStart;
+				if(sliceLen > sliceSize) sliceLen = sliceSize;
+				if(pos >= sliceLen) continue;
+				size_t chunkLen = sliceLen - pos;
+				if(chunkLen > SLICE_HASH_CHUNK) chunkLen = SLICE_HASH_CHUNK;
+				md5[num] = &ctx[slice].md5;
+				data[num] = in->data + sliceStart + pos;
+				lens[num] = chunkLen;
+				chunkSlice[num] = slice;
+				num++;
+			}
+		}
+		unsigned numSliceChunks = num;
+		for(unsigned f = 0; f < numInputs; f++) {
+			const SliceHashInput* in = inputs + f;
+			if(!in->fileMd5 || filePos[f] >= in->len) continue;
+			size_t fileChunk = ((in->len + rows-1) / rows + MD5_BLOCKSIZE-1) & ~(size_t)(MD5_BLOCKSIZE-1);
+			size_t chunkLen = in->len - filePos[f];
+			if(chunkLen > fileChunk) chunkLen = fileChunk;
+			md5[num] = in->fileMd5;
+			data[num] = in->data + filePos[f];
+			lens[num] = chunkLen;
+			num++;
+			filePos[f] += chunkLen;
+		}
+		md5_update_batch(md5, data, lens, num);
+		
+		for(unsigned i = 0; i < numSliceChunks; i++) {
+			SliceHashCtx* sliceCtx = ctx + chunkSlice[i];
+			sliceCtx->crc = crc32_calc(data[i], lens[i], sliceCtx->crc);
+			sliceCtx->length += lens[i];
+		}
+	}
+	
+	unsigned slice = 0;
+	for(unsigned f = 0; f < numInputs; f++)
+		for(size_t sliceStart = 0; sliceStart < inputs[f].len; sliceStart += sliceSize, slice++)
+			slice_hash_final(ctx + slice, sliceSize, inputs[f].out + 20*(sliceStart / sliceSize));
+	delete[] ctx;
+	delete[] md5;
+	delete[] data;
+	delete[] lens;
+	delete[] chunkSlice;
+	delete[] filePos;
+}
+#undef SLICE_HASH_CHUNK
+
+#define GET_FILE_MD5(arg) \
+	MD5_CTX* fileMd5 = NULL; \
+	if (!(arg)->IsNull() && !(arg)->IsUndefined()) { \
+		if (!node::Buffer::HasInstance(arg) || node::Buffer::Length(arg) != sizeof(MD5_CTX)) \
+			RETURN_ERROR("Invalid MD5 context"); \
+		fileMd5 = (MD5_CTX*)node::Buffer::Data(arg); \
+		if(fileMd5->dataLen > MD5_BLOCKSIZE) \
+			RETURN_ERROR("Invalid MD5 context data"); \
+	}
+#define GET_SLICE_HASH_OUTPUT(sliceArg, outArg, offsetArg) \
+	if (!node::Buffer::HasInstance(outArg)) \
+		RETURN_ERROR("Output must be a Buffer"); \
+	size_t sliceSize = (size_t)ARG_TO_INT(sliceArg); \
+	size_t outOffset = (size_t)ARG_TO_INT(offsetArg); \
+	if (outOffset + 20 > node::Buffer::Length(outArg)) \
+		RETURN_ERROR("Output offset out of bounds"); \
+	unsigned char* out = (unsigned char*)node::Buffer::Data(outArg) + outOffset
+
+// hashes whole input slices: (fileMd5|null, data, sliceSize, out, outOffset)
+// data can hold several consecutive slices of a file (only the last may be short), whose IFSC entries are written consecutively to out
+FUNC(SliceHash) {
+	FUNC_START;
 	
-	// TODO: test 2 buffer update methods
+	if (args.Length() < 5)
+		RETURN_ERROR("5 arguments required");
+	GET_FILE_MD5(args[0]);
+	if (!node::Buffer::HasInstance(args[1]))
+		RETURN_ERROR("Data must be a Buffer");
+	GET_SLICE_HASH_OUTPUT(args[2], args[3], args[4]);
+	size_t len = node::Buffer::Length(args[1]);
+	
+	if (len <= sliceSize) {
+		SliceHashCtx ctx;
+		slice_hash_init(&ctx);
+		slice_hash_update(fileMd5, &ctx, node::Buffer::Data(args[1]), len);
+		slice_hash_final(&ctx, sliceSize, out);
+	} else {
+		if (!sliceSize)
+			RETURN_ERROR("Invalid slice size");
+		if (outOffset + 20*((len + sliceSize-1) / sliceSize) > node::Buffer::Length(args[3]))
+			RETURN_ERROR("Output offset out of bounds");
+		SliceHashInput input = {fileMd5, node::Buffer::Data(args[1]), len, out};
+		slice_hash_batch(&input, 1, sliceSize);
+	}
 	
-	MD5_CTX *md5[MD5_SIMD_NUM];
-	char* inputs[MD5_SIMD_NUM];
+	RETURN_UNDEF
+}
+
+// async slice hashing, run on the libuv worker pool
+struct SliceHashRequest {
+	~SliceHashRequest() {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		md5Buffers.Reset();
+		dataBuffers.Reset();
+		outBuffers.Reset();
+		obj_.Reset();
+#else
+		md5Buffers.Dispose();
+		dataBuffers.Dispose();
+		outBuffers.Dispose();
+		obj_.Dispose();
+		obj_.Clear();
+#endif
+		delete[] inputs;
+	};
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Isolate* isolate;
+#endif
+	Persistent<Object> obj_;
+	uv_work_t work_req_;
+	
+	SliceHashInput* inputs;
+	unsigned int numInputs;
+	size_t sliceSize;
+	
+	// persist copies of buffers for the duration of the job
+	Persistent<Array> md5Buffers;
+	Persistent<Array> dataBuffers;
+	Persistent<Array> outBuffers;
+};
+
+static void SliceHashWork(uv_work_t* work_req) {
+	SliceHashRequest* req = (SliceHashRequest*)work_req->data;
+	slice_hash_batch(req->inputs, req->numInputs, req->sliceSize);
+}
+static void SliceHashAfter(uv_work_t* work_req, int status) {
+	assert(status == 0);
+	SliceHashRequest* req = (SliceHashRequest*)work_req->data;
+	req_call_ondone(req);
+	delete req;
+}
+
+// as above, but for several files at once, to fill more MD5 lanes: (fileMd5s, datas, sliceSize, outs, outOffsets [, callback])
+// each entry's file MD5 can be null, but otherwise must be distinct
+// if a callback is given, hashing runs in the background; the caller must leave all the buffers untouched until it is called
+FUNC(SliceHashMulti) {
+	FUNC_START;
 	
-#if MD5_SIMD_NUM == 1
-	inputs[0] = node::Buffer::Data(args[2]);
-	size_t len = node::Buffer::Length(args[2]);
-	md5[0] = (MD5_CTX*)node::Buffer::Data(args[0]);
-	md5_multi_update(md5, (const void**)inputs, len);
+	if (args.Length() < 5)
+		RETURN_ERROR("5 arguments required");
+	if (!args[0]->IsArray() || !args[1]->IsArray() || !args[3]->IsArray() || !args[4]->IsArray())
+		RETURN_ERROR("MD5 contexts, data, outputs and offsets must be arrays");
+	unsigned int num = Local<Array>::Cast(args[1])->Length();
+	if (Local<Array>::Cast(args[0])->Length() != num || Local<Array>::Cast(args[3])->Length() != num || Local<Array>::Cast(args[4])->Length() != num)
+		RETURN_ERROR("Array lengths must be equal");
+	size_t sliceSize = (size_t)ARG_TO_INT(args[2]);
+	if (!sliceSize)
+		RETURN_ERROR("Invalid slice size");
+	
+	Local<Object> oMd5 = ARG_TO_OBJ(args[0]);
+	Local<Object> oData = ARG_TO_OBJ(args[1]);
+	Local<Object> oOut = ARG_TO_OBJ(args[3]);
+	Local<Object> oOffset = ARG_TO_OBJ(args[4]);
+	SliceHashInput* inputs = new SliceHashInput[num];
+	
+	#define RTN_ERROR(m) { \
+		delete[] inputs; \
+		RETURN_ERROR(m); \
+	}
+	for(unsigned int i = 0; i < num; i++) {
+		Local<Value> md5Ctx = GET_ARR(oMd5, i);
+		Local<Value> data = GET_ARR(oData, i);
+		Local<Value> out = GET_ARR(oOut, i);
+		inputs[i].fileMd5 = NULL;
+		if (!md5Ctx->IsNull() && !md5Ctx->IsUndefined()) {
+			if (!node::Buffer::HasInstance(md5Ctx) || node::Buffer::Length(md5Ctx) != sizeof(MD5_CTX))
+				RTN_ERROR("Invalid MD5 context");
+			inputs[i].fileMd5 = (MD5_CTX*)node::Buffer::Data(md5Ctx);
+			if(inputs[i].fileMd5->dataLen > MD5_BLOCKSIZE)
+				RTN_ERROR("Invalid MD5 context data");
+			for(unsigned int j = 0; j < i; j++)
+				if(inputs[j].fileMd5 == inputs[i].fileMd5)
+					RTN_ERROR("MD5 contexts must be distinct");
+		}
+		if (!node::Buffer::HasInstance(data))
+			RTN_ERROR("Data must be Buffers");
+		if (!node::Buffer::HasInstance(out))
+			RTN_ERROR("Outputs must be Buffers");
+		inputs[i].data = node::Buffer::Data(data);
+		inputs[i].len = node::Buffer::Length(data);
+		size_t outOffset = (size_t)ARG_TO_INT(GET_ARR(oOffset, i));
+		if (outOffset + 20*((inputs[i].len + sliceSize-1) / sliceSize) > node::Buffer::Length(out))
+			RTN_ERROR("Output offset out of bounds");
+		inputs[i].out = (unsigned char*)node::Buffer::Data(out) + outOffset;
+	}
+	#undef RTN_ERROR
 	
-	md5[0] = (MD5_CTX*)node::Buffer::Data(args[1]);
-	md5_multi_update(md5, (const void**)inputs, len);
+	if (args.Length() >= 6 && args[5]->IsFunction()) {
+		SliceHashRequest* req = new SliceHashRequest();
+		req->work_req_.data = req;
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		req->isolate = isolate;
+#endif
+		req->inputs = inputs;
+		req->numInputs = num;
+		req->sliceSize = sliceSize;
+		
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		Local<Object> obj = Object::New(isolate);
+		SET_OBJ(obj, "ondone", args[5]);
+		req->obj_.Reset(ISOLATE obj);
+		req->md5Buffers.Reset(ISOLATE Local<Array>::Cast(args[0]));
+		req->dataBuffers.Reset(ISOLATE Local<Array>::Cast(args[1]));
+		req->outBuffers.Reset(ISOLATE Local<Array>::Cast(args[3]));
 #else
-	MD5_CTX dummyMd5;
-	for(unsigned int i=0; i<MD5_SIMD_NUM; i++) {
-		md5[i] = &dummyMd5;
-		inputs[i] = node::Buffer::Data(args[2]);
+		req->obj_ = Persistent<Object>::New(ISOLATE Object::New());
+		req->obj_->Set(NEW_STRING("ondone"), args[5]);
+		req->md5Buffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[0]));
+		req->dataBuffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[1]));
+		req->outBuffers = Persistent<Array>::New(ISOLATE Local<Array>::Cast(args[3]));
+#endif
+		
+		uv_queue_work(
+#if NODE_VERSION_AT_LEAST(10, 0, 0)
+			node::GetCurrentEventLoop(isolate),
+#else
+			uv_default_loop(),
+#endif
+			&req->work_req_,
+			SliceHashWork,
+			SliceHashAfter
+		);
+	} else {
+		slice_hash_batch(inputs, num, sliceSize);
+		delete[] inputs;
 	}
-	md5[0] = (MD5_CTX*)node::Buffer::Data(args[0]);
-	md5[1] = (MD5_CTX*)node::Buffer::Data(args[1]);
-	dummyMd5.dataLen = md5[0]->dataLen;
+	RETURN_UNDEF
+}
+
+// for slices fed in pieces: slice_hash_init() -> slice_hash_update(fileMd5|null, ctx, data [, callback]) -> slice_hash_final(ctx, sliceSize, out, outOffset)
+FUNC(SliceHashInit) {
+	FUNC_START;
+	
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Local<Object> buff = BUFFER_NEW(sizeof(SliceHashCtx));
+#else
+	node::Buffer* buff = BUFFER_NEW(sizeof(SliceHashCtx));
+#endif
+	slice_hash_init((SliceHashCtx*)node::Buffer::Data(buff));
+	
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	RETURN_VAL(buff);
+#else
+	RETURN_VAL(buff->handle_);
+#endif
+}
+#define GET_SLICE_HASH_CTX(arg) \
+	if (!node::Buffer::HasInstance(arg) || node::Buffer::Length(arg) != sizeof(SliceHashCtx)) \
+		RETURN_ERROR("Invalid slice hash context"); \
+	SliceHashCtx* ctx = (SliceHashCtx*)node::Buffer::Data(arg); \
+	if(ctx->md5.dataLen > MD5_BLOCKSIZE) \
+		RETURN_ERROR("Invalid slice hash context")
+
+// async slice_hash_update; the buffers are held by obj_ for the duration of the job
+struct SliceHashUpdateRequest {
+	~SliceHashUpdateRequest() {
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		obj_.Reset();
+#else
+		obj_.Dispose();
+		obj_.Clear();
+#endif
+	};
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Isolate* isolate;
+#endif
+	Persistent<Object> obj_;
+	uv_work_t work_req_;
 	
-	md5_multi_update(md5, (const void**)inputs, node::Buffer::Length(args[2]));
+	MD5_CTX* fileMd5;
+	SliceHashCtx* ctx;
+	const char* data;
+	size_t len;
+};
+
+static void SliceHashUpdateWork(uv_work_t* work_req) {
+	SliceHashUpdateRequest* req = (SliceHashUpdateRequest*)work_req->data;
+	slice_hash_update(req->fileMd5, req->ctx, req->data, req->len);
+}
+static void SliceHashUpdateAfter(uv_work_t* work_req, int status) {
+	assert(status == 0);
+	SliceHashUpdateRequest* req = (SliceHashUpdateRequest*)work_req->data;
+	req_call_ondone(req);
+	delete req;
+}
+
+// (fileMd5|null, ctx, data [, callback]); if a callback is given, hashing runs in the background, and the buffers must be left untouched until it is called
+FUNC(SliceHashUpdate) {
+	FUNC_START;
+	
+	if (args.Length() < 3)
+		RETURN_ERROR("3 arguments required");
+	GET_FILE_MD5(args[0]);
+	GET_SLICE_HASH_CTX(args[1]);
+	if (!node::Buffer::HasInstance(args[2]))
+		RETURN_ERROR("Data must be a Buffer");
+	
+	if (args.Length() >= 4 && args[3]->IsFunction()) {
+		SliceHashUpdateRequest* req = new SliceHashUpdateRequest();
+		req->work_req_.data = req;
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		req->isolate = isolate;
 #endif
+		req->fileMd5 = fileMd5;
+		req->ctx = ctx;
+		req->data = node::Buffer::Data(args[2]);
+		req->len = node::Buffer::Length(args[2]);
+		
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+		Local<Object> obj = Object::New(isolate);
+		SET_OBJ(obj, "ondone", args[3]);
+		SET_OBJ(obj, "md5", args[0]);
+		SET_OBJ(obj, "ctx", args[1]);
+		SET_OBJ(obj, "data", args[2]);
+		req->obj_.Reset(ISOLATE obj);
+#else
+		req->obj_ = Persistent<Object>::New(ISOLATE Object::New());
+		req->obj_->Set(NEW_STRING("ondone"), args[3]);
+		req->obj_->Set(NEW_STRING("md5"), args[0]);
+		req->obj_->Set(NEW_STRING("ctx"), args[1]);
+		req->obj_->Set(NEW_STRING("data"), args[2]);
+#endif
+		
+		uv_queue_work(
+#if NODE_VERSION_AT_LEAST(10, 0, 0)
+			node::GetCurrentEventLoop(isolate),
+#else
+			uv_default_loop(),
+#endif
+			&req->work_req_,
+			SliceHashUpdateWork,
+			SliceHashUpdateAfter
+		);
+	} else
+		slice_hash_update(fileMd5, ctx, node::Buffer::Data(args[2]), node::Buffer::Length(args[2]));
+	RETURN_UNDEF
+}
+
+FUNC(SliceHashFinal) {
+	FUNC_START;
 	
+	if (args.Length() < 4)
+		RETURN_ERROR("4 arguments required");
+	GET_SLICE_HASH_CTX(args[0]);
+	GET_SLICE_HASH_OUTPUT(args[1], args[2], args[3]);
+	if (ctx->length > sliceSize)
+		RETURN_ERROR("Data larger than slice size");
+	
+	slice_hash_final(ctx, sliceSize, out);
 	RETURN_UNDEF
 }
+#undef GET_FILE_MD5
+#undef GET_SLICE_HASH_OUTPUT
+#undef GET_SLICE_HASH_CTX
 
 FUNC(MD5UpdateZeroes) {
 	FUNC_START;
@@ -622,13 +1367,16 @@ FUNC(MD5UpdateZeroes) {
 
 FUNC(SetMethod) {
 	FUNC_START;
+	GET_CONTEXT;
 	
-	if (mmActiveTasks)
+	if (gfc->activeTasks)
 		RETURN_ERROR("Calculation already in progress");
 	
 	if(ppgf_set_method(
+		gfc->ctx,
 		args.Length() >= 1 && !args[0]->IsUndefined() ? ARG_TO_INT(args[0]) : 0 /*GF16_AUTO*/,
-		args.Length() >= 2 ? ARG_TO_INT(args[1]) : 0
+		args.Length() >= 2 && !args[1]->IsUndefined() ? (size_t)ARG_TO_INT(args[1]) : 0,
+		args.Length() >= 3 && !args[2]->IsUndefined() ? (unsigned)ARG_TO_INT(args[2]) : 0
 	))
 		RETURN_ERROR("Unknown method specified");
 	
@@ -641,10 +1389,10 @@ FUNC(SetMethod) {
 	
 	int rMethod;
 	const char* rMethLong;
-	ppgf_get_method(&rMethod, &rMethLong, &MEM_ALIGN, &MEM_STRIDE);
+	gfc->update_method_info(&rMethod, &rMethLong);
 	
-	SET_OBJ(ret, "alignment", Integer::New(ISOLATE MEM_ALIGN));
-	SET_OBJ(ret, "stride", Integer::New(ISOLATE MEM_STRIDE));
+	SET_OBJ(ret, "alignment", Integer::New(ISOLATE gfc->memAlign));
+	SET_OBJ(ret, "stride", Integer::New(ISOLATE gfc->memStride));
 	SET_OBJ(ret, "method", Integer::New(ISOLATE rMethod));
 	SET_OBJ(ret, "method_desc", NEW_STRING(rMethLong));
 	
@@ -652,44 +1400,147 @@ FUNC(SetMethod) {
 	RETURN_VAL(ret);
 }
 
+// benchmarks available methods for the given job shape and returns the ID of the fastest; doesn't change the active method
+FUNC(AutotuneMethod) {
+	FUNC_START;
+	GET_CONTEXT;
+	
+	if (gfc->activeTasks)
+		RETURN_ERROR("Calculation already in progress");
+	
+	size_t sizeHint = args.Length() >= 1 && !args[0]->IsUndefined() ? (size_t)ARG_TO_INT(args[0]) : 0;
+	unsigned outputs = args.Length() >= 2 && !args[1]->IsUndefined() ? (unsigned)ARG_TO_INT(args[1]) : 0;
+	int method;
+	if (args.Length() >= 3 && args[2]->IsString()) {
+#if NODE_VERSION_AT_LEAST(8, 0, 0)
+		String::Utf8Value cacheFile(isolate, args[2]);
+#else
+		String::Utf8Value cacheFile(args[2]);
+#endif
+		method = ppgf_autotune_method(gfc->ctx, sizeHint, outputs, *cacheFile);
+	} else
+		method = ppgf_autotune_method(gfc->ctx, sizeHint, outputs, NULL);
+	
+	RETURN_VAL(Integer::New(ISOLATE method));
+}
+
+FUNC(SetSchedule) {
+	FUNC_START;
+	GET_CONTEXT;
+	
+	if (gfc->activeTasks)
+		RETURN_ERROR("Calculation already in progress");
+	
+	ppgf_set_schedule(gfc->ctx, args.Length() >= 1 && !args[0]->IsUndefined() ? ARG_TO_INT(args[0]) : 0 /*PPGF_SCHEDULE_AUTO*/);
+	RETURN_UNDEF
+}
+
+// returns how generate() would split up work of the given shape
+FUNC(GetSchedule) {
+	FUNC_START;
+	GET_CONTEXT;
+	
+	if (args.Length() < 3)
+		RETURN_ERROR("3 arguments required");
+	
+	int schedule;
+	size_t chunkSize;
+	unsigned int inputGroup, outputGroup, inputSplits;
+	ppgf_get_schedule(gfc->ctx, (unsigned)ARG_TO_INT(args[0]), (size_t)ARG_TO_INT(args[1]), (unsigned)ARG_TO_INT(args[2]), &schedule, &chunkSize, &inputGroup, &outputGroup, &inputSplits);
+	
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Local<Object> ret = Object::New(isolate);
+#else
+	Local<Object> ret = Object::New();
+#endif
+	SET_OBJ(ret, "schedule", Integer::New(ISOLATE schedule));
+	SET_OBJ(ret, "chunk_size", Integer::New(ISOLATE (int)chunkSize));
+	SET_OBJ(ret, "input_group", Integer::New(ISOLATE inputGroup));
+	SET_OBJ(ret, "output_group", Integer::New(ISOLATE outputGroup));
+	SET_OBJ(ret, "input_splits", Integer::New(ISOLATE inputSplits));
+	RETURN_VAL(ret);
+}
+
+
+// the hashing globals (CRC tables, kernel selection) are shared by all instances, so must only be set up once per process
+static uv_once_t hashInitOnce = UV_ONCE_INIT;
+static void init_hash_module() {
+	md5_multi_init();
+	crc32_init();
+}
 
 void parpar_gf_init(
 #if NODE_VERSION_AT_LEAST(4, 0, 0)
  Local<Object> target,
  Local<Value> module,
+ Local<Context> context,
  void* priv
 #else
  Handle<Object> target
 #endif
 ) {
-	ppgf_init_constants();
+#if NODE_VERSION_AT_LEAST(0, 11, 0)
+	Isolate* isolate = Isolate::GetCurrent();
+#endif
 	ppgf_init_gf_module();
-	
-	int rMethod;
-	const char* rMethLong;
-	ppgf_get_method(&rMethod, &rMethLong, &MEM_ALIGN, &MEM_STRIDE);
+	uv_once(&hashInitOnce, &init_hash_module);
 	
 	NODE_SET_METHOD(target, "md5_init", MD5Start);
 	NODE_SET_METHOD(target, "md5_final", MD5Finish);
 	NODE_SET_METHOD(target, "md5_update2", MD5Update2);
+	NODE_SET_METHOD(target, "md5_update_multi", MD5UpdateMulti);
 	NODE_SET_METHOD(target, "md5_update_zeroes", MD5UpdateZeroes);
+	NODE_SET_METHOD(target, "slice_hash", SliceHash);
+	NODE_SET_METHOD(target, "slice_hash_multi", SliceHashMulti);
+	NODE_SET_METHOD(target, "slice_hash_init", SliceHashInit);
+	NODE_SET_METHOD(target, "slice_hash_update", SliceHashUpdate);
+	NODE_SET_METHOD(target, "slice_hash_final", SliceHashFinal);
+	
+	// each loaded instance of the module (e.g. one per worker thread) gets its own default context
+	GfContext* defaultContext = new GfContext();
+#if NODE_VERSION_AT_LEAST(12, 0, 0)
+	defaultContext->add_cleanup_hook(isolate);
+#endif
+	Local<Value> defaultContextRef = NEW_EXTERNAL(defaultContext);
+	#define SET_CONTEXT_METHOD(name, f) \
+		SET_OBJ(target, name, TEMPLATE_TO_FUNC(NEW_FUNC_TEMPLATE(f, defaultContextRef))); \
+		NODE_SET_PROTOTYPE_METHOD(ctxTemplate, name, f)
+	
+	// new GfContext() - has all of the following methods, which operate on it instead of the default context
+	Local<FunctionTemplate> ctxTemplate = NEW_FUNC_TEMPLATE(NewContext, Local<Value>());
+	ctxTemplate->SetClassName(NEW_STRING("GfContext"));
+	ctxTemplate->InstanceTemplate()->SetInternalFieldCount(1);
 	
 	// generate(Buffer input, int inputBlockNum, Array<Buffer> outputs, Array<int> recoveryBlockNums [, bool add [, Function callback]])
 	// ** DON'T modify buffers whilst function is running! **
-	NODE_SET_METHOD(target, "generate", MultiplyMulti);
-	// int alignment_offset(Buffer buffer)
-	NODE_SET_METHOD(target, "alignment_offset", AlignmentOffset);
+	SET_CONTEXT_METHOD("generate", MultiplyMulti);
+	// int alignment_offset(Buffer buffer [, int alignment])
+	SET_CONTEXT_METHOD("alignment_offset", AlignmentOffset);
 	
-	NODE_SET_METHOD(target, "copy", PrepInput);
-	NODE_SET_METHOD(target, "finish", Finish);
+	SET_CONTEXT_METHOD("copy", PrepInput);
+	// finish(Array<Buffer> outputs, int len [, Array<Buffer> md5Contexts [, Function callback]])
+	// as with generate, don't touch the buffers until the callback is called
+	SET_CONTEXT_METHOD("finish", Finish);
 	
-#ifdef _OPENMP
 	// set_max_threads(int num_threads)
-	NODE_SET_METHOD(target, "set_max_threads", SetMaxThreads);
-#endif
-	NODE_SET_METHOD(target, "get_num_threads", GetNumThreads);
-	
-	NODE_SET_METHOD(target, "set_method", SetMethod);
+	SET_CONTEXT_METHOD("set_max_threads", SetMaxThreads);
+	SET_CONTEXT_METHOD("get_num_threads", GetNumThreads);
+	
+	// object set_method([int method [, int size_hint [, int num_outputs]]])
+	SET_CONTEXT_METHOD("set_method", SetMethod);
+	// int autotune_method([int size_hint [, int num_outputs [, string cache_file]]])
+	SET_CONTEXT_METHOD("autotune_method", AutotuneMethod);
+	// set_schedule([int schedule]) - 0=auto, 1=flat, 2=blocked, 3=split inputs, 4=power chains of consecutive outputs
+	SET_CONTEXT_METHOD("set_schedule", SetSchedule);
+	// object get_schedule(int num_inputs, int len, int num_outputs)
+	SET_CONTEXT_METHOD("get_schedule", GetSchedule);
+	#undef SET_CONTEXT_METHOD
+	
+	SET_OBJ(target, "GfContext", TEMPLATE_TO_FUNC(ctxTemplate));
 }
 
+#if NODE_VERSION_AT_LEAST(4, 0, 0)
+NODE_MODULE_CONTEXT_AWARE(parpar_gf, parpar_gf_init);
+#else
 NODE_MODULE(parpar_gf, parpar_gf_init);
+#endif
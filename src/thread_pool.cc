@@ -0,0 +1,163 @@
+#include "thread_pool.h"
+#include "stdint.h"
+
+ThreadPool::ThreadPool(unsigned threads) : numThreads(threads ? threads : 1), generation(0), activeWorkers(0), exiting(false), jobFunc(NULL), jobArg(NULL) {
+	uv_mutex_init(&jobLock);
+	uv_mutex_init(&stateLock);
+	uv_cond_init(&wakeCond);
+	uv_cond_init(&doneCond);
+}
+
+ThreadPool::~ThreadPool() {
+	uv_mutex_lock(&jobLock);
+	stop_threads();
+	uv_mutex_unlock(&jobLock);
+	uv_cond_destroy(&doneCond);
+	uv_cond_destroy(&wakeCond);
+	uv_mutex_destroy(&stateLock);
+	uv_mutex_destroy(&jobLock);
+}
+
+void ThreadPool::setThreads(unsigned threads) {
+	uv_mutex_lock(&jobLock);
+	numThreads = threads ? threads : 1;
+	uv_mutex_unlock(&jobLock);
+}
+
+// must be called with jobLock held
+void ThreadPool::start_threads() {
+	workers.reserve(numThreads);
+	for(unsigned i=0; i<numThreads; i++) {
+		Worker* w = new Worker;
+		w->pool = this;
+		w->id = i;
+		w->next = w->end = 0;
+		w->seenGeneration = generation;
+		uv_mutex_init(&w->lock);
+		workers.push_back(w);
+	}
+	for(unsigned i=1; i<numThreads; i++)
+		uv_thread_create(&workers[i]->thread, &ThreadPool::thread_main, workers[i]);
+}
+void ThreadPool::stop_threads() {
+	uv_mutex_lock(&stateLock);
+	exiting = true;
+	uv_cond_broadcast(&wakeCond);
+	uv_mutex_unlock(&stateLock);
+	for(unsigned i=1; i<workers.size(); i++)
+		uv_thread_join(&workers[i]->thread);
+	for(unsigned i=0; i<workers.size(); i++) {
+		uv_mutex_destroy(&workers[i]->lock);
+		delete workers[i];
+	}
+	workers.clear();
+	exiting = false;
+}
+
+void ThreadPool::thread_main(void* worker) {
+	Worker* w = (Worker*)worker;
+	ThreadPool* pool = w->pool;
+	
+	uv_mutex_lock(&pool->stateLock);
+	while(1) {
+		while(!pool->exiting && pool->generation == w->seenGeneration)
+			uv_cond_wait(&pool->wakeCond, &pool->stateLock);
+		if(pool->exiting) break;
+		w->seenGeneration = pool->generation;
+		uv_mutex_unlock(&pool->stateLock);
+		
+		pool->process(w);
+		
+		uv_mutex_lock(&pool->stateLock);
+		if(--pool->activeWorkers == 0)
+			uv_cond_signal(&pool->doneCond);
+	}
+	uv_mutex_unlock(&pool->stateLock);
+}
+
+// takes half of the largest remaining range from another thread; returns false if there's nothing left to steal
+bool ThreadPool::steal(Worker* w, unsigned* task) {
+	while(1) {
+		Worker* victim = NULL;
+		unsigned most = 0;
+		for(unsigned i=1; i<workers.size(); i++) {
+			Worker* v = workers[(w->id + i) % workers.size()];
+			uv_mutex_lock(&v->lock);
+			unsigned remaining = v->end - v->next;
+			uv_mutex_unlock(&v->lock);
+			if(remaining > most) {
+				most = remaining;
+				victim = v;
+			}
+		}
+		if(!victim) return false;
+		
+		uv_mutex_lock(&victim->lock);
+		unsigned remaining = victim->end - victim->next;
+		unsigned take = (remaining+1) / 2;
+		victim->end -= take;
+		unsigned first = victim->end;
+		uv_mutex_unlock(&victim->lock);
+		if(!take) continue; // victim finished its tasks in the meantime, look again
+		
+		uv_mutex_lock(&w->lock);
+		w->next = first+1;
+		w->end = first+take;
+		uv_mutex_unlock(&w->lock);
+		*task = first;
+		return true;
+	}
+}
+
+void ThreadPool::process(Worker* w) {
+	while(1) {
+		unsigned task;
+		uv_mutex_lock(&w->lock);
+		bool haveTask = w->next < w->end;
+		if(haveTask) task = w->next++;
+		uv_mutex_unlock(&w->lock);
+		
+		if(!haveTask && !steal(w, &task))
+			break;
+		jobFunc(jobArg, task, w->id);
+	}
+}
+
+void ThreadPool::run(unsigned numTasks, ThreadPoolTaskFunc func, void* arg) {
+	if(numTasks == 0) return;
+	if(numThreads < 2 || numTasks < 2 || uv_mutex_trylock(&jobLock)) {
+		for(unsigned i=0; i<numTasks; i++)
+			func(arg, i, 0);
+		return;
+	}
+	if(workers.size() != numThreads) {
+		stop_threads();
+		start_threads();
+	}
+	
+	// give each thread an even share of tasks up front, leaving stealing to even out differences in speed
+	for(unsigned i=0; i<numThreads; i++) {
+		Worker* w = workers[i];
+		uv_mutex_lock(&w->lock);
+		w->next = (unsigned)((uint64_t)numTasks * i / numThreads);
+		w->end = (unsigned)((uint64_t)numTasks * (i+1) / numThreads);
+		uv_mutex_unlock(&w->lock);
+	}
+	
+	uv_mutex_lock(&stateLock);
+	jobFunc = func;
+	jobArg = arg;
+	activeWorkers = numThreads-1;
+	generation++;
+	uv_cond_broadcast(&wakeCond);
+	uv_mutex_unlock(&stateLock);
+	
+	process(workers[0]);
+	
+	uv_mutex_lock(&stateLock);
+	while(activeWorkers)
+		uv_cond_wait(&doneCond, &stateLock);
+	uv_mutex_unlock(&stateLock);
+	
+	uv_mutex_unlock(&jobLock);
+}
@@ -0,0 +1,59 @@
+#ifndef __PP_THREAD_POOL__
+#define __PP_THREAD_POOL__
+
+#include <uv.h>
+#include <vector>
+
+// task callback: receives the job argument, the task index and the index of the thread running it (0 <= threadNum < number of threads)
+typedef void(*ThreadPoolTaskFunc)(void* arg, unsigned task, unsigned threadNum);
+
+// persistent set of worker threads for running data-parallel jobs
+// each job's task indices are split into contiguous ranges, one per thread; a thread which runs out of tasks steals half of the largest remaining range from another, so faster cores (or ones not contending with a hyper-thread) pick up the slack
+class ThreadPool {
+private:
+	struct Worker {
+		ThreadPool* pool;
+		unsigned id;
+		uv_thread_t thread;
+		uv_mutex_t lock; // protects next/end
+		unsigned next, end; // remaining tasks owned by this thread
+		unsigned seenGeneration; // last job this thread picked up
+	};
+	std::vector<Worker*> workers; // workers[0] represents the thread calling run(), and has no thread of its own
+	unsigned numThreads;
+
+	uv_mutex_t jobLock; // only one job can run at a time
+	uv_mutex_t stateLock;
+	uv_cond_t wakeCond, doneCond;
+	unsigned generation; // incremented for each job
+	unsigned activeWorkers; // threads yet to complete the current job
+	bool exiting;
+	ThreadPoolTaskFunc jobFunc;
+	void* jobArg;
+
+	static void thread_main(void* worker);
+	void process(Worker* w);
+	bool steal(Worker* w, unsigned* task);
+	void start_threads();
+	void stop_threads();
+
+	// disable copy constructor
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+public:
+	explicit ThreadPool(unsigned threads = 1);
+	~ThreadPool();
+
+	// threads are (re)started lazily, on the next job
+	void setThreads(unsigned threads);
+	inline unsigned threads() const {
+		return numThreads;
+	}
+
+	// calls func(arg, task, threadNum) for every task in [0, numTasks), returning once all have completed
+	// the calling thread participates as thread 0; if the pool is busy with another job, all tasks are run on the calling thread instead of blocking it
+	void run(unsigned numTasks, ThreadPoolTaskFunc func, void* arg);
+};
+
+#endif
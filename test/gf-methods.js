@@ -0,0 +1,126 @@
+"use strict";
+/*
+ * Checks that every GF method available on this CPU gives the same recovery data as LH Lookup
+ * Each method is run under every multiply schedule, with and without accumulating into existing outputs, and with one and multiple threads
+ */
+
+var gf = require('../build/Release/parpar_gf.node');
+var crypto = require('crypto');
+var assert = require('assert');
+
+// NOTE: this list must match that defined in the native module (see also lib/par2.js)
+var methods = [
+	'' /*default*/, 'lh_lookup', 'lh_lookup-sse', '3p_lookup',
+	'shuffle-neon', 'shuffle-sse', 'shuffle-avx', 'shuffle-avx2', 'shuffle-avx512', 'shuffle-vbmi',
+	'shuffle2x-avx2', 'shuffle2x-avx512',
+	'xor-sse', 'xorjit-sse', 'xorjit-avx2', 'xorjit-avx512',
+	'affine-sse', 'affine-avx512',
+	'affine2x-sse', 'affine2x-avx512',
+	'affine-avx2', 'affine2x-avx2',
+	'affine2x-nt-avx2', 'affine2x-nt-avx512',
+	'clmul-sse', 'clmul-avx512',
+	'lh_lookup-avx2', 'lh_lookup-avx512'
+];
+// the pow schedule falls back to auto for methods without a pow_add kernel
+var schedules = {auto: 0, flat: 1, blocked: 2, split: 3, pow: 4};
+var threadCounts = [1, 3];
+// lengths which aren't a multiple of any method's stride, from a single word up to several chunks
+var lengths = [2, 6, 1002, 65538, 300006];
+var shapes = [
+	// output 0 has all coefficients = 1; consecutive outputs exercise multi-output paths
+	{inputs: 11, outputs: [0, 1, 2, 3, 4, 5, 300, 65534]},
+	// a single all-ones row (e.g. -r1), which is also split across threads
+	{inputs: 20, outputs: [0]}
+];
+
+var ctx = new gf.GfContext();
+
+var alignedBuffer = function(info, len) {
+	var buf = new Buffer(len + info.alignment);
+	var offset = ctx.alignment_offset(buf);
+	if(offset) offset = info.alignment - offset;
+	return buf.slice(offset, offset + len);
+};
+var bufEqual = function(a, b) {
+	if(Buffer.compare) return Buffer.compare(a, b) === 0;
+	return a.toString('hex') === b.toString('hex');
+};
+
+// returns the finished outputs, or null if the method isn't available
+var generate = function(method, schedule, threads, data, iNums, oNums, len, add) {
+	ctx.set_max_threads(threads);
+	ctx.set_schedule(schedule);
+	var info = ctx.set_method(method, len, oNums.length);
+	if(info.method != method) return null;
+	
+	var alignedLen = Math.ceil(len / info.stride) * info.stride;
+	var inputs = data.map(function(buf) {
+		var input = alignedBuffer(info, alignedLen);
+		ctx.copy(buf, input);
+		return input;
+	});
+	var outputs = oNums.map(function() {
+		var output = alignedBuffer(info, alignedLen);
+		output.fill(0xaa); // should be overwritten when not adding
+		return output;
+	});
+	ctx.generate(inputs, iNums, outputs, oNums, false);
+	if(add) // add the first two inputs a second time, which cancels them out
+		ctx.generate(inputs.slice(0, 2), iNums.slice(0, 2), outputs, oNums, true);
+	ctx.finish(outputs, len);
+	return outputs.map(function(buf) {
+		return buf.slice(0, len);
+	});
+};
+
+var tested = {};
+shapes.forEach(function(shape) {
+	var iNums = [];
+	for(var i = 0; i < shape.inputs; i++)
+		iNums.push((i * 2741 + 5) % 32768);
+	lengths.forEach(function(len) {
+		var data = [];
+		for(var i = 0; i < shape.inputs; i++)
+			data.push(crypto.pseudoRandomBytes(len));
+		[false, true].forEach(function(add) {
+			var ref = generate(1, schedules.flat, 1, data, iNums, shape.outputs, len, add);
+			for(var method = 1; method < methods.length; method++) {
+				for(var sched in schedules) {
+					threadCounts.forEach(function(threads) {
+						var result = generate(method, schedules[sched], threads, data, iNums, shape.outputs, len, add);
+						if(!result) return;
+						tested[methods[method]] = 1;
+						result.forEach(function(buf, i) {
+							assert(bufEqual(buf, ref[i]), [methods[method], sched + ' schedule', threads + ' threads', shape.inputs + ' inputs', 'output ' + shape.outputs[i], 'length ' + len, add ? 'add' : 'overwrite'].join(', '));
+						});
+					});
+				}
+			}
+		});
+	});
+});
+
+// non-transforming methods keep data in the regular layout, so copying in and finishing shouldn't change it
+methods.forEach(function(name, method) {
+	if(name.indexOf('-nt-') < 0) return;
+	ctx.set_schedule(schedules.auto);
+	var len = 65538;
+	var info = ctx.set_method(method, len);
+	if(info.method != method) return;
+	
+	var alignedLen = Math.ceil(len / info.stride) * info.stride;
+	var data = crypto.pseudoRandomBytes(len);
+	var input = alignedBuffer(info, alignedLen);
+	ctx.copy(data, input);
+	assert(bufEqual(input.slice(0, len), data), name + ' copy');
+	
+	var output = alignedBuffer(info, alignedLen);
+	ctx.generate([input], [0], [output], [7], false);
+	var unfinished = new Buffer(alignedLen);
+	output.copy(unfinished);
+	ctx.finish([output], len);
+	assert(bufEqual(output, unfinished), name + ' finish');
+});
+
+console.log('Methods tested: ' + Object.keys(tested).join(', '));
+console.log('All tests passed');
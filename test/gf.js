@@ -0,0 +1,288 @@
+"use strict";
+
+var gf = require('../build/Release/parpar_gf.node');
+var crypto = require('crypto');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var os = require('os');
+
+var METHOD_LOOKUP = 1, METHOD_LOOKUP3 = 3, METHOD_XORJIT_AVX2 = 14;
+var SCHEDULE_AUTO = 0, SCHEDULE_FLAT = 1, SCHEDULE_BLOCKED = 2, SCHEDULE_SPLIT = 3;
+
+var alignedBuffer = function(ctx, info, len) {
+	var buf = new Buffer(len + info.alignment);
+	var offset = ctx.alignment_offset(buf);
+	if(offset) offset = info.alignment - offset;
+	return buf.slice(offset, offset + len);
+};
+var randomInputs = function(count, len) {
+	var data = [];
+	for(var i = 0; i < count; i++)
+		data.push(crypto.pseudoRandomBytes(len));
+	return data;
+};
+var range = function(start, count) {
+	var nums = [];
+	for(var i = 0; i < count; i++)
+		nums.push(start + i);
+	return nums;
+};
+
+// copies data into buffers laid out for the context's method; generate() then computes oNums from these, after which finish() returns the recovery data
+var job = function(ctx, info, data, iNums, oNums) {
+	var len = data[0].length;
+	var alignedLen = Math.ceil(len / info.stride) * info.stride;
+	var inputs = data.map(function(buf) {
+		var input = alignedBuffer(ctx, info, alignedLen);
+		ctx.copy(buf, input);
+		return input;
+	});
+	var outputs = oNums.map(function() {
+		return alignedBuffer(ctx, info, alignedLen);
+	});
+	return {
+		generate: function(cb) {
+			if(cb)
+				ctx.generate(inputs, iNums, outputs, oNums, false, cb);
+			else
+				ctx.generate(inputs, iNums, outputs, oNums, false);
+		},
+		finish: function() {
+			ctx.finish(outputs, len);
+			return outputs.map(function(buf) {
+				return buf.slice(0, len).toString('hex');
+			});
+		}
+	};
+};
+var generateSync = function(ctx, info, data, iNums, oNums) {
+	var j = job(ctx, info, data, iNums, oNums);
+	j.generate();
+	return j.finish();
+};
+var newContext = function(threads) {
+	var ctx = new gf.GfContext();
+	ctx.set_max_threads(threads);
+	return ctx;
+};
+
+
+// autotune: the result is persisted to the cache file, and later calls for the same job shape use it instead of benchmarking
+var cacheFile = path.join(os.tmpdir(), 'parpar-test-autotune-' + process.pid);
+var ctx = newContext(1);
+var best = ctx.autotune_method(65536, 4, cacheFile);
+var info = ctx.set_method(best);
+assert.equal(info.method, best, 'autotune picks an available method');
+var cacheEntries = function() {
+	return fs.readFileSync(cacheFile, 'utf8').split('\n').filter(function(line) {
+		return line;
+	});
+};
+assert.equal(cacheEntries().length, 1, 'autotune writes one cache entry');
+var entry = cacheEntries()[0].split('\t');
+assert.equal(entry[entry.length-1], info.method_desc, 'autotune cache entry holds the method');
+
+// replace the cached result with a different method; as this is what's returned, no benchmarking can have taken place
+var other = best == METHOD_LOOKUP ? METHOD_LOOKUP3 : METHOD_LOOKUP;
+entry[entry.length-1] = ctx.set_method(other).method_desc;
+fs.appendFileSync(cacheFile, entry.join('\t') + '\n');
+assert.equal(ctx.autotune_method(65536, 4, cacheFile), other, 'autotune uses the cache entry');
+assert.equal(ctx.autotune_method(50000, 3, cacheFile), other, 'autotune uses the cache entry for a similar job shape');
+assert.equal(cacheEntries().length, 2, 'autotune cache hit doesn\'t add entries');
+fs.unlinkSync(cacheFile);
+
+
+// schedule selection; get_schedule reports how generate splits up work of the given shape (inputs, length, outputs)
+var checkSchedule = function(ctx, info, numInputs, len, numOutputs, msg) {
+	var sched = ctx.get_schedule(numInputs, len, numOutputs);
+	assert.equal(sched.chunk_size % info.stride, 0, msg + ' (chunk alignment)');
+	assert(sched.chunk_size > 0, msg + ' (chunk size)');
+	assert(sched.input_group >= 1 && sched.input_group <= numInputs, msg + ' (input group)');
+	assert(sched.output_group >= 1 && sched.output_group <= numOutputs, msg + ' (output group)');
+	assert(sched.input_splits >= 1 && sched.input_splits <= numInputs, msg + ' (input splits)');
+	if(sched.schedule == SCHEDULE_FLAT) {
+		assert.equal(sched.input_group, numInputs, msg + ' (flat input group)');
+		assert.equal(sched.output_group, 1, msg + ' (flat output group)');
+	}
+	return sched;
+};
+
+var ctx = newContext(1);
+var info = ctx.set_method(METHOD_LOOKUP);
+ctx.set_schedule(SCHEDULE_FLAT);
+assert.equal(checkSchedule(ctx, info, 5000, 1048576, 64, 'forced flat').schedule, SCHEDULE_FLAT, 'forced flat');
+ctx.set_schedule(SCHEDULE_BLOCKED);
+assert.equal(checkSchedule(ctx, info, 2, 4096, 4, 'forced blocked').schedule, SCHEDULE_BLOCKED, 'forced blocked');
+ctx.set_schedule(SCHEDULE_AUTO);
+// all inputs fit in cache, so blocking gains nothing
+assert.equal(checkSchedule(ctx, info, 2, 4096, 4, 'small job').schedule, SCHEDULE_FLAT, 'small job');
+// too many inputs to fit in cache at the minimum chunk size
+var sched = checkSchedule(ctx, info, 5000, 1048576, 64, 'large job');
+assert.equal(sched.schedule, SCHEDULE_BLOCKED, 'large job');
+assert(sched.input_group < 5000, 'large job (input group)');
+
+// methods which cache generated code use blocked tiles whose coefficients all fit in the code cache
+var ctx = newContext(1);
+var info = ctx.set_method(METHOD_XORJIT_AVX2);
+if(info.method == METHOD_XORJIT_AVX2) {
+	var sched = checkSchedule(ctx, info, 200, 1048576, 16, 'code cache method');
+	assert.equal(sched.schedule, SCHEDULE_BLOCKED, 'code cache method');
+	assert(sched.input_group * sched.output_group <= 128, 'code cache method (tile size)');
+}
+
+// the data generated mustn't depend on the schedule
+var data = randomInputs(40, 200000);
+var ref = null;
+[SCHEDULE_FLAT, SCHEDULE_BLOCKED, SCHEDULE_AUTO].forEach(function(schedule) {
+	var ctx = newContext(2);
+	var info = ctx.set_method(METHOD_LOOKUP);
+	ctx.set_schedule(schedule);
+	var result = generateSync(ctx, info, data, range(0, 40), range(0, 12));
+	if(ref)
+		assert.deepEqual(result, ref, 'schedule ' + schedule + ' result');
+	ref = result;
+});
+
+
+// with too few tasks to occupy all threads (here, a single chunk of a single output), inputs are also partitioned across threads, with each partition having at least 4 inputs
+var ctx = newContext(8);
+var info = ctx.set_method(METHOD_LOOKUP);
+var sched = checkSchedule(ctx, info, 64, 4096, 1, 'few tasks');
+assert.equal(sched.schedule, SCHEDULE_SPLIT, 'few tasks');
+assert.equal(sched.input_splits, 8, 'few tasks (input splits)');
+assert.equal(checkSchedule(ctx, info, 6, 4096, 1, 'few inputs').input_splits, 1, 'few inputs');
+assert.equal(checkSchedule(ctx, info, 64, 4096, 16, 'enough tasks').input_splits, 1, 'enough tasks');
+var ctx = newContext(1);
+var info = ctx.set_method(METHOD_LOOKUP);
+ctx.set_schedule(SCHEDULE_SPLIT);
+var sched = checkSchedule(ctx, info, 64, 4096, 16, 'forced split');
+assert.equal(sched.schedule, SCHEDULE_SPLIT, 'forced split');
+assert.equal(sched.input_splits, 2, 'forced split (input splits)');
+
+// merging the partitions must give the same data as a single thread
+var data = randomInputs(64, 100000);
+var ctx = newContext(1);
+var ref = generateSync(ctx, ctx.set_method(METHOD_LOOKUP), data, range(0, 64), [0, 1]);
+[3, 8].forEach(function(threads) {
+	var ctx = newContext(threads);
+	var info = ctx.set_method(METHOD_LOOKUP);
+	assert.deepEqual(generateSync(ctx, info, data, range(0, 64), [0]), ref.slice(0, 1), threads + ' thread split result');
+	ctx.set_schedule(SCHEDULE_SPLIT);
+	assert.deepEqual(generateSync(ctx, info, data, range(0, 64), [0, 1]), ref, threads + ' thread forced split result');
+});
+
+
+// thread pool: results mustn't depend on the number of threads, including more threads than tasks, and resizing the pool between jobs
+var data = randomInputs(30, 150002);
+var ctx = newContext(1);
+var info = ctx.set_method();
+var ref = generateSync(ctx, info, data, range(0, 30), range(0, 40));
+[2, 3, 4, 7, 16, 3, 1].forEach(function(threads) {
+	ctx.set_max_threads(threads);
+	assert.equal(ctx.get_num_threads(), threads, 'get_num_threads');
+	assert.deepEqual(generateSync(ctx, info, data, range(0, 30), range(0, 40)), ref, threads + ' threads result');
+});
+
+
+var asyncTests = [];
+var runAsyncTests = function() {
+	var test = asyncTests.shift();
+	if(test)
+		test(runAsyncTests);
+	else
+		console.log('All tests passed');
+};
+
+// the pool's threads persist across asynchronous jobs
+asyncTests.push(function(cb) {
+	ctx.set_max_threads(4);
+	var rounds = 0;
+	(function next() {
+		var j = job(ctx, info, data, range(0, 30), range(0, 40));
+		j.generate(function() {
+			assert.deepEqual(j.finish(), ref, 'async result ' + rounds);
+			if(++rounds < 5) next();
+			else cb();
+		});
+	})();
+});
+
+// contexts are independent: jobs can run on several at once, and a busy context only blocks itself
+asyncTests.push(function(cb) {
+	var contexts = [gf, newContext(2), newContext(3)];
+	var pending = contexts.length;
+	contexts.forEach(function(ctx) {
+		var j = job(ctx, ctx.set_method(), data, range(0, 30), range(0, 40));
+		j.generate(function() {
+			assert.deepEqual(j.finish(), ref, 'concurrent context result');
+			if(--pending == 0) cb();
+		});
+		assert.throws(function() {
+			ctx.set_max_threads(1);
+		}, /already in progress/, 'busy context');
+	});
+});
+
+// each worker thread has its own default context
+var Worker;
+try {
+	Worker = require('worker_threads').Worker;
+} catch(x) {}
+// runs in the worker: computes the recovery data and posts it back, or with no data given, starts a large job and reports that it has started
+var workerMain = function() {
+	var wt = require('worker_threads');
+	var gf = require(wt.workerData.module);
+	var ctx = wt.workerData.defaultContext ? gf : new gf.GfContext();
+	var data = wt.workerData.data;
+	if(data) {
+		data = data.map(function(buf) {
+			return Buffer.from(buf.buffer, buf.byteOffset, buf.length);
+		});
+		var j = job(ctx, ctx.set_method(), data, wt.workerData.iNums, wt.workerData.oNums);
+		j.generate(function() {
+			wt.parentPort.postMessage(j.finish());
+		});
+	} else {
+		var data = [];
+		for(var i = 0; i < 32; i++)
+			data.push(Buffer.alloc(1048576, i));
+		job(ctx, ctx.set_method(), data, range(0, 32), range(0, 16)).generate(function() {});
+		wt.parentPort.postMessage('started');
+	}
+};
+var workerCode = [alignedBuffer, range, job].map(function(f) {
+	return 'var ' + f.name + ' = ' + f + ';';
+}).join('\n') + '\n(' + workerMain + ')();';
+var newWorker = function(workerData) {
+	workerData.module = path.resolve(__dirname, '../build/Release/parpar_gf.node');
+	return new Worker(workerCode, {eval: true, workerData: workerData});
+};
+if(Worker) {
+	asyncTests.push(function(cb) {
+		var pending = 2;
+		[true, false].forEach(function(defaultContext) {
+			newWorker({defaultContext: defaultContext, data: data, iNums: range(0, 30), oNums: range(0, 40)}).on('message', function(result) {
+				assert.deepEqual(result, ref, 'worker result');
+				if(--pending == 0) cb();
+			});
+		});
+	});
+	// terminating a worker mid-job must wait for the job before freeing its context
+	asyncTests.push(function(cb) {
+		var runs = 0;
+		(function next() {
+			var worker = newWorker({defaultContext: runs % 2 == 0});
+			worker.on('message', function() {
+				worker.terminate();
+			});
+			worker.on('exit', function() {
+				if(++runs < 4) next();
+				else cb();
+			});
+		})();
+	});
+}
+
+
+runAsyncTests();
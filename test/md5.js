@@ -154,5 +154,178 @@ check(m, [randS2, zeroes.slice(0, 80), randM1, randM2], 'zero-bound-mix');
 check(n, [zeroes.slice(0, 20), randM2], 'zero-bound-mix');
 
 
+// multiple contexts, each with its own input; more contexts than SIMD lanes, mixing lengths and partially filled blocks
+var lens = [0, 1, 20, 63, 64, 65, 128, 129, 200, 1000, 0, 64, 3000, 5, 127, 256, 4096, 70, 0, 333];
+var ctxs = [], inputs = [], expected = [];
+lens.forEach(function(len, i) {
+	var pre = (i % 3 == 1) ? randS1 : (i % 3 == 2 ? randM1.slice(0, 50) : new Buffer(0));
+	ctxs.push(pre.length ? gf.md5_init(pre) : gf.md5_init());
+	inputs.push(crypto.pseudoRandomBytes(len));
+	expected.push([pre, inputs[i]]);
+});
+gf.md5_update_multi(ctxs, inputs);
+// second round, with only some contexts
+gf.md5_update_multi(ctxs.slice(5), inputs.slice(0, 15));
+ctxs.forEach(function(ctx, i) {
+	if(i >= 5) expected[i].push(inputs[i-5]);
+	check(ctx, expected[i], 'multi ' + i);
+});
+assert.throws(function() {
+	var m = gf.md5_init();
+	gf.md5_update_multi([m, m], [randS1, randS2]);
+}, 'multi duplicate contexts');
 
-console.log('All tests passed');
+
+// slice hashing (IFSC entries: MD5 + CRC32 of each zero padded slice)
+var crcTable = [];
+for(var i = 0; i < 256; i++) {
+	var c = i;
+	for(var j = 0; j < 8; j++)
+		c = c & 1 ? (c >>> 1) ^ 0xedb88320 : c >>> 1;
+	crcTable[i] = c;
+}
+var crc32 = function(buf) {
+	var crc = 0xffffffff;
+	for(var i = 0; i < buf.length; i++)
+		crc = (crc >>> 8) ^ crcTable[(crc ^ buf[i]) & 0xff];
+	return (crc ^ 0xffffffff) >>> 0;
+};
+var checkSlices = function(out, offset, data, sliceSize, msg) {
+	for(var pos = 0, i = 0; pos < data.length; pos += sliceSize, i++) {
+		var slice = new Buffer(sliceSize);
+		slice.fill(0);
+		data.copy(slice, 0, pos, Math.min(data.length, pos + sliceSize));
+		var entry = out.slice(offset + i*20, offset + i*20 + 20);
+		assert.equal(entry.slice(0, 16).toString('hex'), crypto.createHash('md5').update(slice).digest('hex'), msg + ' (MD5 of slice ' + i + ')');
+		assert.equal(entry.readUInt32LE(16), crc32(slice), msg + ' (CRC32 of slice ' + i + ')');
+	}
+};
+
+var sliceSize = 40000; // larger than the native hashing chunk size
+var sliceData = crypto.pseudoRandomBytes(sliceSize*2 + 12345);
+var out = new Buffer(100);
+var m = gf.md5_init();
+gf.slice_hash(m, sliceData, sliceSize, out, 30);
+checkSlices(out, 30, sliceData, sliceSize, 'slice hash');
+check(m, sliceData, 'slice hash (file MD5)');
+
+var m = gf.md5_init(randS1);
+gf.slice_hash(m, sliceData.slice(0, 999), sliceSize, out, 0);
+checkSlices(out, 0, sliceData.slice(0, 999), sliceSize, 'slice hash (short)');
+check(m, [randS1, sliceData.slice(0, 999)], 'slice hash (short, file MD5)');
+
+gf.slice_hash(null, sliceData.slice(0, sliceSize), sliceSize, out, 20);
+checkSlices(out, 20, sliceData.slice(0, sliceSize), sliceSize, 'slice hash (no file MD5)');
+
+// slice fed in pieces
+var m = gf.md5_init();
+var sh = gf.slice_hash_init();
+gf.slice_hash_update(m, sh, sliceData.slice(0, 100));
+gf.slice_hash_update(m, sh, sliceData.slice(100, 100));
+gf.slice_hash_update(m, sh, sliceData.slice(100, 30000));
+gf.slice_hash_final(sh, sliceSize, out, 0);
+checkSlices(out, 0, sliceData.slice(0, 30000), sliceSize, 'slice hash (pieces)');
+check(m, sliceData.slice(0, 30000), 'slice hash (pieces, file MD5)');
+
+// several files at once
+var multiFiles = [
+	{md5: gf.md5_init(), data: sliceData},
+	{md5: null, data: sliceData.slice(5, 5 + sliceSize*2)},
+	{md5: gf.md5_init(randS2), data: sliceData.slice(7, 3007)},
+	{md5: gf.md5_init(), data: new Buffer(0)},
+	{md5: null, data: sliceData.slice(1, 2)}
+];
+var sliceHashMulti = function(cb) {
+	var outs = multiFiles.map(function(f) {
+		return new Buffer(10 + 20*Math.ceil(f.data.length / sliceSize));
+	});
+	var md5s = multiFiles.map(function(f) {
+		return f.md5;
+	});
+	var datas = multiFiles.map(function(f) {
+		return f.data;
+	});
+	var offsets = multiFiles.map(function() {
+		return 10;
+	});
+	var verify = function(msg) {
+		multiFiles.forEach(function(f, i) {
+			checkSlices(outs[i], 10, f.data, sliceSize, msg + ' ' + i);
+			if(f.md5)
+				check(f.md5, i == 2 ? [randS2, f.data] : f.data, msg + ' ' + i + ' (file MD5)');
+			f.md5 = f.md5 && (i == 2 ? gf.md5_init(randS2) : gf.md5_init());
+		});
+	};
+	if(cb) {
+		gf.slice_hash_multi(md5s, datas, sliceSize, outs, offsets, function() {
+			verify('slice hash multi (async)');
+			cb();
+		});
+	} else {
+		gf.slice_hash_multi(md5s, datas, sliceSize, outs, offsets);
+		verify('slice hash multi');
+	}
+};
+sliceHashMulti();
+
+
+// async tests
+var asyncTests = [
+	sliceHashMulti,
+	function(cb) {
+		var m = gf.md5_init();
+		var sh = gf.slice_hash_init();
+		gf.slice_hash_update(m, sh, sliceData.slice(0, 25000), function() {
+			gf.slice_hash_final(sh, sliceSize, out, 0);
+			checkSlices(out, 0, sliceData.slice(0, 25000), sliceSize, 'slice hash update (async)');
+			check(m, sliceData.slice(0, 25000), 'slice hash update (async, file MD5)');
+			cb();
+		});
+	},
+	function(cb) {
+		// finish with MD5: compare against a finish without MD5, and the MD5 of its result
+		var size = 70000;
+		var info = gf.set_method(0, size);
+		var alignedLen = Math.ceil(size / info.stride) * info.stride;
+		var alignedBuffer = function() {
+			var buf = new Buffer(alignedLen + info.alignment);
+			var offset = gf.alignment_offset(buf);
+			if(offset) offset = info.alignment - offset;
+			return buf.slice(offset, offset + alignedLen);
+		};
+		var inputs = [alignedBuffer(), alignedBuffer()];
+		inputs.forEach(function(buf) {
+			gf.copy(crypto.pseudoRandomBytes(alignedLen), buf);
+		});
+		var outputs = [], refOutputs = [], md5s = [], recNums = [];
+		for(var i = 0; i < 19; i++) {
+			outputs.push(alignedBuffer());
+			recNums.push(i);
+		}
+		gf.generate(inputs, [0, 1], outputs, recNums, false);
+		outputs.forEach(function(buf) {
+			var ref = alignedBuffer();
+			buf.copy(ref);
+			refOutputs.push(ref);
+			md5s.push(gf.md5_init());
+		});
+		gf.finish(refOutputs, size);
+		gf.finish(outputs, size, md5s, function() {
+			outputs.forEach(function(buf, i) {
+				assert.equal(buf.toString('hex'), refOutputs[i].toString('hex'), 'finish (async) ' + i);
+				check(md5s[i], buf.slice(0, size), 'finish (async, MD5) ' + i);
+			});
+			cb();
+		});
+		assert.throws(function() {
+			gf.finish(refOutputs, size);
+		}, 'finish (async) in progress');
+	}
+];
+(function next(i) {
+	if(i >= asyncTests.length)
+		return console.log('All tests passed');
+	asyncTests[i](function() {
+		next(i+1);
+	});
+})(0);